@@ -55,6 +55,8 @@ uint8_t ch9120_basic_init(void)
     DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
     DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
     DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
     DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
     DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
     DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
@@ -64,6 +66,16 @@ uint8_t ch9120_basic_init(void)
     DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
     DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
     DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_STORAGE_READ(&gs_handle, ch9120_interface_storage_read);
+    DRIVER_CH9120_LINK_STORAGE_WRITE(&gs_handle, ch9120_interface_storage_write);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+    DRIVER_CH9120_LINK_MUTEX_INIT(&gs_handle, ch9120_interface_mutex_init);
+    DRIVER_CH9120_LINK_MUTEX_DEINIT(&gs_handle, ch9120_interface_mutex_deinit);
+    DRIVER_CH9120_LINK_MUTEX_LOCK(&gs_handle, ch9120_interface_mutex_lock);
+    DRIVER_CH9120_LINK_MUTEX_UNLOCK(&gs_handle, ch9120_interface_mutex_unlock);
     
     /* ch9120 init */
     res = ch9120_init(&gs_handle);
@@ -99,6 +111,7 @@ uint8_t ch9120_basic_config(ch9120_mode_t mode,
     uint8_t res;
     uint8_t reg;
     
+#if (CH9120_ENABLE_DHCP == 1)
     /* set default dhcp */
     res = ch9120_set_dhcp(&gs_handle, CH9120_BASIC_DEFAULT_DHCP);
     if (res != 0)
@@ -107,6 +120,7 @@ uint8_t ch9120_basic_config(ch9120_mode_t mode,
         
         return 1;
     }
+#endif
     
     /* set local ip */
     res = ch9120_set_ip(&gs_handle, ip);
@@ -244,20 +258,54 @@ uint8_t ch9120_basic_config(ch9120_mode_t mode,
         return 1;
     }
     
-    /* save to eeprom */
-    res = ch9120_save_to_eeprom(&gs_handle);
+    /* save and reset only if anything changed */
+    res = ch9120_apply(&gs_handle, CH9120_APPLY_AUTO);
     if (res != 0)
     {
-        ch9120_interface_debug_print("ch9120: save to eeprom failed.\n");
+        ch9120_interface_debug_print("ch9120: apply failed.\n");
         
         return 1;
     }
     
-    /* config and reset */
-    res = ch9120_config_and_reset(&gs_handle);
+    return 0;
+}
+
+/**
+ * @brief     basic example set dest
+ * @param[in] *dest_ip pointer to a dest ip buffer
+ * @param[in] dest_port dest port
+ * @return    status code
+ *            - 0 success
+ *            - 1 set dest failed
+ * @note      the chip only runs the new dest after a config and reset, so the link is reset
+ */
+uint8_t ch9120_basic_set_dest(uint8_t dest_ip[4], uint16_t dest_port)
+{
+    uint8_t res;
+    
+    /* set dest ip */
+    res = ch9120_set_dest_ip(&gs_handle, dest_ip);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest ip failed.\n");
+        
+        return 1;
+    }
+    
+    /* set dest port */
+    res = ch9120_set_dest_port(&gs_handle, dest_port);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        
+        return 1;
+    }
+    
+    /* run the new dest */
+    res = ch9120_apply(&gs_handle, CH9120_APPLY_PERSIST_AND_RESET);
     if (res != 0)
     {
-        ch9120_interface_debug_print("ch9120: config and reset failed.\n");
+        ch9120_interface_debug_print("ch9120: apply failed.\n");
         
         return 1;
     }
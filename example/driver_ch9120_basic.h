@@ -124,6 +124,17 @@ uint8_t ch9120_basic_config(ch9120_mode_t mode,
                             uint8_t mask[4], uint8_t gateway[4],
                             uint8_t dest_ip[4], uint16_t dest_port);
 
+/**
+ * @brief     basic example set dest
+ * @param[in] *dest_ip pointer to a dest ip buffer
+ * @param[in] dest_port dest port
+ * @return    status code
+ *            - 0 success
+ *            - 1 set dest failed
+ * @note      the chip only runs the new dest after a config and reset, so the link is reset
+ */
+uint8_t ch9120_basic_set_dest(uint8_t dest_ip[4], uint16_t dest_port);
+
 /**
  * @}
  */
@@ -0,0 +1,420 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_client.c
+ * @brief     driver ch9120 client source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_client.h"
+
+static ch9120_handle_t gs_handle;                                /**< ch9120 handle */
+static ch9120_client_dest_t gs_dest[CH9120_CLIENT_MAX_DEST];     /**< dest list */
+static uint8_t gs_dest_num;                                      /**< dest number */
+static uint8_t gs_retry;                                         /**< reconnects of the current dest */
+static uint32_t gs_backoff_ms;                                   /**< next reconnect delay */
+static uint64_t gs_reconnect_us;                                 /**< next reconnect time */
+static uint8_t gs_buffer[CH9120_CLIENT_BUFFER_SIZE];             /**< outage buffer */
+static uint32_t gs_head;                                         /**< buffer read point */
+static ch9120_client_stats_t gs_stats;                           /**< client stats */
+
+/**
+ * @brief     session change callback
+ * @param[in] type session status
+ * @note      none
+ */
+static void a_ch9120_client_callback(uint8_t type)
+{
+    uint64_t now;
+    
+    if (type == CH9120_STATUS_CONNECT)
+    {
+        gs_stats.connected = 1;
+        gs_retry = 0;
+        gs_backoff_ms = CH9120_CLIENT_BACKOFF_MIN_MS;
+    }
+    else
+    {
+        /* a new drop gives the chip's own reconnect a chance first */
+        gs_stats.connected = 0;
+        now = ch9120_interface_timestamp_us();
+        if (gs_reconnect_us <= now)
+        {
+            gs_reconnect_us = now + (uint64_t)gs_backoff_ms * 1000;
+        }
+    }
+}
+
+/**
+ * @brief  reconnect the session
+ * @return status code
+ *         - 0 success
+ *         - 1 reconnect failed
+ * @note   none
+ */
+static uint8_t a_ch9120_client_reconnect(void)
+{
+    uint8_t res;
+    ch9120_client_dest_t *dest;
+    
+    /* move to the next dest after CH9120_CLIENT_RETRY attempts */
+    if ((gs_retry >= CH9120_CLIENT_RETRY) && (gs_dest_num > 1))
+    {
+        gs_stats.dest = (uint8_t)((gs_stats.dest + 1) % gs_dest_num);
+        gs_stats.failovers++;
+        gs_retry = 0;
+        gs_backoff_ms = CH9120_CLIENT_BACKOFF_MIN_MS;
+        dest = &gs_dest[gs_stats.dest];
+        
+        /* set dest ip */
+        res = ch9120_set_dest_ip(&gs_handle, dest->ip);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: set dest ip failed.\n");
+            
+            return 1;
+        }
+        
+        /* set dest port */
+        res = ch9120_set_dest_port(&gs_handle, dest->port);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+            
+            return 1;
+        }
+    }
+    
+    /* restart the session, the new dest only runs after the config and reset */
+    gs_retry++;
+    gs_stats.reconnects++;
+    res = ch9120_config_and_reset(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: config and reset failed.\n");
+        
+        return 1;
+    }
+    
+    /* poll the new session fast and double the delay */
+    (void)ch9120_set_monitor(&gs_handle, CH9120_BOOL_TRUE);
+    gs_stats.connected = 0;
+    gs_reconnect_us = ch9120_interface_timestamp_us() + (uint64_t)gs_backoff_ms * 1000;
+    gs_backoff_ms *= 2;
+    if (gs_backoff_ms > CH9120_CLIENT_BACKOFF_MAX_MS)
+    {
+        gs_backoff_ms = CH9120_CLIENT_BACKOFF_MAX_MS;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  flush the buffer
+ * @return status code
+ *         - 0 success
+ *         - 1 flush failed
+ * @note   at most CH9120_CLIENT_FLUSH_SIZE bytes are sent per call
+ */
+static uint8_t a_ch9120_client_flush(void)
+{
+    uint32_t l;
+    
+    l = gs_stats.buffered;
+    if (l > CH9120_CLIENT_FLUSH_SIZE)
+    {
+        l = CH9120_CLIENT_FLUSH_SIZE;
+    }
+    if (l > CH9120_CLIENT_BUFFER_SIZE - gs_head)
+    {
+        l = CH9120_CLIENT_BUFFER_SIZE - gs_head;
+    }
+    if (l == 0)
+    {
+        return 0;
+    }
+    if (ch9120_write(&gs_handle, &gs_buffer[gs_head], (uint16_t)l) != 0)
+    {
+        return 1;
+    }
+    gs_head = (gs_head + l) % CH9120_CLIENT_BUFFER_SIZE;
+    gs_stats.buffered -= l;
+    
+    return 0;
+}
+
+/**
+ * @brief     client example init
+ * @param[in] *dest pointer to a dest list, the first one is the primary
+ * @param[in] num dest number
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      the chip is switched to the tcp client mode
+ */
+uint8_t ch9120_client_init(const ch9120_client_dest_t *dest, uint8_t num)
+{
+    uint8_t res;
+    
+    /* check the dest list */
+    if ((dest == NULL) || (num == 0) || (num > CH9120_CLIENT_MAX_DEST))
+    {
+        ch9120_interface_debug_print("ch9120: dest list is invalid.\n");
+        
+        return 1;
+    }
+    memcpy(gs_dest, dest, sizeof(ch9120_client_dest_t) * num);
+    gs_dest_num = num;
+    gs_retry = 0;
+    gs_backoff_ms = CH9120_CLIENT_BACKOFF_MIN_MS;
+    gs_head = 0;
+    memset(&gs_stats, 0, sizeof(ch9120_client_stats_t));
+    
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_STORAGE_READ(&gs_handle, ch9120_interface_storage_read);
+    DRIVER_CH9120_LINK_STORAGE_WRITE(&gs_handle, ch9120_interface_storage_write);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+    DRIVER_CH9120_LINK_MUTEX_INIT(&gs_handle, ch9120_interface_mutex_init);
+    DRIVER_CH9120_LINK_MUTEX_DEINIT(&gs_handle, ch9120_interface_mutex_deinit);
+    DRIVER_CH9120_LINK_MUTEX_LOCK(&gs_handle, ch9120_interface_mutex_lock);
+    DRIVER_CH9120_LINK_MUTEX_UNLOCK(&gs_handle, ch9120_interface_mutex_unlock);
+    DRIVER_CH9120_LINK_RECEIVE_CALLBACK(&gs_handle, a_ch9120_client_callback);
+    
+    /* ch9120 init */
+    res = ch9120_init(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* set tcp client mode */
+    res = ch9120_set_mode(&gs_handle, CH9120_MODE_TCP_CLIENT);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set mode failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set dest ip */
+    res = ch9120_set_dest_ip(&gs_handle, gs_dest[0].ip);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest ip failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* set dest port */
+    res = ch9120_set_dest_port(&gs_handle, gs_dest[0].port);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* save and reset only if anything changed */
+    res = ch9120_apply(&gs_handle, CH9120_APPLY_AUTO);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: apply failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* watch the session */
+    gs_reconnect_us = ch9120_interface_timestamp_us() + (uint64_t)gs_backoff_ms * 1000;
+    res = ch9120_set_monitor(&gs_handle, CH9120_BOOL_TRUE);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set monitor failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  client example handler
+ * @return status code
+ *         - 0 success
+ *         - 1 handler failed
+ * @note   call it from the main loop, it watches the session, reconnects with an exponential
+ *         backoff, fails over to the next dest and flushes the buffer once connected
+ */
+uint8_t ch9120_client_handler(void)
+{
+    uint8_t res;
+    
+    /* a failed poll is retried by the monitor */
+    res = ch9120_monitor_handler(&gs_handle);
+    if ((res != 0) && (res != 1))
+    {
+        return 1;
+    }
+    
+    /* deliver the backlog */
+    if (gs_stats.connected != 0)
+    {
+        return a_ch9120_client_flush();
+    }
+    
+    /* reconnect when the backoff is over */
+    if (ch9120_interface_timestamp_us() >= gs_reconnect_us)
+    {
+        return a_ch9120_client_reconnect();
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     client example write data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed or the buffer is full
+ * @note      data is buffered while the session is down, bytes sent before
+ *            the monitor has seen a drop are lost
+ */
+uint8_t ch9120_client_write(uint8_t *buf, uint16_t len)
+{
+    uint32_t i;
+    uint32_t tail;
+    
+    /* send directly while nothing is waiting */
+    if ((gs_stats.connected != 0) && (gs_stats.buffered == 0))
+    {
+        if (ch9120_write(&gs_handle, buf, len) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    
+    /* keep whole writes only, so the buffer never holds a cut record */
+    if (len > CH9120_CLIENT_BUFFER_SIZE - gs_stats.buffered)
+    {
+        gs_stats.dropped += len;
+        
+        return 1;
+    }
+    tail = (gs_head + gs_stats.buffered) % CH9120_CLIENT_BUFFER_SIZE;
+    for (i = 0; i < len; i++)
+    {
+        gs_buffer[tail] = buf[i];
+        tail = (tail + 1) % CH9120_CLIENT_BUFFER_SIZE;
+    }
+    gs_stats.buffered += len;
+    
+    return 0;
+}
+
+/**
+ * @brief         client example read data
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ * @note          none
+ */
+uint8_t ch9120_client_read(uint8_t *buf, uint16_t *len)
+{
+    if (ch9120_read(&gs_handle, buf, len) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      client example get the stats
+ * @param[out] *stats pointer to a stats structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t ch9120_client_get_stats(ch9120_client_stats_t *stats)
+{
+    memcpy(stats, &gs_stats, sizeof(ch9120_client_stats_t));
+    
+    return 0;
+}
+
+/**
+ * @brief  client example deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t ch9120_client_deinit(void)
+{
+    /* deinit ch9120 */
+    if (ch9120_deinit(&gs_handle) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
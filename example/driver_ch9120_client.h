@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_client.h
+ * @brief     driver ch9120 client header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_CH9120_CLIENT_H
+#define DRIVER_CH9120_CLIENT_H
+
+#include "driver_ch9120_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup ch9120_example_driver
+ * @{
+ */
+
+/**
+ * @brief ch9120 client example default definition
+ */
+#define CH9120_CLIENT_MAX_DEST              4            /**< 4 dest endpoints */
+#define CH9120_CLIENT_BUFFER_SIZE           4096         /**< 4096 bytes outage buffer */
+#define CH9120_CLIENT_FLUSH_SIZE            128          /**< 128 bytes flushed per handler call */
+#define CH9120_CLIENT_BACKOFF_MIN_MS        1000         /**< 1000ms first reconnect delay */
+#define CH9120_CLIENT_BACKOFF_MAX_MS        32000        /**< 32000ms max reconnect delay */
+#define CH9120_CLIENT_RETRY                 3            /**< 3 reconnects before a failover */
+
+/**
+ * @brief ch9120 client dest structure definition
+ */
+typedef struct ch9120_client_dest_s
+{
+    uint8_t ip[4];        /**< dest ip */
+    uint16_t port;        /**< dest port */
+} ch9120_client_dest_t;
+
+/**
+ * @brief ch9120 client stats structure definition
+ */
+typedef struct ch9120_client_stats_s
+{
+    uint8_t connected;          /**< 1 if the session is connected */
+    uint8_t dest;               /**< current dest index */
+    uint32_t reconnects;        /**< reconnect attempts */
+    uint32_t failovers;         /**< dest switches */
+    uint32_t buffered;          /**< bytes waiting in the buffer */
+    uint32_t dropped;           /**< bytes dropped by a full buffer */
+} ch9120_client_stats_t;
+
+/**
+ * @brief     client example init
+ * @param[in] *dest pointer to a dest list, the first one is the primary
+ * @param[in] num dest number
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      the chip is switched to the tcp client mode
+ */
+uint8_t ch9120_client_init(const ch9120_client_dest_t *dest, uint8_t num);
+
+/**
+ * @brief  client example deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t ch9120_client_deinit(void);
+
+/**
+ * @brief  client example handler
+ * @return status code
+ *         - 0 success
+ *         - 1 handler failed
+ * @note   call it from the main loop, it watches the session, reconnects with an exponential
+ *         backoff, fails over to the next dest and flushes the buffer once connected
+ */
+uint8_t ch9120_client_handler(void);
+
+/**
+ * @brief     client example write data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed or the buffer is full
+ * @note      data is buffered while the session is down, bytes sent before
+ *            the monitor has seen a drop are lost
+ */
+uint8_t ch9120_client_write(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief         client example read data
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ * @note          none
+ */
+uint8_t ch9120_client_read(uint8_t *buf, uint16_t *len);
+
+/**
+ * @brief      client example get the stats
+ * @param[out] *stats pointer to a stats structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t ch9120_client_get_stats(ch9120_client_stats_t *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
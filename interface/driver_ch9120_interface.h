@@ -99,6 +99,26 @@ uint8_t ch9120_interface_uart_flush(void);
  */
 uint8_t ch9120_interface_uart_write(uint8_t *buf, uint16_t len);
 
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       none
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view);
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len);
+
 /**
  * @brief  interface reset gpio init
  * @return status code
@@ -169,6 +189,95 @@ void ch9120_interface_delay_ms(uint32_t ms);
  */
 void ch9120_interface_debug_print(const char *const fmt, ...);
 
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t ch9120_interface_timestamp_us(void);
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace);
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace);
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      crc-32/iso-hdlc, reflected poly 0xEDB88320, init and xorout 0xFFFFFFFF
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       creates the cfg and io locks of one handle
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx);
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      none
+ */
+void ch9120_interface_mutex_deinit(void *ctx);
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      none
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait);
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      none
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id);
+
 /**
  * @}
  */
@@ -100,6 +100,32 @@ uint8_t ch9120_interface_uart_write(uint8_t *buf, uint16_t len)
     return 0;
 }
 
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       none
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len)
+{
+    return 1;
+}
+
 /**
  * @brief  interface reset gpio init
  * @return status code
@@ -193,3 +219,136 @@ void ch9120_interface_debug_print(const char *const fmt, ...)
 {
     
 }
+
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t ch9120_interface_timestamp_us(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      crc-32/iso-hdlc, reflected poly 0xEDB88320, init and xorout 0xFFFFFFFF
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len)
+{
+    uint8_t i;
+    uint32_t crc;
+    
+    crc = 0xFFFFFFFFU;
+    while (len != 0)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+        len--;
+    }
+    
+    return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       creates the cfg and io locks of one handle
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      none
+ */
+void ch9120_interface_mutex_deinit(void *ctx)
+{
+    
+}
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      none
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      none
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id)
+{
+    
+}
@@ -0,0 +1,361 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      fuzz_driver_ch9120_interface.c
+ * @brief     fuzz driver ch9120 interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_interface.h"
+#include "stream.h"
+
+/**
+ * @brief  interface uart init
+ * @return status code
+ *         - 0 success
+ *         - 1 uart init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface uart deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 uart deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief      interface uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint16_t ch9120_interface_uart_read(uint8_t *buf, uint16_t len)
+{
+    return stream_read(buf, len);
+}
+
+/**
+ * @brief  interface uart flush
+ * @return status code
+ *         - 0 success
+ *         - 1 uart flush failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_flush(void)
+{
+    stream_record_clear();
+    
+    return 0;
+}
+
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       none
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_write(uint8_t *buf, uint16_t len)
+{
+    stream_write(buf, len);
+    
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface reset gpio write
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_reset_gpio_write(uint8_t data)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface cfg gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 cfg gpio init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_cfg_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface cfg gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 cfg gpio deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_cfg_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface cfg gpio write
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_cfg_gpio_write(uint8_t data)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface delay ms
+ * @param[in] ms time
+ * @note      none
+ */
+void ch9120_interface_delay_ms(uint32_t ms)
+{
+
+}
+
+/**
+ * @brief     interface print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void ch9120_interface_debug_print(const char *const fmt, ...)
+{
+    
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t ch9120_interface_timestamp_us(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      bitwise
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len)
+{
+    uint8_t i;
+    uint32_t crc;
+    
+    crc = 0xFFFFFFFFU;
+    while (len != 0)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+        len--;
+    }
+    
+    return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       single threaded
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx)
+{
+    *ctx = NULL;
+    
+    return 0;
+}
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      single threaded
+ */
+void ch9120_interface_mutex_deinit(void *ctx)
+{
+    
+}
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      single threaded
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      single threaded
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id)
+{
+    
+}
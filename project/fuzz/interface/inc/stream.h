@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      stream.h
+ * @brief     stream header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup stream stream function
+ * @brief    stream function modules
+ * @{
+ */
+
+/**
+ * @brief stream record length definition
+ */
+#define STREAM_RECORD_LEN    512        /**< 512 bytes */
+
+/**
+ * @brief     stream init
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @note      the buffer must be valid until the next stream init
+ */
+void stream_init(const uint8_t *data, size_t len);
+
+/**
+ * @brief  stream get the remaining length
+ * @return remaining length
+ * @note   none
+ */
+size_t stream_remain(void);
+
+/**
+ * @brief      stream get one byte
+ * @param[out] *byte pointer to a byte buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 stream is empty
+ * @note       none
+ */
+uint8_t stream_get(uint8_t *byte);
+
+/**
+ * @brief      stream read like an uart
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       one control byte is used as the chunk length, so short and empty reads are covered
+ */
+uint16_t stream_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief stream clear the record
+ * @note  called when the uart is flushed, the written frame is cleared too
+ */
+void stream_record_clear(void);
+
+/**
+ * @brief      stream get the record
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes read since the last record clear
+ * @note       none
+ */
+const uint8_t *stream_record(uint16_t *len);
+
+/**
+ * @brief     stream save the written data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @note      the writes since the last record clear are joined into one frame
+ */
+void stream_write(const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      stream get the written frame
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes written since the last record clear
+ * @note       none
+ */
+const uint8_t *stream_written(uint16_t *len);
+
+/**
+ * @brief stream mark the next command
+ * @note  the record and the written frame of the first command after the mark are kept
+ */
+void stream_mark(void);
+
+/**
+ * @brief      stream get the marked record
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes read by the first command after the mark
+ * @note       none
+ */
+const uint8_t *stream_marked_record(uint16_t *len);
+
+/**
+ * @brief      stream get the marked written frame
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes written by the first command after the mark
+ * @note       none
+ */
+const uint8_t *stream_marked_written(uint16_t *len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
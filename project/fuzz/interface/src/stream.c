@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      stream.c
+ * @brief     stream source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "stream.h"
+#include <string.h>
+
+static const uint8_t *gs_data;                      /**< input data */
+static size_t gs_len;                               /**< input length */
+static size_t gs_pos;                               /**< input position */
+static uint8_t gs_record[STREAM_RECORD_LEN];        /**< read record */
+static uint16_t gs_record_len;                      /**< read record length */
+static uint8_t gs_written[STREAM_RECORD_LEN];       /**< written frame */
+static uint16_t gs_written_len;                     /**< written frame length */
+static uint8_t gs_mark;                             /**< mark state */
+static uint8_t gs_mark_record[STREAM_RECORD_LEN];   /**< marked record */
+static uint16_t gs_mark_record_len;                 /**< marked record length */
+static uint8_t gs_mark_written[STREAM_RECORD_LEN];  /**< marked written frame */
+static uint16_t gs_mark_written_len;                /**< marked written frame length */
+
+/**
+ * @brief     stream init
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @note      the buffer must be valid until the next stream init
+ */
+void stream_init(const uint8_t *data, size_t len)
+{
+    gs_data = data;
+    gs_len = len;
+    gs_pos = 0;
+    gs_record_len = 0;
+    gs_written_len = 0;
+    gs_mark = 0;
+}
+
+/**
+ * @brief  stream get the remaining length
+ * @return remaining length
+ * @note   none
+ */
+size_t stream_remain(void)
+{
+    return gs_len - gs_pos;
+}
+
+/**
+ * @brief      stream get one byte
+ * @param[out] *byte pointer to a byte buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 stream is empty
+ * @note       none
+ */
+uint8_t stream_get(uint8_t *byte)
+{
+    if (gs_pos >= gs_len)
+    {
+        return 1;
+    }
+    *byte = gs_data[gs_pos];
+    gs_pos++;
+    
+    return 0;
+}
+
+/**
+ * @brief      stream read like an uart
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       one control byte is used as the chunk length, so short and empty reads are covered
+ */
+uint16_t stream_read(uint8_t *buf, uint16_t len)
+{
+    uint8_t chunk;
+    uint16_t l;
+    uint16_t r;
+    
+    /* get the chunk length */
+    if (stream_get(&chunk) != 0)
+    {
+        return 0;
+    }
+    
+    /* limit the length */
+    l = chunk;
+    if (l > len)
+    {
+        l = len;
+    }
+    if (l > gs_len - gs_pos)
+    {
+        l = (uint16_t)(gs_len - gs_pos);
+    }
+    memcpy(buf, &gs_data[gs_pos], l);
+    gs_pos += l;
+    
+    /* record the data */
+    r = l;
+    if (r > STREAM_RECORD_LEN - gs_record_len)
+    {
+        r = STREAM_RECORD_LEN - gs_record_len;
+    }
+    memcpy(&gs_record[gs_record_len], buf, r);
+    gs_record_len += r;
+    
+    return l;
+}
+
+/**
+ * @brief stream clear the record
+ * @note  called when the uart is flushed, the written frame is cleared too
+ */
+void stream_record_clear(void)
+{
+    if (gs_mark == 1)
+    {
+        /* the marked command starts */
+        gs_mark = 2;
+    }
+    else if (gs_mark == 2)
+    {
+        /* the marked command is over */
+        memcpy(gs_mark_record, gs_record, gs_record_len);
+        gs_mark_record_len = gs_record_len;
+        memcpy(gs_mark_written, gs_written, gs_written_len);
+        gs_mark_written_len = gs_written_len;
+        gs_mark = 3;
+    }
+    else
+    {
+        
+    }
+    gs_record_len = 0;
+    gs_written_len = 0;
+}
+
+/**
+ * @brief      stream get the record
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes read since the last record clear
+ * @note       none
+ */
+const uint8_t *stream_record(uint16_t *len)
+{
+    *len = gs_record_len;
+    
+    return gs_record;
+}
+
+/**
+ * @brief     stream save the written data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @note      the writes since the last record clear are joined into one frame
+ */
+void stream_write(const uint8_t *buf, uint16_t len)
+{
+    if (len > STREAM_RECORD_LEN - gs_written_len)
+    {
+        len = STREAM_RECORD_LEN - gs_written_len;
+    }
+    memcpy(&gs_written[gs_written_len], buf, len);
+    gs_written_len += len;
+}
+
+/**
+ * @brief      stream get the written frame
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes written since the last record clear
+ * @note       none
+ */
+const uint8_t *stream_written(uint16_t *len)
+{
+    *len = gs_written_len;
+    
+    return gs_written;
+}
+
+/**
+ * @brief stream mark the next command
+ * @note  the record and the written frame of the first command after the mark are kept
+ */
+void stream_mark(void)
+{
+    gs_mark = 1;
+    gs_mark_record_len = 0;
+    gs_mark_written_len = 0;
+}
+
+/**
+ * @brief      stream get the marked record
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes read by the first command after the mark
+ * @note       none
+ */
+const uint8_t *stream_marked_record(uint16_t *len)
+{
+    if (gs_mark == 2)
+    {
+        /* the marked command is the last one */
+        return stream_record(len);
+    }
+    *len = gs_mark_record_len;
+    
+    return gs_mark_record;
+}
+
+/**
+ * @brief      stream get the marked written frame
+ * @param[out] *len pointer to a length buffer
+ * @return     pointer to the bytes written by the first command after the mark
+ * @note       none
+ */
+const uint8_t *stream_marked_written(uint16_t *len)
+{
+    if (gs_mark == 2)
+    {
+        /* the marked command is the last one */
+        return stream_written(len);
+    }
+    *len = gs_mark_written_len;
+    
+    return gs_mark_written;
+}
@@ -0,0 +1,514 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      main.c
+ * @brief     main source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_interface.h"
+#include "stream.h"
+#include <stdlib.h>
+
+/**
+ * @brief fuzz check definition
+ */
+#define FUZZ_CHECK(x)    do { if (!(x)) { abort(); } } while (0)
+
+/**
+ * @brief fuzz command definition
+ */
+#define FUZZ_CMD_NUM     19        /**< number of fuzzed functions */
+
+static ch9120_handle_t gs_handle;        /**< ch9120 handle */
+static uint8_t gs_frame[64];             /**< frame decode buffer */
+
+/**
+ * @brief     fuzz check the written command frame
+ * @param[in] *param pointer to the param buffer
+ * @param[in] len param length
+ * @note      none
+ */
+static void a_fuzz_check_frame(const uint8_t *param, uint16_t len)
+{
+    uint16_t l;
+    const uint8_t *frame;
+    
+    frame = stream_written(&l);
+    FUZZ_CHECK(l == 2 + len);
+    FUZZ_CHECK((frame[0] == 0x57) && (frame[1] == 0xAB));
+    FUZZ_CHECK(memcmp(&frame[2], param, len) == 0);
+}
+
+/**
+ * @brief      fuzz get the response
+ * @param[in]  out_len response length
+ * @return     pointer to the response
+ * @note       the response is the data read since the command flushed the uart
+ */
+static const uint8_t *a_fuzz_response(uint16_t out_len)
+{
+    uint16_t l;
+    const uint8_t *r;
+    
+    r = stream_record(&l);
+    FUZZ_CHECK(l >= out_len);
+    
+    return r;
+}
+
+/**
+ * @brief     fuzz run a getter
+ * @param[in] index getter index
+ * @note      a successful getter must decode exactly the bytes the chip sent
+ */
+static void a_fuzz_get(uint8_t index)
+{
+    uint8_t res;
+    uint8_t version;
+    uint8_t ip[4];
+    uint8_t data_bit;
+    uint8_t stop_bit;
+    uint16_t num;
+    uint32_t value;
+    const uint8_t *r;
+    ch9120_status_t status;
+    ch9120_mode_t mode;
+    ch9120_parity_t parity;
+    ch9120_bool_t enable;
+    
+    switch (index)
+    {
+        case 0 :
+        {
+            res = ch9120_get_version(&gs_handle, &version);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(version == r[0]);
+            }
+            
+            break;
+        }
+        case 1 :
+        {
+            res = ch9120_get_status(&gs_handle, &status);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(status == (ch9120_status_t)r[0]);
+            }
+            
+            break;
+        }
+        case 2 :
+        {
+            res = ch9120_get_mode(&gs_handle, &mode);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(mode == (ch9120_mode_t)r[0]);
+            }
+            
+            break;
+        }
+        case 3 :
+        {
+            res = ch9120_get_ip(&gs_handle, ip);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(memcmp(ip, r, 4) == 0);
+            }
+            
+            break;
+        }
+        case 4 :
+        {
+            res = ch9120_get_subnet_mask(&gs_handle, ip);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(memcmp(ip, r, 4) == 0);
+            }
+            
+            break;
+        }
+        case 5 :
+        {
+            res = ch9120_get_gateway(&gs_handle, ip);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(memcmp(ip, r, 4) == 0);
+            }
+            
+            break;
+        }
+        case 6 :
+        {
+            res = ch9120_get_dest_ip(&gs_handle, ip);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(memcmp(ip, r, 4) == 0);
+            }
+            
+            break;
+        }
+        case 7 :
+        {
+            res = ch9120_get_source_port(&gs_handle, &num);
+            if (res == 0)
+            {
+                r = a_fuzz_response(2);
+                FUZZ_CHECK(num == (uint16_t)(r[0] | (r[1] << 8)));
+            }
+            
+            break;
+        }
+        case 8 :
+        {
+            res = ch9120_get_dest_port(&gs_handle, &num);
+            if (res == 0)
+            {
+                r = a_fuzz_response(2);
+                FUZZ_CHECK(num == (uint16_t)(r[0] | (r[1] << 8)));
+            }
+            
+            break;
+        }
+        case 9 :
+        {
+            res = ch9120_get_uart_baud(&gs_handle, &value);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(value == ((uint32_t)r[0] | ((uint32_t)r[1] << 8) |
+                                     ((uint32_t)r[2] << 16) | ((uint32_t)r[3] << 24)));
+            }
+            
+            break;
+        }
+        case 10 :
+        {
+            res = ch9120_get_uart_buffer_length(&gs_handle, &value);
+            if (res == 0)
+            {
+                r = a_fuzz_response(4);
+                FUZZ_CHECK(value == ((uint32_t)r[0] | ((uint32_t)r[1] << 8) |
+                                     ((uint32_t)r[2] << 16) | ((uint32_t)r[3] << 24)));
+            }
+            
+            break;
+        }
+        case 11 :
+        {
+            res = ch9120_get_uart_config(&gs_handle, &data_bit, &parity, &stop_bit);
+            if (res == 0)
+            {
+                r = a_fuzz_response(3);
+                FUZZ_CHECK((stop_bit == r[0]) && (parity == (ch9120_parity_t)r[1]) && (data_bit == r[2]));
+            }
+            
+            break;
+        }
+        case 12 :
+        {
+            res = ch9120_get_uart_timeout(&gs_handle, &version);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(version == r[0]);
+            }
+            
+            break;
+        }
+        case 13 :
+        {
+            res = ch9120_get_uart_flush(&gs_handle, &enable);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(enable == (ch9120_bool_t)r[0]);
+            }
+            
+            break;
+        }
+        default :
+        {
+            res = ch9120_get_disconnect_with_no_rj45(&gs_handle, &enable);
+            if (res == 0)
+            {
+                r = a_fuzz_response(1);
+                FUZZ_CHECK(enable == (ch9120_bool_t)r[0]);
+            }
+            
+            break;
+        }
+    }
+    FUZZ_CHECK(res <= 1);
+}
+
+/**
+ * @brief fuzz run the set command
+ * @note  the param, the output length and the timeout are taken from the input
+ */
+static void a_fuzz_set_command(void)
+{
+    uint8_t res;
+    uint8_t len;
+    uint8_t out_len;
+    uint8_t timeout;
+    uint16_t i;
+    uint8_t param[256];
+    uint8_t out[256];
+    const uint8_t *r;
+    
+    len = 0;
+    out_len = 0;
+    timeout = 0;
+    (void)stream_get(&len);
+    (void)stream_get(&out_len);
+    (void)stream_get(&timeout);
+    for (i = 0; i < len; i++)
+    {
+        param[i] = 0;
+        (void)stream_get(&param[i]);
+    }
+    res = ch9120_set_command(&gs_handle, param, len, out, out_len, 0, (uint16_t)(timeout * 10));
+    if (res == 0)
+    {
+        a_fuzz_check_frame(param, len);
+        r = a_fuzz_response(out_len);
+        FUZZ_CHECK(memcmp(out, r, out_len) == 0);
+    }
+    FUZZ_CHECK(res <= 1);
+}
+
+/**
+ * @brief     fuzz run a checked command
+ * @param[in] index command index
+ * @note      a checked command only succeeds if the chip answers 0xAA,
+ *            the reset ack is taken from the marked command because the ready probe flushes the uart
+ */
+static void a_fuzz_check(uint8_t index)
+{
+    uint8_t res;
+    uint8_t ip[4];
+    uint16_t l;
+    const uint8_t *r;
+    
+    if (index == 0)
+    {
+        ip[0] = 192;
+        ip[1] = 168;
+        ip[2] = 1;
+        ip[3] = 230;
+        res = ch9120_set_ip(&gs_handle, ip);
+        r = stream_record(&l);
+        if (res == 0)
+        {
+            FUZZ_CHECK((l >= 1) && (r[0] == 0xAA));
+        }
+        else
+        {
+            FUZZ_CHECK((res == 1) && ((l == 0) || (r[0] != 0xAA)));
+        }
+    }
+    else
+    {
+        stream_mark();
+        res = ch9120_reset(&gs_handle);
+        r = stream_marked_record(&l);
+        if (res == 0)
+        {
+            FUZZ_CHECK((l >= 1) && (r[0] == 0xAA));
+            r = stream_marked_written(&l);
+            FUZZ_CHECK((l == 3) && (r[0] == 0x57) && (r[1] == 0xAB) && (r[2] == 0x02));
+        }
+        else
+        {
+            FUZZ_CHECK(res == 1);
+        }
+    }
+}
+
+/**
+ * @brief fuzz run the frame decoder
+ * @note  the type, the crc, the compression and the output size are taken from the input,
+ *        the frames are decoded from the uart data
+ */
+static void a_fuzz_recv_frame(void)
+{
+    uint8_t res;
+    uint8_t type;
+    uint8_t size;
+    uint16_t len;
+    uint8_t out[255];
+    
+    type = 0;
+    size = 0;
+    (void)stream_get(&type);
+    (void)stream_get(&size);
+    FUZZ_CHECK(ch9120_set_frame(&gs_handle, (ch9120_frame_t)(type & 0x01), gs_frame, 64) == 0);
+    FUZZ_CHECK(ch9120_set_frame_crc(&gs_handle, (ch9120_frame_crc_t)(((type >> 1) & 0x03) % 3)) == 0);
+    FUZZ_CHECK(ch9120_set_frame_compress(&gs_handle, (ch9120_bool_t)((type >> 3) & 0x01), NULL, 0) == 0);
+    do
+    {
+        len = size;
+        res = ch9120_recv_frame(&gs_handle, out, &len);
+        FUZZ_CHECK((res == 0) || (res == 5));
+        FUZZ_CHECK(len <= size);
+    } while ((res == 0) && (len != 0));
+}
+
+/**
+ * @brief     fuzz entry
+ * @param[in] *data pointer to the input data
+ * @param[in] size input size
+ * @return    always 0
+ * @note      each input byte selects a function and the following bytes are its responses
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t op;
+    uint8_t res;
+    
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    
+    /* ch9120 init */
+    stream_init(data, size);
+    res = ch9120_init(&gs_handle);
+    FUZZ_CHECK((res == 0) || (res == 7));
+    if (res != 0)
+    {
+        return 0;
+    }
+    
+    /* run the functions */
+    while (stream_get(&op) == 0)
+    {
+        op = op % FUZZ_CMD_NUM;
+        if (op < 15)
+        {
+            a_fuzz_get(op);
+        }
+        else if (op == 15)
+        {
+            a_fuzz_set_command();
+        }
+        else if (op < 18)
+        {
+            a_fuzz_check(op - 16);
+        }
+        else
+        {
+            a_fuzz_recv_frame();
+        }
+    }
+    
+    return 0;
+}
+
+#ifdef FUZZ_REPLAY
+#include <stdio.h>
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      replays the input files without libfuzzer
+ */
+int main(int argc, char **argv)
+{
+    int i;
+    
+    for (i = 1; i < argc; i++)
+    {
+        FILE *fp;
+        long size;
+        uint8_t *buf;
+        
+        fp = fopen(argv[i], "rb");
+        if (fp == NULL)
+        {
+            printf("fuzz: open %s failed.\n", argv[i]);
+            
+            return 1;
+        }
+        (void)fseek(fp, 0, SEEK_END);
+        size = ftell(fp);
+        (void)fseek(fp, 0, SEEK_SET);
+        buf = (uint8_t *)malloc((size > 0) ? (size_t)size : 1);
+        if (buf == NULL)
+        {
+            (void)fclose(fp);
+            
+            return 1;
+        }
+        if ((size > 0) && (fread(buf, 1, (size_t)size, fp) != (size_t)size))
+        {
+            printf("fuzz: read %s failed.\n", argv[i]);
+            free(buf);
+            (void)fclose(fp);
+            
+            return 1;
+        }
+        (void)fclose(fp);
+        (void)LLVMFuzzerTestOneInput(buf, (size_t)size);
+        free(buf);
+        printf("fuzz: replay %s ok.\n", argv[i]);
+    }
+    
+    return 0;
+}
+#endif
@@ -0,0 +1,453 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      host_driver_ch9120_interface.c
+ * @brief     host driver ch9120 interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_interface.h"
+#include "emulator.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+/**
+ * @brief crc32 slicing-by-8 table definition
+ */
+static uint32_t gs_crc32_table[8][256];        /**< crc32 table */
+static uint8_t gs_crc32_inited;                /**< crc32 table flag */
+
+/**
+ * @brief  interface uart init
+ * @return status code
+ *         - 0 success
+ *         - 1 uart init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface uart deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 uart deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief      interface uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint16_t ch9120_interface_uart_read(uint8_t *buf, uint16_t len)
+{
+    return emulator_uart_read(buf, len);
+}
+
+/**
+ * @brief  interface uart flush
+ * @return status code
+ *         - 0 success
+ *         - 1 uart flush failed
+ * @note   none
+ */
+uint8_t ch9120_interface_uart_flush(void)
+{
+    emulator_uart_flush();
+    
+    return 0;
+}
+
+/**
+ * @brief     interface uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_write(uint8_t *buf, uint16_t len)
+{
+    return emulator_uart_write(buf, len);
+}
+
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       none
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view)
+{
+    emulator_uart_peek(&view->buf[0], &view->len[0], &view->buf[1], &view->len[1]);
+    
+    return 0;
+}
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len)
+{
+    if (emulator_uart_consume(len) != len)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface reset gpio write
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_reset_gpio_write(uint8_t data)
+{
+    emulator_reset_write(data);
+    
+    return 0;
+}
+
+/**
+ * @brief  interface cfg gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 cfg gpio init failed
+ * @note   none
+ */
+uint8_t ch9120_interface_cfg_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface cfg gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 cfg gpio deinit failed
+ * @note   none
+ */
+uint8_t ch9120_interface_cfg_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface cfg gpio write
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_cfg_gpio_write(uint8_t data)
+{
+    emulator_cfg_write(data);
+    
+    return 0;
+}
+
+/**
+ * @brief     interface delay ms
+ * @param[in] ms time
+ * @note      none
+ */
+void ch9120_interface_delay_ms(uint32_t ms)
+{
+    emulator_delay_ms(ms);
+}
+
+/**
+ * @brief     interface print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void ch9120_interface_debug_print(const char *const fmt, ...)
+{
+    char str[256];
+    va_list args;
+    
+    memset((char *)str, 0, sizeof(char) * 256); 
+    va_start(args, fmt);
+    vsnprintf((char *)str, 255, (char const *)fmt, args);
+    va_end(args);
+    
+    (void)printf("%s", str);
+}
+
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   the emulator virtual clock is used
+ */
+uint64_t ch9120_interface_timestamp_us(void)
+{
+    return emulator_timestamp_us();
+}
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace)
+{
+    (void)trace;
+}
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace)
+{
+    (void)trace;
+}
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the emulator host storage is used
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len)
+{
+    return emulator_storage_read(buf, len);
+}
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the emulator host storage is used
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len)
+{
+    return emulator_storage_write(buf, len);
+}
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      slicing-by-8, the tables are built on the first call
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t crc;
+    
+    if (gs_crc32_inited == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            crc = i;
+            for (j = 0; j < 8; j++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+            gs_crc32_table[0][i] = crc;
+        }
+        for (i = 0; i < 256; i++)
+        {
+            for (j = 1; j < 8; j++)
+            {
+                gs_crc32_table[j][i] = (gs_crc32_table[j - 1][i] >> 8) ^ 
+                                       gs_crc32_table[0][gs_crc32_table[j - 1][i] & 0xFF];
+            }
+        }
+        gs_crc32_inited = 1;
+    }
+    crc = 0xFFFFFFFFU;
+    while (len >= 8)
+    {
+        lo = crc ^ ((uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | 
+                    ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));
+        hi = (uint32_t)buf[4] | ((uint32_t)buf[5] << 8) | 
+             ((uint32_t)buf[6] << 16) | ((uint32_t)buf[7] << 24);
+        crc = gs_crc32_table[7][lo & 0xFF] ^ gs_crc32_table[6][(lo >> 8) & 0xFF] ^
+              gs_crc32_table[5][(lo >> 16) & 0xFF] ^ gs_crc32_table[4][lo >> 24] ^
+              gs_crc32_table[3][hi & 0xFF] ^ gs_crc32_table[2][(hi >> 8) & 0xFF] ^
+              gs_crc32_table[1][(hi >> 16) & 0xFF] ^ gs_crc32_table[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+    while (len != 0)
+    {
+        crc = (crc >> 8) ^ gs_crc32_table[0][(crc ^ *buf++) & 0xFF];
+        len--;
+    }
+    
+    return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       the context is the cfg and io mutex of one handle
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx)
+{
+    pthread_mutex_t *mutex;
+    
+    mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t) * 2);
+    if (mutex == NULL)
+    {
+        return 1;
+    }
+    if (pthread_mutex_init(&mutex[0], NULL) != 0)
+    {
+        free(mutex);
+        
+        return 1;
+    }
+    if (pthread_mutex_init(&mutex[1], NULL) != 0)
+    {
+        (void)pthread_mutex_destroy(&mutex[0]);
+        free(mutex);
+        
+        return 1;
+    }
+    *ctx = mutex;
+    
+    return 0;
+}
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      none
+ */
+void ch9120_interface_mutex_deinit(void *ctx)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    (void)pthread_mutex_destroy(&mutex[0]);
+    (void)pthread_mutex_destroy(&mutex[1]);
+    free(mutex);
+}
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      none
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    if (wait == 0)
+    {
+        return (pthread_mutex_trylock(&mutex[id]) == 0) ? 0 : 1;
+    }
+    
+    return (pthread_mutex_lock(&mutex[id]) == 0) ? 0 : 1;
+}
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      none
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    (void)pthread_mutex_unlock(&mutex[id]);
+}
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      emulator.h
+ * @brief     emulator header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup emulator emulator function
+ * @brief    ch9120 emulator function modules
+ * @{
+ */
+
+/**
+ * @brief emulator fifo length definition
+ */
+#define EMULATOR_FIFO_LEN    4096        /**< 4096 bytes */
+
+/**
+ * @brief emulator timing structure definition
+ */
+typedef struct emulator_timing_s
+{
+    uint32_t baud;                 /**< uart baud rate between the host and the chip */
+    uint32_t response_us;          /**< command processing time in us */
+    uint32_t eeprom_us;            /**< eeprom write time in us */
+    uint32_t boot_us;              /**< boot time after a reset in us */
+} emulator_timing_t;
+
+/**
+ * @brief emulator stats structure definition
+ */
+typedef struct emulator_stats_s
+{
+    uint32_t commands;             /**< executed commands */
+    uint32_t eeprom_writes;        /**< eeprom writes */
+    uint32_t resets;               /**< chip resets */
+    uint32_t tx_bytes;             /**< bytes sent to the network */
+    uint32_t tx_packets;           /**< packets sent to the network */
+    uint32_t rx_bytes;             /**< bytes received from the network */
+} emulator_stats_t;
+
+/**
+ * @brief emulator init
+ * @note  restores the factory config, the default timing and the virtual clock
+ */
+void emulator_init(void);
+
+/**
+ * @brief     emulator set the timing
+ * @param[in] *timing pointer to a timing structure
+ * @note      none
+ */
+void emulator_set_timing(const emulator_timing_t *timing);
+
+/**
+ * @brief      emulator get the timing
+ * @param[out] *timing pointer to a timing structure
+ * @note       none
+ */
+void emulator_get_timing(emulator_timing_t *timing);
+
+/**
+ * @brief      emulator get the stats
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void emulator_get_stats(emulator_stats_t *stats);
+
+/**
+ * @brief     emulator set the rj45 link
+ * @param[in] up 1 if the link is up
+ * @param[in] delay_ms virtual time before the link changes
+ * @return    status code
+ *            - 0 success
+ *            - 1 too many changes
+ * @note      changes must be set in time order
+ */
+uint8_t emulator_set_link(uint8_t up, uint32_t delay_ms);
+
+/**
+ * @brief     emulator set the peer endpoint
+ * @param[in] *ip pointer to an ip buffer, NULL accepts every dest
+ * @param[in] port peer port
+ * @note      a tcp client only connects when its dest is the peer endpoint
+ */
+void emulator_set_peer(const uint8_t *ip, uint16_t port);
+
+/**
+ * @brief     emulator set the peer echo
+ * @param[in] enable 1 if the peer sends every received byte back
+ * @note      echoed bytes are not kept for emulator_peer_read
+ */
+void emulator_set_echo(uint8_t enable);
+
+/**
+ * @brief     emulator delay ms
+ * @param[in] ms time
+ * @note      advances the virtual clock
+ */
+void emulator_delay_ms(uint32_t ms);
+
+/**
+ * @brief  emulator get the timestamp
+ * @return virtual timestamp in us
+ * @note   none
+ */
+uint64_t emulator_timestamp_us(void);
+
+/**
+ * @brief     emulator write the cfg pin
+ * @param[in] level pin level
+ * @note      low enters the config mode
+ */
+void emulator_cfg_write(uint8_t level);
+
+/**
+ * @brief     emulator write the reset pin
+ * @param[in] level pin level
+ * @note      a rising edge reboots the chip
+ */
+void emulator_reset_write(uint8_t level);
+
+/**
+ * @brief      emulator uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       only the bytes which have arrived at the current time are returned
+ */
+uint16_t emulator_uart_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      emulator uart peek
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @note       the segments point into the receive fifo, nothing is removed
+ */
+void emulator_uart_peek(uint8_t **buf0, uint16_t *len0, uint8_t **buf1, uint16_t *len1);
+
+/**
+ * @brief     emulator uart consume
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint16_t emulator_uart_consume(uint16_t len);
+
+/**
+ * @brief emulator uart flush
+ * @note  drops the received bytes
+ */
+void emulator_uart_flush(void);
+
+/**
+ * @brief     emulator uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      blocks for the uart transfer time
+ */
+uint8_t emulator_uart_write(const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     emulator send data from the network peer
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @param[in] delay_ms arrival delay in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 fifo is full
+ * @note      the data is forwarded to the uart when the chip is not in the config mode
+ */
+uint8_t emulator_peer_write(const uint8_t *buf, uint16_t len, uint32_t delay_ms);
+
+/**
+ * @brief      emulator read data received by the network peer
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       none
+ */
+uint16_t emulator_peer_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      emulator read the host storage
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no data
+ * @note       the host storage models a file next to the firmware and is cleared by emulator_init
+ */
+uint8_t emulator_storage_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     emulator write the host storage
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 len is too long
+ * @note      none
+ */
+uint8_t emulator_storage_write(const uint8_t *buf, uint16_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
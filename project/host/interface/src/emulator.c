@@ -0,0 +1,856 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      emulator.c
+ * @brief     emulator source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "emulator.h"
+#include <string.h>
+
+/**
+ * @brief chip version definition
+ */
+#define EMULATOR_VERSION    0x05        /**< chip version */
+
+/**
+ * @brief emulator fifo structure definition
+ */
+typedef struct emulator_fifo_s
+{
+    uint8_t data[EMULATOR_FIFO_LEN];         /**< data buffer */
+    uint64_t ready[EMULATOR_FIFO_LEN];       /**< arrival time of each byte */
+    uint16_t head;                           /**< read point */
+    uint16_t len;                            /**< data length */
+} emulator_fifo_t;
+
+/**
+ * @brief emulator config structure definition
+ */
+typedef struct emulator_config_s
+{
+    uint8_t mode;                /**< chip mode */
+    uint8_t ip[4];               /**< ip */
+    uint8_t mask[4];             /**< subnet mask */
+    uint8_t gateway[4];          /**< gateway */
+    uint8_t port[2];             /**< source port */
+    uint8_t dst_ip[4];           /**< dest ip */
+    uint8_t dst_port[2];         /**< dest port */
+    uint8_t random;              /**< source port random */
+    uint8_t baud[4];             /**< uart baud */
+    uint8_t uart[3];             /**< stop bit, parity and data bit */
+    uint8_t timeout[4];          /**< uart timeout */
+    uint8_t disconnect;          /**< disconnect with no rj45 */
+    uint8_t len[4];              /**< uart buffer length */
+    uint8_t flush;               /**< uart flush */
+    uint8_t dhcp;                /**< dhcp */
+} emulator_config_t;
+
+/**
+ * @brief factory config
+ */
+static const emulator_config_t gs_factory =
+{
+    0x01,
+    {192, 168, 1, 200},
+    {255, 255, 255, 0},
+    {192, 168, 1, 1},
+    {0xD0, 0x07},
+    {192, 168, 1, 100},
+    {0xE8, 0x03},
+    0x00,
+    {0x80, 0x25, 0x00, 0x00},
+    {0x01, 0x04, 0x08},
+    {0x00, 0x00, 0x00, 0x00},
+    0x01,
+    {0x00, 0x00, 0x00, 0x00},
+    0x00,
+    0x00,
+};
+
+static emulator_fifo_t gs_rx;                /**< chip to host bytes in the config mode */
+static emulator_fifo_t gs_peer_rx;           /**< network to host bytes */
+static emulator_fifo_t gs_peer_tx;           /**< host to network bytes */
+static emulator_config_t gs_config;          /**< working config */
+static emulator_config_t gs_eeprom;          /**< saved config */
+static emulator_config_t gs_active;          /**< running config */
+static emulator_timing_t gs_timing;          /**< timing */
+static emulator_stats_t gs_stats;            /**< stats */
+static uint64_t gs_now_us;                   /**< virtual clock */
+static uint64_t gs_boot_us;                  /**< boot finished time */
+static uint8_t gs_cfg;                       /**< cfg pin level */
+static uint8_t gs_reset;                     /**< reset pin level */
+static uint8_t gs_link;                      /**< rj45 link */
+static uint8_t gs_link_up[8];                /**< scheduled link levels */
+static uint64_t gs_link_at[8];               /**< scheduled link times */
+static uint8_t gs_link_num;                  /**< scheduled link number */
+static uint16_t gs_packet_len;               /**< bytes in the current network packet */
+static uint64_t gs_packet_us;                /**< last byte time of the current network packet */
+static uint8_t gs_peer;                      /**< peer endpoint flag */
+static uint8_t gs_echo;                      /**< peer echo flag */
+static uint8_t gs_peer_ip[4];                /**< peer ip */
+static uint8_t gs_peer_port[2];              /**< peer port */
+static uint8_t gs_cmd[160];                  /**< command parser buffer */
+static uint16_t gs_cmd_len;                  /**< command parser length */
+static uint8_t gs_storage[128];              /**< host storage */
+static uint16_t gs_storage_len;              /**< host storage length */
+
+/**
+ * @brief     fifo push a byte
+ * @param[in] *fifo pointer to a fifo structure
+ * @param[in] byte pushed byte
+ * @param[in] ready arrival time
+ * @return    status code
+ *            - 0 success
+ *            - 1 fifo is full
+ * @note      none
+ */
+static uint8_t a_fifo_push(emulator_fifo_t *fifo, uint8_t byte, uint64_t ready)
+{
+    uint16_t pos;
+    
+    if (fifo->len >= EMULATOR_FIFO_LEN)
+    {
+        return 1;
+    }
+    pos = (uint16_t)((fifo->head + fifo->len) % EMULATOR_FIFO_LEN);
+    fifo->data[pos] = byte;
+    fifo->ready[pos] = ready;
+    fifo->len++;
+    
+    return 0;
+}
+
+/**
+ * @brief      fifo pop the arrived bytes
+ * @param[in]  *fifo pointer to a fifo structure
+ * @param[out] *buf pointer to a data buffer, NULL drops the bytes
+ * @param[in]  len length of the data buffer
+ * @return     length of the popped data
+ * @note       none
+ */
+static uint16_t a_fifo_pop(emulator_fifo_t *fifo, uint8_t *buf, uint16_t len)
+{
+    uint16_t l;
+    
+    l = 0;
+    while ((l < len) && (fifo->len != 0) && (fifo->ready[fifo->head] <= gs_now_us))
+    {
+        if (buf != NULL)
+        {
+            buf[l] = fifo->data[fifo->head];
+        }
+        fifo->head = (uint16_t)((fifo->head + 1) % EMULATOR_FIFO_LEN);
+        fifo->len--;
+        l++;
+    }
+    
+    return l;
+}
+
+/**
+ * @brief  get the uart byte time
+ * @return byte time in us
+ * @note   10 bits per byte
+ */
+static uint32_t a_byte_us(void)
+{
+    return (gs_timing.baud != 0) ? (10000000U / gs_timing.baud) : 0;
+}
+
+/**
+ * @brief     get the rj45 link
+ * @param[in] t current time
+ * @return    1 if the link is up
+ * @note      scheduled changes up to t are applied
+ */
+static uint8_t a_link(uint64_t t)
+{
+    uint8_t i;
+    
+    while ((gs_link_num != 0) && (gs_link_at[0] <= t))
+    {
+        gs_link = gs_link_up[0];
+        for (i = 1; i < gs_link_num; i++)
+        {
+            gs_link_up[i - 1] = gs_link_up[i];
+            gs_link_at[i - 1] = gs_link_at[i];
+        }
+        gs_link_num--;
+    }
+    
+    return gs_link;
+}
+
+/**
+ * @brief     get the network session
+ * @param[in] t current time
+ * @return    1 if the session is connected
+ * @note      a tcp client only connects when its dest is the peer endpoint
+ */
+static uint8_t a_connected(uint64_t t)
+{
+    if (a_link(t) == 0)
+    {
+        return 0;
+    }
+    if ((gs_peer != 0) && (gs_active.mode == 0x01))
+    {
+        if ((memcmp(gs_active.dst_ip, gs_peer_ip, 4) != 0) ||
+            (memcmp(gs_active.dst_port, gs_peer_port, 2) != 0))
+        {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief     packetize a byte sent to the network
+ * @param[in] t byte arrival time
+ * @note      a packet ends after the uart timeout or at the uart buffer length
+ */
+static void a_packetize(uint64_t t)
+{
+    uint32_t len;
+    uint64_t timeout;
+    
+    timeout = (uint64_t)gs_active.timeout[0] * 5000;
+    if (timeout == 0)
+    {
+        timeout = 4 * a_byte_us();
+    }
+    len = (uint32_t)gs_active.len[0] | ((uint32_t)gs_active.len[1] << 8) |
+          ((uint32_t)gs_active.len[2] << 16) | ((uint32_t)gs_active.len[3] << 24);
+    if ((len == 0) || (len > 1460))
+    {
+        len = 1460;
+    }
+    if ((gs_packet_len == 0) || ((t - gs_packet_us) > timeout) || (gs_packet_len >= len))
+    {
+        gs_stats.tx_packets++;
+        gs_packet_len = 0;
+    }
+    gs_packet_len++;
+    gs_packet_us = t;
+}
+
+/**
+ * @brief     reboot the chip
+ * @param[in] t reboot time
+ * @note      the working config is reloaded from the eeprom and starts running,
+ *            the written parameters only take effect here
+ */
+static void a_reboot(uint64_t t)
+{
+    gs_config = gs_eeprom;
+    gs_active = gs_eeprom;
+    gs_boot_us = t + gs_timing.boot_us;
+    gs_cmd_len = 0;
+    gs_stats.resets++;
+}
+
+/**
+ * @brief     queue a response
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @param[in] t response start time
+ * @return    time of the last byte
+ * @note      none
+ */
+static uint64_t a_respond(const uint8_t *buf, uint16_t len, uint64_t t)
+{
+    uint16_t i;
+    
+    for (i = 0; i < len; i++)
+    {
+        t += a_byte_us();
+        (void)a_fifo_push(&gs_rx, buf[i], t);
+    }
+    
+    return t;
+}
+
+/**
+ * @brief     execute a command
+ * @param[in] t time when the command has been received
+ * @note      none
+ */
+static void a_execute(uint64_t t)
+{
+    uint8_t ack;
+    uint8_t *p;
+    uint64_t end;
+    emulator_config_t *c;
+    
+    c = &gs_config;
+    p = &gs_cmd[3];
+    ack = 0xAA;
+    t += gs_timing.response_us;
+    gs_stats.commands++;
+    switch (gs_cmd[2])
+    {
+        case 0x01 :
+        {
+            ack = EMULATOR_VERSION;
+            (void)a_respond(&ack, 1, t);
+            
+            break;
+        }
+        case 0x02 :
+        {
+            end = a_respond(&ack, 1, t);
+            a_reboot(end);
+            
+            break;
+        }
+        case 0x03 :
+        {
+            ack = a_connected(t);
+            (void)a_respond(&ack, 1, t);
+            
+            break;
+        }
+        case 0x0D :
+        {
+            gs_eeprom = gs_config;
+            gs_stats.eeprom_writes++;
+            (void)a_respond(&ack, 1, t + gs_timing.eeprom_us);
+            
+            break;
+        }
+        case 0x0E :
+        {
+            gs_eeprom = gs_config;
+            gs_stats.eeprom_writes++;
+            end = a_respond(&ack, 1, t + gs_timing.eeprom_us);
+            a_reboot(end);
+            
+            break;
+        }
+        case 0x10 : c->mode = p[0]; (void)a_respond(&ack, 1, t); break;
+        case 0x11 : memcpy(c->ip, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x12 : memcpy(c->mask, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x13 : memcpy(c->gateway, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x14 : memcpy(c->port, p, 2); (void)a_respond(&ack, 1, t); break;
+        case 0x15 : memcpy(c->dst_ip, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x16 : memcpy(c->dst_port, p, 2); (void)a_respond(&ack, 1, t); break;
+        case 0x17 : c->random = p[0]; (void)a_respond(&ack, 1, t); break;
+        case 0x21 : memcpy(c->baud, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x22 : memcpy(c->uart, p, 3); (void)a_respond(&ack, 1, t); break;
+        case 0x23 : memcpy(c->timeout, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x24 : c->disconnect = p[0]; (void)a_respond(&ack, 1, t); break;
+        case 0x25 : memcpy(c->len, p, 4); (void)a_respond(&ack, 1, t); break;
+        case 0x26 : c->flush = p[0]; (void)a_respond(&ack, 1, t); break;
+        case 0x33 : c->dhcp = p[0]; (void)a_respond(&ack, 1, t); break;
+        case 0x5E : (void)a_respond(&ack, 1, t); break;
+        case 0x60 : (void)a_respond(&c->mode, 1, t); break;
+        case 0x61 : (void)a_respond(c->ip, 4, t); break;
+        case 0x62 : (void)a_respond(c->mask, 4, t); break;
+        case 0x63 : (void)a_respond(c->gateway, 4, t); break;
+        case 0x64 : (void)a_respond(c->port, 2, t); break;
+        case 0x65 : (void)a_respond(c->dst_ip, 4, t); break;
+        case 0x66 : (void)a_respond(c->dst_port, 2, t); break;
+        case 0x71 : (void)a_respond(c->baud, 4, t); break;
+        case 0x72 : (void)a_respond(c->uart, 3, t); break;
+        case 0x73 : (void)a_respond(c->timeout, 1, t); break;
+        case 0x74 : (void)a_respond(&c->disconnect, 1, t); break;
+        case 0x75 : (void)a_respond(c->len, 4, t); break;
+        case 0x76 : (void)a_respond(&c->flush, 1, t); break;
+        default : break;
+    }
+}
+
+/**
+ * @brief     get the param length of a command
+ * @param[in] cmd command
+ * @return    param length, -1 means an unknown command
+ * @note      none
+ */
+static int a_param_len(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case 0x01 : case 0x02 : case 0x03 : case 0x0D : case 0x0E : case 0x5E :
+        case 0x60 : case 0x61 : case 0x62 : case 0x63 : case 0x64 : case 0x65 : case 0x66 :
+        case 0x71 : case 0x72 : case 0x73 : case 0x74 : case 0x75 : case 0x76 :
+        {
+            return 0;
+        }
+        case 0x10 : case 0x17 : case 0x24 : case 0x26 : case 0x33 :
+        {
+            return 1;
+        }
+        case 0x14 : case 0x16 :
+        {
+            return 2;
+        }
+        case 0x22 :
+        {
+            return 3;
+        }
+        case 0x11 : case 0x12 : case 0x13 : case 0x15 : case 0x21 : case 0x23 : case 0x25 :
+        {
+            return 4;
+        }
+        default :
+        {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief     parse a config byte
+ * @param[in] byte received byte
+ * @param[in] t receive time
+ * @note      none
+ */
+static void a_parse(uint8_t byte, uint64_t t)
+{
+    int l;
+    
+    if (gs_cmd_len == 0)
+    {
+        if (byte == 0x57)
+        {
+            gs_cmd[gs_cmd_len++] = byte;
+        }
+        
+        return;
+    }
+    if (gs_cmd_len == 1)
+    {
+        if (byte == 0xAB)
+        {
+            gs_cmd[gs_cmd_len++] = byte;
+        }
+        else
+        {
+            gs_cmd_len = (byte == 0x57) ? 1 : 0;
+        }
+        
+        return;
+    }
+    gs_cmd[gs_cmd_len++] = byte;
+    l = a_param_len(gs_cmd[2]);
+    if (l < 0)
+    {
+        gs_cmd_len = 0;
+        
+        return;
+    }
+    if (gs_cmd_len >= 3 + l)
+    {
+        a_execute(t);
+        gs_cmd_len = 0;
+    }
+}
+
+/**
+ * @brief emulator init
+ * @note  restores the factory config, the default timing and the virtual clock
+ */
+void emulator_init(void)
+{
+    memset(&gs_rx, 0, sizeof(emulator_fifo_t));
+    memset(&gs_peer_rx, 0, sizeof(emulator_fifo_t));
+    memset(&gs_peer_tx, 0, sizeof(emulator_fifo_t));
+    memset(&gs_stats, 0, sizeof(emulator_stats_t));
+    gs_config = gs_factory;
+    gs_eeprom = gs_factory;
+    gs_active = gs_factory;
+    gs_timing.baud = 9600;
+    gs_timing.response_us = 1000;
+    gs_timing.eeprom_us = 20000;
+    gs_timing.boot_us = 250000;
+    gs_now_us = 0;
+    gs_boot_us = 0;
+    gs_cfg = 1;
+    gs_reset = 1;
+    gs_link = 1;
+    gs_link_num = 0;
+    gs_peer = 0;
+    gs_echo = 0;
+    gs_packet_len = 0;
+    gs_packet_us = 0;
+    gs_cmd_len = 0;
+    gs_storage_len = 0;
+}
+
+/**
+ * @brief     emulator set the timing
+ * @param[in] *timing pointer to a timing structure
+ * @note      none
+ */
+void emulator_set_timing(const emulator_timing_t *timing)
+{
+    gs_timing = *timing;
+}
+
+/**
+ * @brief      emulator get the timing
+ * @param[out] *timing pointer to a timing structure
+ * @note       none
+ */
+void emulator_get_timing(emulator_timing_t *timing)
+{
+    *timing = gs_timing;
+}
+
+/**
+ * @brief      emulator get the stats
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void emulator_get_stats(emulator_stats_t *stats)
+{
+    *stats = gs_stats;
+}
+
+/**
+ * @brief     emulator set the rj45 link
+ * @param[in] up 1 if the link is up
+ * @param[in] delay_ms virtual time before the link changes
+ * @return    status code
+ *            - 0 success
+ *            - 1 too many changes
+ * @note      changes must be set in time order
+ */
+uint8_t emulator_set_link(uint8_t up, uint32_t delay_ms)
+{
+    if (gs_link_num >= 8)
+    {
+        return 1;
+    }
+    gs_link_up[gs_link_num] = (up != 0) ? 1 : 0;
+    gs_link_at[gs_link_num] = gs_now_us + (uint64_t)delay_ms * 1000;
+    gs_link_num++;
+    (void)a_link(gs_now_us);
+    
+    return 0;
+}
+
+/**
+ * @brief     emulator set the peer endpoint
+ * @param[in] *ip pointer to an ip buffer, NULL accepts every dest
+ * @param[in] port peer port
+ * @note      a tcp client only connects when its dest is the peer endpoint
+ */
+void emulator_set_peer(const uint8_t *ip, uint16_t port)
+{
+    if (ip == NULL)
+    {
+        gs_peer = 0;
+        
+        return;
+    }
+    memcpy(gs_peer_ip, ip, 4);
+    gs_peer_port[0] = (uint8_t)(port & 0xFF);
+    gs_peer_port[1] = (uint8_t)((port >> 8) & 0xFF);
+    gs_peer = 1;
+}
+
+/**
+ * @brief     emulator set the peer echo
+ * @param[in] enable 1 if the peer sends every received byte back
+ * @note      echoed bytes are not kept for emulator_peer_read
+ */
+void emulator_set_echo(uint8_t enable)
+{
+    gs_echo = enable;
+}
+
+/**
+ * @brief     emulator delay ms
+ * @param[in] ms time
+ * @note      advances the virtual clock
+ */
+void emulator_delay_ms(uint32_t ms)
+{
+    gs_now_us += (uint64_t)ms * 1000;
+}
+
+/**
+ * @brief  emulator get the timestamp
+ * @return virtual timestamp in us
+ * @note   none
+ */
+uint64_t emulator_timestamp_us(void)
+{
+    return gs_now_us;
+}
+
+/**
+ * @brief     emulator write the cfg pin
+ * @param[in] level pin level
+ * @note      low enters the config mode
+ */
+void emulator_cfg_write(uint8_t level)
+{
+    gs_cfg = (level != 0) ? 1 : 0;
+    gs_cmd_len = 0;
+}
+
+/**
+ * @brief     emulator write the reset pin
+ * @param[in] level pin level
+ * @note      a rising edge reboots the chip and drops the received bytes
+ */
+void emulator_reset_write(uint8_t level)
+{
+    level = (level != 0) ? 1 : 0;
+    if ((gs_reset == 0) && (level != 0))
+    {
+        gs_rx.len = 0;
+        (void)a_fifo_pop(&gs_peer_rx, NULL, EMULATOR_FIFO_LEN);
+        a_reboot(gs_now_us);
+    }
+    gs_reset = level;
+}
+
+/**
+ * @brief      emulator uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       only the bytes which have arrived at the current time are returned
+ */
+uint16_t emulator_uart_read(uint8_t *buf, uint16_t len)
+{
+    uint16_t l;
+    
+    if (gs_cfg == 0)
+    {
+        return a_fifo_pop(&gs_rx, buf, len);
+    }
+    l = a_fifo_pop(&gs_peer_rx, buf, len);
+    gs_stats.rx_bytes += l;
+    
+    return l;
+}
+
+/**
+ * @brief      emulator uart peek
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @note       the segments point into the receive fifo, nothing is removed
+ */
+void emulator_uart_peek(uint8_t **buf0, uint16_t *len0, uint8_t **buf1, uint16_t *len1)
+{
+    uint16_t l;
+    uint16_t end;
+    emulator_fifo_t *fifo;
+    
+    fifo = (gs_cfg == 0) ? &gs_rx : &gs_peer_rx;
+    l = 0;
+    while ((l < fifo->len) && (fifo->ready[(fifo->head + l) % EMULATOR_FIFO_LEN] <= gs_now_us))
+    {
+        l++;
+    }
+    end = EMULATOR_FIFO_LEN - fifo->head;
+    *buf0 = &fifo->data[fifo->head];
+    *len0 = (l < end) ? l : end;
+    *buf1 = &fifo->data[0];
+    *len1 = l - *len0;
+}
+
+/**
+ * @brief     emulator uart consume
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint16_t emulator_uart_consume(uint16_t len)
+{
+    uint16_t l;
+    
+    if (gs_cfg == 0)
+    {
+        return a_fifo_pop(&gs_rx, NULL, len);
+    }
+    l = a_fifo_pop(&gs_peer_rx, NULL, len);
+    gs_stats.rx_bytes += l;
+    
+    return l;
+}
+
+/**
+ * @brief emulator uart flush
+ * @note  drops the received bytes
+ */
+void emulator_uart_flush(void)
+{
+    (void)a_fifo_pop(&gs_rx, NULL, EMULATOR_FIFO_LEN);
+    (void)a_fifo_pop(&gs_peer_rx, NULL, EMULATOR_FIFO_LEN);
+}
+
+/**
+ * @brief     emulator uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      blocks for the uart transfer time
+ */
+uint8_t emulator_uart_write(const uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    
+    for (i = 0; i < len; i++)
+    {
+        gs_now_us += a_byte_us();
+        
+        /* the chip is booting or held in reset */
+        if ((gs_reset == 0) || (gs_now_us < gs_boot_us))
+        {
+            continue;
+        }
+        if (gs_cfg == 0)
+        {
+            a_parse(buf[i], gs_now_us);
+        }
+        else if (a_connected(gs_now_us) != 0)
+        {
+            if (gs_echo != 0)
+            {
+                gs_stats.tx_bytes++;
+                a_packetize(gs_now_us);
+                (void)emulator_peer_write(&buf[i], 1, 0);
+            }
+            else if (a_fifo_push(&gs_peer_tx, buf[i], gs_now_us) == 0)
+            {
+                gs_stats.tx_bytes++;
+                a_packetize(gs_now_us);
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     emulator send data from the network peer
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @param[in] delay_ms arrival delay in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 fifo is full
+ * @note      the data is forwarded to the uart when the chip is not in the config mode
+ */
+uint8_t emulator_peer_write(const uint8_t *buf, uint16_t len, uint32_t delay_ms)
+{
+    uint16_t i;
+    uint64_t t;
+    
+    t = gs_now_us + (uint64_t)delay_ms * 1000;
+    
+    /* the uart sends the bytes after the queued ones */
+    if (gs_peer_rx.len != 0)
+    {
+        uint64_t last;
+        
+        last = gs_peer_rx.ready[(gs_peer_rx.head + gs_peer_rx.len - 1) % EMULATOR_FIFO_LEN];
+        if (last > t)
+        {
+            t = last;
+        }
+    }
+    for (i = 0; i < len; i++)
+    {
+        t += a_byte_us();
+        if (a_fifo_push(&gs_peer_rx, buf[i], t) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      emulator read data received by the network peer
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       none
+ */
+uint16_t emulator_peer_read(uint8_t *buf, uint16_t len)
+{
+    return a_fifo_pop(&gs_peer_tx, buf, len);
+}
+
+/**
+ * @brief      emulator read the host storage
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no data
+ * @note       the host storage models a file next to the firmware and is cleared by emulator_init
+ */
+uint8_t emulator_storage_read(uint8_t *buf, uint16_t len)
+{
+    if (len != gs_storage_len)
+    {
+        return 1;
+    }
+    memcpy(buf, gs_storage, len);
+    
+    return 0;
+}
+
+/**
+ * @brief     emulator write the host storage
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 len is too long
+ * @note      none
+ */
+uint8_t emulator_storage_write(const uint8_t *buf, uint16_t len)
+{
+    if (len > sizeof(gs_storage))
+    {
+        return 1;
+    }
+    memcpy(gs_storage, buf, len);
+    gs_storage_len = len;
+    
+    return 0;
+}
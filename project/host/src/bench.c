@@ -0,0 +1,812 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      bench.c
+ * @brief     bench source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_basic.h"
+#include "emulator.h"
+#include <getopt.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief bench definition
+ */
+#define BENCH_MAX_METRICS        32          /**< max metrics */
+#define BENCH_COMMAND_TIMES      100         /**< command latency times */
+#define BENCH_DATA_LEN           4096        /**< data path length */
+#define BENCH_DATA_CHUNK         64          /**< data path chunk */
+#define BENCH_RECORD_TIMES       64          /**< telemetry records */
+#define BENCH_RECORD_LEN         16          /**< telemetry record length */
+#define BENCH_RECORD_PERIOD_MS   20          /**< telemetry record period */
+#define BENCH_TUNE_TRAIN         16          /**< auto tune training messages */
+#define BENCH_TUNE_TIMES         32          /**< auto tune measured messages */
+#define BENCH_TUNE_PART          3           /**< writes per message */
+#define BENCH_TUNE_LEN           8           /**< write length */
+#define BENCH_TUNE_GAP_MS        6           /**< gap between the writes of a message */
+#define BENCH_TUNE_PERIOD_MS     100         /**< message period */
+#define BENCH_TUNE_LATENCY_MS    50          /**< auto tune latency target */
+#define BENCH_ZIP_FRAMES         8           /**< compressed telemetry frames */
+#define BENCH_ZIP_RECORDS        8           /**< telemetry records per frame */
+
+/**
+ * @brief bench metric structure definition
+ */
+typedef struct bench_metric_s
+{
+    const char *name;          /**< metric name */
+    const char *unit;          /**< metric unit */
+    double value;              /**< measured value */
+    uint8_t lower;             /**< 1 if lower is better */
+    uint8_t compare;           /**< 1 if compared with the baseline */
+} bench_metric_t;
+
+static ch9120_handle_t gs_handle;                          /**< ch9120 handle */
+static bench_metric_t gs_metric[BENCH_MAX_METRICS];        /**< metrics */
+static uint8_t gs_metric_num;                              /**< metric number */
+static uint8_t gs_coalesce[512];                           /**< coalesce buffer */
+static ch9120_autotune_sample_t gs_sample[BENCH_TUNE_TRAIN * BENCH_TUNE_PART];    /**< auto tune sample buffer */
+static uint8_t gs_zip[1024];                               /**< compress buffer */
+static char gs_text[1024];                                 /**< telemetry text */
+
+/**
+ * @brief     bench add a metric
+ * @param[in] *name pointer to a metric name
+ * @param[in] *unit pointer to a metric unit
+ * @param[in] value measured value
+ * @param[in] lower 1 if lower is better
+ * @param[in] compare 1 if compared with the baseline
+ * @note      none
+ */
+static void a_bench_add(const char *name, const char *unit, double value, uint8_t lower, uint8_t compare)
+{
+    if (gs_metric_num >= BENCH_MAX_METRICS)
+    {
+        return;
+    }
+    gs_metric[gs_metric_num].name = name;
+    gs_metric[gs_metric_num].unit = unit;
+    gs_metric[gs_metric_num].value = value;
+    gs_metric[gs_metric_num].lower = lower;
+    gs_metric[gs_metric_num].compare = compare;
+    gs_metric_num++;
+    ch9120_interface_debug_print("bench: %s %.3f %s.\n", name, value, unit);
+}
+
+/**
+ * @brief  bench get the wall clock
+ * @return timestamp in ns
+ * @note   none
+ */
+static uint64_t a_bench_wall_ns(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  bench the provisioning path
+ * @return status code
+ *         - 0 success
+ *         - 1 run failed
+ * @note   uses the basic example like an application does
+ */
+static uint8_t a_bench_provision(void)
+{
+    uint8_t ip[4] = {192, 168, 1, 230};
+    uint8_t mask[4] = {255, 255, 255, 0};
+    uint8_t gateway[4] = {192, 168, 1, 1};
+    uint8_t dest_ip[4] = {192, 168, 1, 10};
+    uint8_t buf[BENCH_DATA_CHUNK];
+    uint16_t len;
+    uint32_t i;
+    uint32_t total;
+    uint64_t start;
+    uint64_t t;
+    emulator_stats_t stats;
+    
+    /* bring up */
+    emulator_init();
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_basic_init() != 0)
+    {
+        return 1;
+    }
+    a_bench_add("bring_up", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    
+    /* config */
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_basic_config(CH9120_MODE_TCP_CLIENT, ip, 2000, mask, gateway, dest_ip, 1000) != 0)
+    {
+        (void)ch9120_basic_deinit();
+        
+        return 1;
+    }
+    a_bench_add("provision", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    
+    /* retarget */
+    dest_ip[3] = 11;
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_basic_set_dest(dest_ip, 1001) != 0)
+    {
+        (void)ch9120_basic_deinit();
+        
+        return 1;
+    }
+    a_bench_add("retarget", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    
+    /* write throughput */
+    memset(buf, 0x5A, sizeof(uint8_t) * BENCH_DATA_CHUNK);
+    start = ch9120_interface_timestamp_us();
+    for (i = 0; i < BENCH_DATA_LEN; i += BENCH_DATA_CHUNK)
+    {
+        if (ch9120_basic_write(buf, BENCH_DATA_CHUNK) != 0)
+        {
+            (void)ch9120_basic_deinit();
+            
+            return 1;
+        }
+    }
+    t = ch9120_interface_timestamp_us() - start;
+    a_bench_add("write_throughput", "B/s", (t != 0) ? ((double)BENCH_DATA_LEN * 1000000.0 / (double)t) : 0.0, 0, 1);
+    
+    /* read throughput */
+    for (i = 0; i < BENCH_DATA_LEN; i += BENCH_DATA_CHUNK)
+    {
+        if (emulator_peer_write(buf, BENCH_DATA_CHUNK, 0) != 0)
+        {
+            (void)ch9120_basic_deinit();
+            
+            return 1;
+        }
+    }
+    total = 0;
+    start = ch9120_interface_timestamp_us();
+    for (i = 0; (i < 100000) && (total < BENCH_DATA_LEN); i++)
+    {
+        len = BENCH_DATA_CHUNK;
+        if (ch9120_basic_read(buf, &len) != 0)
+        {
+            (void)ch9120_basic_deinit();
+            
+            return 1;
+        }
+        total += len;
+        if (len == 0)
+        {
+            ch9120_interface_delay_ms(1);
+        }
+    }
+    if (total < BENCH_DATA_LEN)
+    {
+        (void)ch9120_basic_deinit();
+        
+        return 1;
+    }
+    t = ch9120_interface_timestamp_us() - start;
+    a_bench_add("read_throughput", "B/s", (t != 0) ? ((double)total * 1000000.0 / (double)t) : 0.0, 0, 1);
+    
+    /* deinit */
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_basic_deinit() != 0)
+    {
+        return 1;
+    }
+    a_bench_add("deinit", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    
+    /* restart with the same config */
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_basic_init() != 0)
+    {
+        return 1;
+    }
+    if (ch9120_basic_config(CH9120_MODE_TCP_CLIENT, ip, 2000, mask, gateway, dest_ip, 1001) != 0)
+    {
+        (void)ch9120_basic_deinit();
+        
+        return 1;
+    }
+    a_bench_add("reprovision", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    emulator_get_stats(&stats);
+    a_bench_add("eeprom_writes", "count", (double)stats.eeprom_writes, 1, 1);
+    if (ch9120_basic_deinit() != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     bench send split messages
+ * @param[in] times message number
+ * @return    status code
+ *            - 0 success
+ *            - 1 send failed
+ * @note      every message is written in parts with a short gap
+ */
+static uint8_t a_bench_messages(uint32_t times)
+{
+    uint8_t part[BENCH_TUNE_LEN];
+    uint32_t i;
+    uint32_t j;
+    
+    memset(part, 0xA5, sizeof(uint8_t) * BENCH_TUNE_LEN);
+    for (i = 0; i < times; i++)
+    {
+        for (j = 0; j < BENCH_TUNE_PART; j++)
+        {
+            if (ch9120_write(&gs_handle, part, BENCH_TUNE_LEN) != 0)
+            {
+                return 1;
+            }
+            ch9120_interface_delay_ms((j + 1 < BENCH_TUNE_PART) ? BENCH_TUNE_GAP_MS :
+                                      (BENCH_TUNE_PERIOD_MS - BENCH_TUNE_GAP_MS * (BENCH_TUNE_PART - 1)));
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  bench the command latency
+ * @return status code
+ *         - 0 success
+ *         - 1 run failed
+ * @note   none
+ */
+static uint8_t a_bench_command(void)
+{
+    uint8_t cmd;
+    uint8_t version;
+    uint8_t ip[4] = {192, 168, 1, 10};
+    uint8_t record[BENCH_RECORD_LEN];
+    uint32_t i;
+    uint32_t j;
+    uint32_t len;
+    uint32_t total;
+    uint32_t packets;
+    uint64_t start;
+    uint64_t wall;
+    uint64_t t;
+    uint64_t stall;
+    uint16_t token;
+    ch9120_async_status_t status;
+    emulator_stats_t stats;
+    
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_STORAGE_READ(&gs_handle, ch9120_interface_storage_read);
+    DRIVER_CH9120_LINK_STORAGE_WRITE(&gs_handle, ch9120_interface_storage_write);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+    DRIVER_CH9120_LINK_MUTEX_INIT(&gs_handle, ch9120_interface_mutex_init);
+    DRIVER_CH9120_LINK_MUTEX_DEINIT(&gs_handle, ch9120_interface_mutex_deinit);
+    DRIVER_CH9120_LINK_MUTEX_LOCK(&gs_handle, ch9120_interface_mutex_lock);
+    DRIVER_CH9120_LINK_MUTEX_UNLOCK(&gs_handle, ch9120_interface_mutex_unlock);
+    
+    /* init */
+    emulator_init();
+    if (ch9120_init(&gs_handle) != 0)
+    {
+        return 1;
+    }
+    
+    /* get version */
+    wall = a_bench_wall_ns();
+    start = ch9120_interface_timestamp_us();
+    for (i = 0; i < BENCH_COMMAND_TIMES; i++)
+    {
+        if (ch9120_get_version(&gs_handle, &version) != 0)
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    a_bench_add("get_version_latency", "us",
+                (double)(ch9120_interface_timestamp_us() - start) / BENCH_COMMAND_TIMES, 1, 1);
+    a_bench_add("get_version_host_cpu", "ns",
+                (double)(a_bench_wall_ns() - wall) / BENCH_COMMAND_TIMES, 1, 0);
+    
+    /* set dest ip */
+    start = ch9120_interface_timestamp_us();
+    for (i = 0; i < BENCH_COMMAND_TIMES; i++)
+    {
+        if (ch9120_set_dest_ip(&gs_handle, ip) != 0)
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    a_bench_add("set_dest_ip_latency", "us",
+                (double)(ch9120_interface_timestamp_us() - start) / BENCH_COMMAND_TIMES, 1, 1);
+    
+    /* get version without blocking */
+    stall = 0;
+    cmd = 0x01;
+    for (i = 0; i < BENCH_COMMAND_TIMES; i++)
+    {
+        start = ch9120_interface_timestamp_us();
+        if (ch9120_async_command(&gs_handle, &cmd, 1, &version, 1, 
+                                 CH9120_UART_PRE_DELAY, 1000, &token) != 0)
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+        t = ch9120_interface_timestamp_us() - start;
+        stall = (t > stall) ? t : stall;
+        status = CH9120_ASYNC_STATUS_BUSY;
+        while (status == CH9120_ASYNC_STATUS_BUSY)
+        {
+            ch9120_interface_delay_ms(1);
+            start = ch9120_interface_timestamp_us();
+            if ((ch9120_poll(&gs_handle, (uint32_t)(start / 1000)) != 0) ||
+                (ch9120_async_get_status(&gs_handle, token, &status) != 0))
+            {
+                (void)ch9120_deinit(&gs_handle);
+                
+                return 1;
+            }
+            t = ch9120_interface_timestamp_us() - start;
+            stall = (t > stall) ? t : stall;
+        }
+        if (status != CH9120_ASYNC_STATUS_OK)
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    a_bench_add("async_command_stall", "us", (double)stall, 1, 1);
+    
+    /* telemetry records through the write coalescer */
+    if (ch9120_set_write_coalesce(&gs_handle, gs_coalesce, 512, 500) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    memset(record, 0x5A, sizeof(uint8_t) * BENCH_RECORD_LEN);
+    for (i = 0; i < BENCH_RECORD_TIMES; i++)
+    {
+        if ((ch9120_write(&gs_handle, record, BENCH_RECORD_LEN) != 0) ||
+            (ch9120_write_handler(&gs_handle) != 0))
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+        ch9120_interface_delay_ms(BENCH_RECORD_PERIOD_MS);
+    }
+    if ((ch9120_write_flush(&gs_handle) != 0) ||
+        (ch9120_set_write_coalesce(&gs_handle, NULL, 0, 0) != 0))
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    emulator_get_stats(&stats);
+    a_bench_add("telemetry_packets", "count", (double)stats.tx_packets, 1, 1);
+    
+    /* split messages after the uart auto tune */
+    if (ch9120_set_autotune(&gs_handle, gs_sample, BENCH_TUNE_TRAIN * BENCH_TUNE_PART,
+                            0, BENCH_TUNE_LATENCY_MS) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (a_bench_messages(BENCH_TUNE_TRAIN) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (ch9120_autotune_handler(&gs_handle) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    emulator_get_stats(&stats);
+    packets = stats.tx_packets;
+    if (a_bench_messages(BENCH_TUNE_TIMES) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    ch9120_interface_delay_ms(BENCH_TUNE_PERIOD_MS);
+    emulator_get_stats(&stats);
+    a_bench_add("autotune_packets", "count", (double)(stats.tx_packets - packets), 1, 1);
+    
+    /* text telemetry frames with compression */
+    if ((ch9120_set_frame(&gs_handle, CH9120_FRAME_COBS, NULL, 0) != 0) ||
+        (ch9120_set_frame_crc(&gs_handle, CH9120_FRAME_CRC_32) != 0) ||
+        (ch9120_set_frame_compress(&gs_handle, CH9120_BOOL_TRUE, gs_zip, 1024) != 0))
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    total = 0;
+    start = ch9120_interface_timestamp_us();
+    for (i = 0; i < BENCH_ZIP_FRAMES; i++)
+    {
+        len = 0;
+        for (j = 0; j < BENCH_ZIP_RECORDS; j++)
+        {
+            len += (uint32_t)snprintf(&gs_text[len], 1024 - len,
+                                      "{\"seq\":%u,\"temperature\":%u.%u,\"humidity\":%u,\"status\":\"ok\"}\n",
+                                      (unsigned int)(i * BENCH_ZIP_RECORDS + j), (unsigned int)(20 + (j % 5)),
+                                      (unsigned int)((i + j) % 10), (unsigned int)(40 + (i % 20)));
+        }
+        if (ch9120_send_frame(&gs_handle, (uint8_t *)gs_text, (uint16_t)len) != 0)
+        {
+            (void)ch9120_deinit(&gs_handle);
+            
+            return 1;
+        }
+        total += len;
+    }
+    t = ch9120_interface_timestamp_us() - start;
+    a_bench_add("zip_frame_throughput", "B/s", (t != 0) ? ((double)total * 1000000.0 / (double)t) : 0.0, 0, 1);
+    if (ch9120_set_frame_compress(&gs_handle, CH9120_BOOL_FALSE, NULL, 0) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* reset */
+    start = ch9120_interface_timestamp_us();
+    if (ch9120_reset(&gs_handle) != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    a_bench_add("reset", "ms", (double)(ch9120_interface_timestamp_us() - start) / 1000.0, 1, 1);
+    
+    return ch9120_deinit(&gs_handle);
+}
+
+/**
+ * @brief  bench the handle layout
+ * @note   the hot span ends with the inited flag, the last data path field
+ */
+static void a_bench_layout(void)
+{
+    a_bench_add("handle_size", "B", (double)sizeof(ch9120_handle_t), 1, 1);
+    a_bench_add("handle_hot_span", "B", (double)(offsetof(ch9120_handle_t, inited) + sizeof(uint8_t)), 1, 1);
+}
+
+/**
+ * @brief     bench write the results
+ * @param[in] *path pointer to a file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_bench_write(const char *path)
+{
+    FILE *fp;
+    uint8_t i;
+    
+    fp = fopen(path, "w");
+    if (fp == NULL)
+    {
+        ch9120_interface_debug_print("bench: open %s failed.\n", path);
+        
+        return 1;
+    }
+    (void)fprintf(fp, "{\n  \"metrics\": [\n");
+    for (i = 0; i < gs_metric_num; i++)
+    {
+        (void)fprintf(fp, "    {\"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\", \"better\": \"%s\", \"compare\": %s}%s\n",
+                      gs_metric[i].name, gs_metric[i].value, gs_metric[i].unit,
+                      (gs_metric[i].lower != 0) ? "lower" : "higher",
+                      (gs_metric[i].compare != 0) ? "true" : "false",
+                      (i + 1 < gs_metric_num) ? "," : "");
+    }
+    (void)fprintf(fp, "  ]\n}\n");
+    (void)fclose(fp);
+    
+    return 0;
+}
+
+/**
+ * @brief      bench find a metric value in a result file
+ * @param[in]  *json pointer to the file content
+ * @param[in]  *name pointer to a metric name
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 not found
+ * @note       only the format written by a_bench_write is supported
+ */
+static uint8_t a_bench_find(const char *json, const char *name, double *value)
+{
+    char key[64];
+    const char *p;
+    
+    (void)snprintf(key, 63, "\"name\": \"%s\"", name);
+    p = strstr(json, key);
+    if (p == NULL)
+    {
+        return 1;
+    }
+    p = strstr(p, "\"value\":");
+    if (p == NULL)
+    {
+        return 1;
+    }
+    *value = strtod(p + strlen("\"value\":"), NULL);
+    
+    return 0;
+}
+
+/**
+ * @brief     bench compare the results with a baseline
+ * @param[in] *path pointer to a baseline path
+ * @param[in] threshold allowed regression in percent
+ * @return    status code
+ *            - 0 success
+ *            - 1 regressed
+ * @note      improvements never fail, update the baseline to keep them
+ */
+static uint8_t a_bench_compare(const char *path, double threshold)
+{
+    FILE *fp;
+    char *json;
+    long size;
+    uint8_t i;
+    uint8_t res;
+    
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        ch9120_interface_debug_print("bench: open %s failed.\n", path);
+        
+        return 1;
+    }
+    (void)fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    (void)fseek(fp, 0, SEEK_SET);
+    json = (char *)calloc((size > 0) ? (size_t)size + 1 : 1, 1);
+    if (json == NULL)
+    {
+        (void)fclose(fp);
+        
+        return 1;
+    }
+    if ((size > 0) && (fread(json, 1, (size_t)size, fp) != (size_t)size))
+    {
+        free(json);
+        (void)fclose(fp);
+        
+        return 1;
+    }
+    (void)fclose(fp);
+    
+    res = 0;
+    for (i = 0; i < gs_metric_num; i++)
+    {
+        double base;
+        double change;
+        
+        if (gs_metric[i].compare == 0)
+        {
+            continue;
+        }
+        if (a_bench_find(json, gs_metric[i].name, &base) != 0)
+        {
+            ch9120_interface_debug_print("bench: %s has no baseline.\n", gs_metric[i].name);
+            
+            continue;
+        }
+        if (base == 0.0)
+        {
+            change = (gs_metric[i].value == 0.0) ? 0.0 : 100.0;
+        }
+        else
+        {
+            change = (gs_metric[i].value - base) * 100.0 / base;
+        }
+        if (gs_metric[i].lower == 0)
+        {
+            change = -change;
+        }
+        if (change > threshold)
+        {
+            ch9120_interface_debug_print("bench: %s regressed %.1f%%, %.3f %s vs baseline %.3f %s.\n",
+                                         gs_metric[i].name, change, gs_metric[i].value, gs_metric[i].unit,
+                                         base, gs_metric[i].unit);
+            res = 1;
+        }
+        else
+        {
+            ch9120_interface_debug_print("bench: %s %+.1f%% ok.\n", gs_metric[i].name, change);
+        }
+    }
+    free(json);
+    
+    return res;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *             - 0 success
+ *             - 1 run failed or regressed
+ *             - 5 param is invalid
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    int c;
+    int longindex = 0;
+    const char short_options[] = "h";
+    const struct option long_options[] =
+    {
+        {"help", no_argument, NULL, 'h'},
+        {"output", required_argument, NULL, 1},
+        {"baseline", required_argument, NULL, 2},
+        {"threshold", required_argument, NULL, 3},
+        {NULL, 0, NULL, 0},
+    };
+    char output[257] = "ch9120_bench.json";
+    char baseline[257] = "";
+    double threshold = 10.0;
+    
+    /* parse */
+    do
+    {
+        /* parse the args */
+        c = getopt_long(argc, argv, short_options, long_options, &longindex);
+        
+        /* judge the result */
+        switch (c)
+        {
+            /* help */
+            case 'h' :
+            {
+                ch9120_interface_debug_print("Usage:\n");
+                ch9120_interface_debug_print("  ch9120_bench [--output=<path>] [--baseline=<path>] [--threshold=<percent>]\n");
+                ch9120_interface_debug_print("\n");
+                ch9120_interface_debug_print("Options:\n");
+                ch9120_interface_debug_print("      --baseline=<path>      Compare with a baseline result file.\n");
+                ch9120_interface_debug_print("  -h, --help                 Show the help.\n");
+                ch9120_interface_debug_print("      --output=<path>        Set the result file.([default: ch9120_bench.json])\n");
+                ch9120_interface_debug_print("      --threshold=<percent>  Set the allowed regression.([default: 10])\n");
+                
+                return 0;
+            }
+            
+            /* output */
+            case 1 :
+            {
+                memset(output, 0, sizeof(char) * 257);
+                strncpy(output, optarg, 256);
+                
+                break;
+            }
+            
+            /* baseline */
+            case 2 :
+            {
+                memset(baseline, 0, sizeof(char) * 257);
+                strncpy(baseline, optarg, 256);
+                
+                break;
+            }
+            
+            /* threshold */
+            case 3 :
+            {
+                threshold = atof(optarg);
+                
+                break;
+            }
+            
+            /* the end */
+            case -1 :
+            {
+                break;
+            }
+            
+            /* others */
+            default :
+            {
+                return 5;
+            }
+        }
+    } while (c != -1);
+    
+    /* run the benches */
+    a_bench_layout();
+    if (a_bench_provision() != 0)
+    {
+        ch9120_interface_debug_print("bench: provision bench failed.\n");
+        
+        return 1;
+    }
+    if (a_bench_command() != 0)
+    {
+        ch9120_interface_debug_print("bench: command bench failed.\n");
+        
+        return 1;
+    }
+    
+    /* write the results */
+    if (a_bench_write(output) != 0)
+    {
+        return 1;
+    }
+    
+    /* compare with the baseline */
+    if ((baseline[0] != '\0') && (a_bench_compare(baseline, threshold) != 0))
+    {
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,425 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      main.c
+ * @brief     main source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_register_test.h"
+#include "driver_ch9120_net_test.h"
+#include "driver_ch9120_fault_test.h"
+#include "driver_ch9120_monitor_test.h"
+#include "driver_ch9120_client_test.h"
+#include "driver_ch9120_frame_test.h"
+#include "emulator.h"
+#include <getopt.h>
+#include <stdlib.h>
+
+/**
+ * @brief     net test with the emulated network peer
+ * @param[in] mode chip mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      servers get data from the peer and clients must deliver data to the peer
+ */
+static uint8_t a_net_test(ch9120_mode_t mode)
+{
+    char str[] = "LibDriver";
+    uint8_t buf[64];
+    uint16_t l;
+    
+    /* the peer sends data after the chip is configured */
+    if ((mode == CH9120_MODE_TCP_SERVER) || (mode == CH9120_MODE_UDP_SERVER))
+    {
+        if (emulator_peer_write((uint8_t *)str, (uint16_t)strlen(str), 5000) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* run net test */
+    if (ch9120_net_test(mode, 10000) != 0)
+    {
+        return 1;
+    }
+    
+    /* check the peer */
+    if ((mode == CH9120_MODE_TCP_CLIENT) || (mode == CH9120_MODE_UDP_CLIENT))
+    {
+        memset(buf, 0, sizeof(uint8_t) * 64);
+        l = emulator_peer_read(buf, 63);
+        if ((l < strlen(str)) || (memcmp(buf, str, strlen(str)) != 0))
+        {
+            ch9120_interface_debug_print("ch9120: peer received %d bytes.\n", l);
+            
+            return 1;
+        }
+        ch9120_interface_debug_print("ch9120: peer received %s.\n", (char *)buf);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  client test with a failover and a cable outage
+ * @return status code
+ *         - 0 success
+ *         - 1 run failed
+ * @note   only the second dest accepts the session, records written before a drop
+ *         is seen may be lost, the others must arrive in order
+ */
+static uint8_t a_client_test(void)
+{
+    ch9120_client_dest_t dest[2] =
+    {
+        {{192, 168, 1, 100}, 1000},
+        {{192, 168, 1, 101}, 1001},
+    };
+    uint8_t buf[8];
+    uint32_t received;
+    int last;
+    int n;
+    
+    /* the primary is down and the cable is pulled from 15s to 18s */
+    emulator_set_peer(dest[1].ip, dest[1].port);
+    if ((emulator_set_link(0, 15000) != 0) || (emulator_set_link(1, 18000) != 0))
+    {
+        return 1;
+    }
+    
+    /* run client test */
+    if (ch9120_client_test(dest, 2, 25) != 0)
+    {
+        return 1;
+    }
+    
+    /* check the records */
+    received = 0;
+    last = -1;
+    while (emulator_peer_read(buf, 7) == 7)
+    {
+        buf[7] = 0;
+        n = atoi((char *)buf);
+        if (n <= last)
+        {
+            ch9120_interface_debug_print("ch9120: record %d after %d.\n", n, last);
+            
+            return 1;
+        }
+        last = n;
+        received++;
+    }
+    ch9120_interface_debug_print("ch9120: peer received %d records, the last is %d.\n", received, last);
+    if (last != 249)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     ch9120 full function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 5 param is invalid
+ * @note      none
+ */
+uint8_t ch9120(uint8_t argc, char **argv)
+{
+    int c;
+    int longindex = 0;
+    const char short_options[] = "hit:";
+    const struct option long_options[] =
+    {
+        {"help", no_argument, NULL, 'h'},
+        {"information", no_argument, NULL, 'i'},
+        {"test", required_argument, NULL, 't'},
+        {"mode", required_argument, NULL, 1},
+        {NULL, 0, NULL, 0},
+    };
+    char type[33] = "unknown";
+    ch9120_mode_t mode = CH9120_MODE_TCP_CLIENT;
+    
+    /* if no params */
+    if (argc == 1)
+    {
+        /* goto the help */
+        goto help;
+    }
+    
+    /* init 0 */
+    optind = 0;
+    
+    /* parse */
+    do
+    {
+        /* parse the args */
+        c = getopt_long(argc, argv, short_options, long_options, &longindex);
+        
+        /* judge the result */
+        switch (c)
+        {
+            /* help */
+            case 'h' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "h");
+                
+                break;
+            }
+            
+            /* information */
+            case 'i' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "i");
+                
+                break;
+            }
+            
+            /* test */
+            case 't' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "t_%s", optarg);
+                
+                break;
+            }
+            
+            /* mode */
+            case 1 :
+            {
+                /* set the mode */
+                if (strcmp("TCP_SERVER", optarg) == 0)
+                {
+                    mode = CH9120_MODE_TCP_SERVER;
+                }
+                else if (strcmp("TCP_CLIENT", optarg) == 0)
+                {
+                    mode = CH9120_MODE_TCP_CLIENT;
+                }
+                else if (strcmp("UDP_SERVER", optarg) == 0)
+                {
+                    mode = CH9120_MODE_UDP_SERVER;
+                }
+                else if (strcmp("UDP_CLIENT", optarg) == 0)
+                {
+                    mode = CH9120_MODE_UDP_CLIENT;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* the end */
+            case -1 :
+            {
+                break;
+            }
+            
+            /* others */
+            default :
+            {
+                return 5;
+            }
+        }
+    } while (c != -1);
+    
+    /* power on the emulated chip */
+    emulator_init();
+    
+    /* run the function */
+    if (strcmp("t_reg", type) == 0)
+    {
+        /* run reg test */
+        if (ch9120_register_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_fault", type) == 0)
+    {
+        /* run fault test */
+        if (ch9120_fault_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_monitor", type) == 0)
+    {
+        /* the cable is pulled at 3s and plugged again at 6s */
+        if ((emulator_set_link(0, 3000) != 0) || (emulator_set_link(1, 6000) != 0))
+        {
+            return 1;
+        }
+        
+        /* the peer sends data right after the 10s run */
+        if (emulator_peer_write((uint8_t *)"LibDriver", 9, 12000) != 0)
+        {
+            return 1;
+        }
+        
+        /* run monitor test */
+        if (ch9120_monitor_test(10) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_client", type) == 0)
+    {
+        /* run client test */
+        if (a_client_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_frame", type) == 0)
+    {
+        /* the peer sends every byte back */
+        emulator_set_echo(1);
+        
+        /* run frame test */
+        if (ch9120_frame_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_net", type) == 0)
+    {
+        /* run net test */
+        if (a_net_test(mode) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("h", type) == 0)
+    {
+        help:
+        ch9120_interface_debug_print("Usage:\n");
+        ch9120_interface_debug_print("  ch9120 (-i | --information)\n");
+        ch9120_interface_debug_print("  ch9120 (-h | --help)\n");
+        ch9120_interface_debug_print("  ch9120 (-t reg | --test=reg)\n");
+        ch9120_interface_debug_print("  ch9120 (-t fault | --test=fault)\n");
+        ch9120_interface_debug_print("  ch9120 (-t monitor | --test=monitor)\n");
+        ch9120_interface_debug_print("  ch9120 (-t client | --test=client)\n");
+        ch9120_interface_debug_print("  ch9120 (-t frame | --test=frame)\n");
+        ch9120_interface_debug_print("  ch9120 (-t net | --test=net) [--mode=<TCP_CLIENT | TCP_SERVER | UDP_CLIENT | UDP_SERVER>]\n");
+        ch9120_interface_debug_print("\n");
+        ch9120_interface_debug_print("Options:\n");
+        ch9120_interface_debug_print("  -h, --help                 Show the help.\n");
+        ch9120_interface_debug_print("  -i, --information          Show the chip information.\n");
+        ch9120_interface_debug_print("      --mode=<TCP_CLIENT | TCP_SERVER | UDP_CLIENT | UDP_SERVER\n");
+        ch9120_interface_debug_print("                             Set the chip mode.([default: TCP_CLIENT])\n");
+        ch9120_interface_debug_print("  -t <reg | fault | monitor | client | frame | net>, --test=<reg | fault | monitor | client | frame | net>\n");
+        ch9120_interface_debug_print("                             Run the driver test against the emulated chip.\n");
+        
+        return 0;
+    }
+    else if (strcmp("i", type) == 0)
+    {
+        ch9120_info_t info;
+        
+        /* print ch9120 info */
+        ch9120_info(&info);
+        ch9120_interface_debug_print("ch9120: chip is %s.\n", info.chip_name);
+        ch9120_interface_debug_print("ch9120: manufacturer is %s.\n", info.manufacturer_name);
+        ch9120_interface_debug_print("ch9120: interface is %s.\n", info.interface);
+        ch9120_interface_debug_print("ch9120: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        ch9120_interface_debug_print("ch9120: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        ch9120_interface_debug_print("ch9120: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        ch9120_interface_debug_print("ch9120: max current is %0.2fmA.\n", info.max_current_ma);
+        ch9120_interface_debug_print("ch9120: max temperature is %0.1fC.\n", info.temperature_max);
+        ch9120_interface_debug_print("ch9120: min temperature is %0.1fC.\n", info.temperature_min);
+        
+        return 0;
+    }
+    else
+    {
+        return 5;
+    }
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *             - 0 success
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    uint8_t res;
+    
+    res = ch9120((uint8_t)argc, argv);
+    if (res == 0)
+    {
+        /* run success */
+    }
+    else if (res == 1)
+    {
+        ch9120_interface_debug_print("ch9120: run failed.\n");
+    }
+    else if (res == 5)
+    {
+        ch9120_interface_debug_print("ch9120: param is invalid.\n");
+    }
+    else
+    {
+        ch9120_interface_debug_print("ch9120: unknown status code.\n");
+    }
+    
+    return res;
+}
@@ -0,0 +1,904 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_ch9120_coroutine.hpp
+ * @brief     driver ch9120 coroutine header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_CH9120_COROUTINE_HPP
+#define DRIVER_CH9120_COROUTINE_HPP
+
+#include "driver_ch9120.h"
+#include <array>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <coroutine>
+#include <ctime>
+#include <exception>
+#include <fcntl.h>
+#include <functional>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @defgroup ch9120_coroutine_driver ch9120 coroutine driver function
+ * @brief    ch9120 coroutine driver modules
+ * @ingroup  ch9120_driver
+ * @{
+ */
+
+/**
+ * @brief ch9120 coroutine max device definition
+ */
+#ifndef CH9120_CO_MAX_DEVICES
+    #define CH9120_CO_MAX_DEVICES    64        /**< 64 devices */
+#endif
+
+namespace ch9120
+{
+namespace co
+{
+
+class loop;
+
+/**
+ * @brief  get the monotonic time in ms
+ * @return time in ms
+ * @note   none
+ */
+inline uint32_t now_ms(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL);
+}
+
+/**
+ * @brief ch9120 coroutine task class definition
+ * @note  a lazy coroutine returning a driver status code, co_await it or hand it to loop::spawn
+ */
+class task
+{
+    public:
+        struct promise_type;
+        using handle_t = std::coroutine_handle<promise_type>;
+
+        /**
+         * @brief ch9120 coroutine task promise structure definition
+         */
+        struct promise_type
+        {
+            uint8_t value = 0;                        /**< status code */
+            std::coroutine_handle<> next;             /**< awaiting coroutine */
+            loop *owner = nullptr;                    /**< loop of a spawned task */
+
+            /**
+             * @brief ch9120 coroutine task final awaiter structure definition
+             */
+            struct final_awaiter
+            {
+                bool await_ready(void) noexcept { return false; }
+                std::coroutine_handle<> await_suspend(handle_t h) noexcept;
+                void await_resume(void) noexcept {}
+            };
+
+            task get_return_object(void) noexcept { return task(handle_t::from_promise(*this)); }
+            std::suspend_always initial_suspend(void) noexcept { return {}; }
+            final_awaiter final_suspend(void) noexcept { return {}; }
+            void return_value(uint8_t v) noexcept { value = v; }
+            void unhandled_exception(void) noexcept { std::terminate(); }
+        };
+
+        task(task &&t) noexcept : m_h(std::exchange(t.m_h, nullptr)) {}
+        task(const task &) = delete;
+        task &operator=(const task &) = delete;
+        ~task() { if (m_h) { m_h.destroy(); } }
+
+        bool await_ready(void) const noexcept { return !m_h || m_h.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept
+        {
+            m_h.promise().next = c;
+
+            return m_h;
+        }
+        uint8_t await_resume(void) const noexcept { return m_h ? m_h.promise().value : 1; }
+
+        /**
+         * @brief  release the coroutine frame
+         * @return coroutine handle
+         * @note   none
+         */
+        handle_t release(void) noexcept { return std::exchange(m_h, nullptr); }
+
+    private:
+        explicit task(handle_t h) noexcept : m_h(h) {}
+        handle_t m_h;
+};
+
+/**
+ * @brief ch9120 coroutine loop class definition
+ * @note  a single thread epoll loop, it can also be driven from another event loop
+ *        by watching native_handle() and calling run_once(0) when it is readable
+ */
+class loop
+{
+    public:
+        /**
+         * @brief ch9120 coroutine wait structure definition
+         */
+        struct wait
+        {
+            loop *l;                                  /**< loop */
+            int fd;                                   /**< fd, -1 for a timer */
+            uint32_t deadline_ms;                     /**< deadline */
+            bool readable;                            /**< readable flag */
+            std::coroutine_handle<> h;                /**< waiting coroutine */
+
+            bool await_ready(void) const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> c) { h = c; l->a_add(this); }
+            bool await_resume(void) const noexcept { return readable; }
+        };
+
+        loop() : m_epfd(epoll_create1(EPOLL_CLOEXEC)), m_live(0) {}
+        loop(const loop &) = delete;
+        loop &operator=(const loop &) = delete;
+        ~loop() { if (m_epfd >= 0) { (void)close(m_epfd); } }
+
+        /**
+         * @brief  get the epoll fd
+         * @return epoll fd, readable when run_once has work
+         * @note   none
+         */
+        int native_handle(void) const noexcept { return m_epfd; }
+
+        /**
+         * @brief     wait until the fd is readable or the timeout
+         * @param[in] fd waited fd
+         * @param[in] timeout_ms timeout in ms
+         * @return    awaiter, co_await returns true if readable
+         * @note      any number of waiters can share one fd, they all wake when it is readable
+         */
+        wait readable(int fd, uint32_t timeout_ms) { return wait{this, fd, now_ms() + timeout_ms, false, nullptr}; }
+
+        /**
+         * @brief     sleep
+         * @param[in] ms time in ms
+         * @return    awaiter
+         * @note      none
+         */
+        wait sleep(uint32_t ms) { return wait{this, -1, now_ms() + ms, false, nullptr}; }
+
+        /**
+         * @brief     start a task and keep it until it finishes
+         * @param[in] &&t task
+         * @note      none
+         */
+        void spawn(task &&t)
+        {
+            task::handle_t h = t.release();
+
+            if (h)
+            {
+                h.promise().owner = this;
+                m_live++;
+                h.resume();
+            }
+        }
+
+        /**
+         * @brief     run the loop once
+         * @param[in] timeout_ms max wait in ms, -1 waits for the next deadline
+         * @return    number of running tasks
+         * @note      none
+         */
+        size_t run_once(int timeout_ms)
+        {
+            std::array<struct epoll_event, 64> ev;
+            std::vector<wait *> ready;
+            uint32_t now;
+            int n;
+
+            now = now_ms();
+            for (wait *w : m_wait)
+            {
+                int32_t left = (int32_t)(w->deadline_ms - now);
+
+                left = (left < 0) ? 0 : left;
+                timeout_ms = ((timeout_ms < 0) || (left < timeout_ms)) ? left : timeout_ms;
+            }
+            if (m_wait.empty() && (timeout_ms < 0))
+            {
+                return m_live;
+            }
+            n = epoll_wait(m_epfd, ev.data(), (int)ev.size(), timeout_ms);
+            for (int i = 0; i < n; i++)
+            {
+                for (wait *w : m_wait)
+                {
+                    if (w->fd == ev[i].data.fd)
+                    {
+                        w->readable = true;
+                    }
+                }
+            }
+            now = now_ms();
+            for (size_t i = 0; i < m_wait.size(); )
+            {
+                wait *w = m_wait[i];
+
+                if (w->readable || ((int32_t)(now - w->deadline_ms) >= 0))
+                {
+                    ready.push_back(w);
+                    m_wait[i] = m_wait.back();
+                    m_wait.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            for (wait *w : ready)
+            {
+                if ((w->fd >= 0) && !a_watched(w->fd))
+                {
+                    (void)epoll_ctl(m_epfd, EPOLL_CTL_DEL, w->fd, nullptr);
+                }
+            }
+            for (wait *w : ready)
+            {
+                w->h.resume();
+            }
+
+            return m_live;
+        }
+
+        /**
+         * @brief run until every spawned task has finished
+         * @note  none
+         */
+        void run(void)
+        {
+            while ((m_live != 0) && !m_wait.empty())
+            {
+                (void)run_once(-1);
+            }
+        }
+
+    private:
+        friend struct task::promise_type::final_awaiter;
+
+        bool a_watched(int fd) const
+        {
+            for (const wait *w : m_wait)
+            {
+                if (w->fd == fd)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void a_add(wait *w)
+        {
+            if ((w->fd >= 0) && !a_watched(w->fd))
+            {
+                struct epoll_event ev;
+
+                ev.events = EPOLLIN;
+                ev.data.fd = w->fd;
+                if ((epoll_ctl(m_epfd, EPOLL_CTL_ADD, w->fd, &ev) != 0) && (errno != EEXIST))
+                {
+                    w->readable = true;
+                    w->deadline_ms = now_ms();
+                }
+            }
+            m_wait.push_back(w);
+        }
+
+        int m_epfd;
+        size_t m_live;
+        std::vector<wait *> m_wait;
+};
+
+inline std::coroutine_handle<> task::promise_type::final_awaiter::await_suspend(handle_t h) noexcept
+{
+    promise_type &p = h.promise();
+
+    if (p.next)
+    {
+        return p.next;
+    }
+    if (p.owner != nullptr)
+    {
+        p.owner->m_live--;
+        h.destroy();
+    }
+
+    return std::noop_coroutine();
+}
+
+/**
+ * @brief ch9120 coroutine device config structure definition
+ */
+struct config
+{
+    config(const char *path = nullptr, uint32_t rate = 9600) : tty(path), baud(rate) {}
+
+    const char *tty;                                   /**< tty path */
+    uint32_t baud;                                     /**< uart baud */
+    std::function<uint8_t(uint8_t)> reset_gpio;        /**< reset pin write, empty if hardwired */
+    std::function<uint8_t(uint8_t)> cfg_gpio;          /**< cfg pin write, empty if hardwired */
+};
+
+class device;
+
+/**
+ * @brief ch9120 coroutine device slot definition
+ * @note  the driver hooks take no context, every device owns one slot of generated hooks
+ */
+inline device *g_slot[CH9120_CO_MAX_DEVICES];
+
+/**
+ * @brief ch9120 coroutine device class definition
+ * @note  one operation per device at a time, any number of devices per loop
+ */
+class device
+{
+    public:
+        device(loop &l, config c) : m_loop(l), m_config(std::move(c)), m_fd(-1), m_slot(CH9120_CO_MAX_DEVICES), m_busy(false)
+        {
+            memset(&m_handle, 0, sizeof(ch9120_handle_t));
+        }
+        device(const device &) = delete;
+        device &operator=(const device &) = delete;
+        ~device() { (void)deinit(); }
+
+        /**
+         * @brief  get the driver handle
+         * @return pointer to a ch9120 handle structure
+         * @note   none
+         */
+        ch9120_handle_t *handle(void) noexcept { return &m_handle; }
+
+        /**
+         * @brief  get the tty fd
+         * @return fd
+         * @note   none
+         */
+        int fd(void) const noexcept { return m_fd; }
+
+        /**
+         * @brief  init the device
+         * @return status code
+         *         - 0 success
+         *         - 1 init failed
+         *         - 4 no free slot
+         * @note   blocks for the reset pulse and the boot wait, run it before the loop
+         */
+        uint8_t init(void);
+
+        /**
+         * @brief  deinit the device
+         * @return status code
+         *         - 0 success
+         *         - 1 deinit failed
+         * @note   none
+         */
+        uint8_t deinit(void)
+        {
+            uint8_t res;
+
+            if (m_slot == CH9120_CO_MAX_DEVICES)
+            {
+                return 0;
+            }
+            res = ch9120_deinit(&m_handle);
+            g_slot[m_slot] = nullptr;
+            m_slot = CH9120_CO_MAX_DEVICES;
+
+            return (res != 0) ? 1 : 0;
+        }
+
+        /**
+         * @brief     run a command
+         * @param[in] *param pointer to a param buffer
+         * @param[in] len param length
+         * @param[in] *out pointer to an out buffer, NULL expects the 0xAA answer
+         * @param[in] out_len output length
+         * @param[in] pre_delay delay in ms
+         * @param[in] timeout timeout in ms
+         * @return    task, co_await returns
+         *            - 0 success
+         *            - 1 command failed
+         *            - 4 device is busy
+         * @note      the uart is only waited on with the loop, the thread never blocks
+         */
+        task command(const uint8_t *param, uint16_t len, uint8_t *out, uint16_t out_len, uint16_t pre_delay, uint16_t timeout)
+        {
+            uint16_t token;
+
+            if (m_busy)
+            {
+                co_return 4;
+            }
+            if (ch9120_async_command(&m_handle, const_cast<uint8_t *>(param), len,
+                                     out, out_len, pre_delay, timeout, &token) != 0)
+            {
+                co_return 1;
+            }
+            m_busy = true;
+
+            co_return co_await a_wait(token);
+        }
+
+        /**
+         * @brief      run a command from the command table
+         * @param[in]  id command id
+         * @param[in]  *in pointer to a payload buffer
+         * @param[out] *out pointer to a response buffer
+         * @return     task, co_await returns
+         *             - 0 success
+         *             - 1 command failed
+         *             - 4 device is busy
+         * @note       in and out are in the wire order like ch9120_exec,
+         *             reset and config and reset block and only run with ch9120_exec
+         */
+        task exec(ch9120_command_t id, const uint8_t *in, uint8_t *out)
+        {
+            uint16_t token;
+
+            if (m_busy)
+            {
+                co_return 4;
+            }
+            if (ch9120_async_exec(&m_handle, id, const_cast<uint8_t *>(in), out, &token) != 0)
+            {
+                co_return 1;
+            }
+            m_busy = true;
+
+            co_return co_await a_wait(token);
+        }
+
+        /**
+         * @brief      get the chip version
+         * @param[out] *version pointer to a version buffer
+         * @return     task, co_await returns a status code like command
+         * @note       none
+         */
+        task get_version(uint8_t *version)
+        {
+            return exec(CH9120_COMMAND_GET_VERSION, nullptr, version);
+        }
+
+        /**
+         * @brief      get the link status
+         * @param[out] *status pointer to a status buffer
+         * @return     task, co_await returns a status code like command
+         * @note       none
+         */
+        task get_status(ch9120_status_t *status)
+        {
+            uint8_t param = 0;
+            uint8_t res;
+
+            res = co_await exec(CH9120_COMMAND_GET_STATUS, nullptr, &param);
+            *status = (ch9120_status_t)(param);
+
+            co_return res;
+        }
+
+        /**
+         * @brief     set the dest ip
+         * @param[in] *ip pointer to an ip buffer
+         * @return    task, co_await returns a status code like command
+         * @note      none
+         */
+        task set_dest_ip(const uint8_t ip[4])
+        {
+            const uint8_t buf[4] = {ip[0], ip[1], ip[2], ip[3]};
+
+            co_return co_await exec(CH9120_COMMAND_SET_DEST_IP, buf, nullptr);
+        }
+
+        /**
+         * @brief      get the dest ip
+         * @param[out] *ip pointer to an ip buffer
+         * @return     task, co_await returns a status code like command
+         * @note       none
+         */
+        task get_dest_ip(uint8_t ip[4])
+        {
+            return exec(CH9120_COMMAND_GET_DEST_IP, nullptr, ip);
+        }
+
+        /**
+         * @brief     set the dest port
+         * @param[in] num dest port
+         * @return    task, co_await returns a status code like command
+         * @note      none
+         */
+        task set_dest_port(uint16_t num)
+        {
+            const uint8_t buf[2] = {(uint8_t)((num >> 0) & 0xFF), (uint8_t)((num >> 8) & 0xFF)};
+
+            co_return co_await exec(CH9120_COMMAND_SET_DEST_PORT, buf, nullptr);
+        }
+
+        /**
+         * @brief      get the dest port
+         * @param[out] *num pointer to a dest port buffer
+         * @return     task, co_await returns a status code like command
+         * @note       none
+         */
+        task get_dest_port(uint16_t *num)
+        {
+            uint8_t buf[2] = {0, 0};
+            uint8_t res;
+
+            res = co_await exec(CH9120_COMMAND_GET_DEST_PORT, nullptr, buf);
+            *num = (uint16_t)((uint16_t)buf[1] << 8 | buf[0]);
+
+            co_return res;
+        }
+
+        /**
+         * @brief  save the config to the eeprom
+         * @return task, co_await returns a status code like command
+         * @note   none
+         */
+        task save(void)
+        {
+            return exec(CH9120_COMMAND_SAVE_TO_EEPROM, nullptr, nullptr);
+        }
+
+        /**
+         * @brief         read network data
+         * @param[out]    *buf pointer to a data buffer
+         * @param[in,out] *len pointer to a length buffer
+         * @param[in]     timeout_ms timeout in ms
+         * @return        task, co_await returns
+         *                - 0 success, len is 0 on timeout
+         *                - 1 read failed
+         *                - 4 device is busy
+         * @note          none
+         */
+        task read(uint8_t *buf, uint16_t *len, uint32_t timeout_ms)
+        {
+            uint8_t res;
+
+            if (m_busy)
+            {
+                co_return 4;
+            }
+            m_busy = true;
+            (void)co_await m_loop.readable(m_fd, timeout_ms);
+            res = ch9120_read(&m_handle, buf, len);
+            m_busy = false;
+
+            co_return (res != 0) ? 1 : 0;
+        }
+
+        /**
+         * @brief     write network data
+         * @param[in] *buf pointer to a data buffer
+         * @param[in] len data length
+         * @return    task, co_await returns
+         *            - 0 success
+         *            - 1 write failed
+         *            - 4 device is busy
+         * @note      the data is queued in the tty buffer
+         */
+        task write(uint8_t *buf, uint16_t len)
+        {
+            if (m_busy)
+            {
+                co_return 4;
+            }
+
+            co_return (ch9120_write(&m_handle, buf, len) != 0) ? 1 : 0;
+        }
+
+    private:
+        template <size_t I> friend struct hook;
+
+        task a_wait(uint16_t token)
+        {
+            ch9120_async_status_t status = CH9120_ASYNC_STATUS_BUSY;
+
+            while (status == CH9120_ASYNC_STATUS_BUSY)
+            {
+                uint32_t now = now_ms();
+
+                (void)ch9120_poll(&m_handle, now);
+                (void)ch9120_async_get_status(&m_handle, token, &status);
+                if (status != CH9120_ASYNC_STATUS_BUSY)
+                {
+                    break;
+                }
+                if ((int32_t)(now - m_handle.async_ready_ms) < 0)
+                {
+                    (void)co_await m_loop.sleep(m_handle.async_ready_ms - now);
+                }
+                else
+                {
+                    (void)co_await m_loop.readable(m_fd, m_handle.async_deadline_ms - now);
+                }
+            }
+            m_busy = false;
+
+            co_return (status == CH9120_ASYNC_STATUS_OK) ? 0 : 1;
+        }
+
+        uint8_t a_uart_init(void)
+        {
+            struct termios tio;
+            speed_t speed;
+
+            switch (m_config.baud)
+            {
+                case 1200 : speed = B1200; break;
+                case 2400 : speed = B2400; break;
+                case 4800 : speed = B4800; break;
+                case 19200 : speed = B19200; break;
+                case 38400 : speed = B38400; break;
+                case 57600 : speed = B57600; break;
+                case 115200 : speed = B115200; break;
+                case 230400 : speed = B230400; break;
+                case 460800 : speed = B460800; break;
+                case 921600 : speed = B921600; break;
+                default : speed = B9600; break;
+            }
+            m_fd = open(m_config.tty, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+            if (m_fd < 0)
+            {
+                return 1;
+            }
+            if (tcgetattr(m_fd, &tio) == 0)
+            {
+                cfmakeraw(&tio);
+                tio.c_cflag |= CLOCAL | CREAD;
+                tio.c_cc[VMIN] = 0;
+                tio.c_cc[VTIME] = 0;
+                (void)cfsetispeed(&tio, speed);
+                (void)cfsetospeed(&tio, speed);
+                (void)tcsetattr(m_fd, TCSANOW, &tio);
+            }
+
+            return 0;
+        }
+
+        uint8_t a_uart_deinit(void)
+        {
+            int fd = std::exchange(m_fd, -1);
+
+            return ((fd >= 0) && (close(fd) != 0)) ? 1 : 0;
+        }
+
+        uint16_t a_uart_read(uint8_t *buf, uint16_t len)
+        {
+            ssize_t l = ::read(m_fd, buf, len);
+
+            return (l > 0) ? (uint16_t)l : 0;
+        }
+
+        uint8_t a_uart_write(uint8_t *buf, uint16_t len)
+        {
+            while (len != 0)
+            {
+                ssize_t l = ::write(m_fd, buf, len);
+
+                if (l > 0)
+                {
+                    buf += l;
+                    len -= (uint16_t)l;
+                }
+                else if ((l < 0) && (errno == EAGAIN))
+                {
+                    struct pollfd p = {m_fd, POLLOUT, 0};
+
+                    if (::poll(&p, 1, 1000) <= 0)
+                    {
+                        return 1;
+                    }
+                }
+                else if ((l < 0) && (errno != EINTR))
+                {
+                    return 1;
+                }
+            }
+
+            return 0;
+        }
+
+        uint8_t a_uart_flush(void) { return (tcflush(m_fd, TCIOFLUSH) != 0) ? 1 : 0; }
+        uint8_t a_reset_gpio_write(uint8_t data) { return m_config.reset_gpio ? m_config.reset_gpio(data) : 0; }
+        uint8_t a_cfg_gpio_write(uint8_t data) { return m_config.cfg_gpio ? m_config.cfg_gpio(data) : 0; }
+
+        loop &m_loop;
+        config m_config;
+        int m_fd;
+        size_t m_slot;
+        bool m_busy;
+        ch9120_handle_t m_handle;
+};
+
+/**
+ * @brief ch9120 coroutine hook structure definition
+ * @note  the hooks of slot I forward to the device in g_slot[I]
+ */
+template <size_t I>
+struct hook
+{
+    static uint8_t uart_init(void) { return g_slot[I]->a_uart_init(); }
+    static uint8_t uart_deinit(void) { return g_slot[I]->a_uart_deinit(); }
+    static uint16_t uart_read(uint8_t *buf, uint16_t len) { return g_slot[I]->a_uart_read(buf, len); }
+    static uint8_t uart_write(uint8_t *buf, uint16_t len) { return g_slot[I]->a_uart_write(buf, len); }
+    static uint8_t uart_flush(void) { return g_slot[I]->a_uart_flush(); }
+    static uint8_t reset_gpio_write(uint8_t data) { return g_slot[I]->a_reset_gpio_write(data); }
+    static uint8_t cfg_gpio_write(uint8_t data) { return g_slot[I]->a_cfg_gpio_write(data); }
+};
+
+/**
+ * @brief ch9120 coroutine hook table structure definition
+ */
+struct hook_table
+{
+    uint8_t (*uart_init)(void);                               /**< uart init */
+    uint8_t (*uart_deinit)(void);                             /**< uart deinit */
+    uint16_t (*uart_read)(uint8_t *buf, uint16_t len);        /**< uart read */
+    uint8_t (*uart_write)(uint8_t *buf, uint16_t len);        /**< uart write */
+    uint8_t (*uart_flush)(void);                              /**< uart flush */
+    uint8_t (*reset_gpio_write)(uint8_t data);                /**< reset gpio write */
+    uint8_t (*cfg_gpio_write)(uint8_t data);                  /**< cfg gpio write */
+};
+
+/**
+ * @brief  make the hook table
+ * @return hook table
+ * @note   none
+ */
+template <size_t... I>
+constexpr std::array<hook_table, sizeof...(I)> make_hooks(std::index_sequence<I...>)
+{
+    return {{{&hook<I>::uart_init, &hook<I>::uart_deinit, &hook<I>::uart_read, &hook<I>::uart_write,
+              &hook<I>::uart_flush, &hook<I>::reset_gpio_write, &hook<I>::cfg_gpio_write}...}};
+}
+
+/**
+ * @brief ch9120 coroutine hook table definition
+ */
+inline constexpr std::array<hook_table, CH9120_CO_MAX_DEVICES> g_hook = make_hooks(std::make_index_sequence<CH9120_CO_MAX_DEVICES>{});
+
+/**
+ * @brief a gpio init or deinit hook
+ */
+inline uint8_t a_gpio_none(void) { return 0; }
+
+/**
+ * @brief a delay ms hook
+ */
+inline void a_delay_ms(uint32_t ms)
+{
+    struct timespec ts = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    {
+    }
+}
+
+/**
+ * @brief a debug print hook
+ */
+inline void a_debug_print(const char *const fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    (void)vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+/**
+ * @brief a timestamp us hook
+ */
+inline uint64_t a_timestamp_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+inline uint8_t device::init(void)
+{
+    size_t i;
+
+    for (i = 0; i < CH9120_CO_MAX_DEVICES; i++)
+    {
+        if (g_slot[i] == nullptr)
+        {
+            break;
+        }
+    }
+    if (i == CH9120_CO_MAX_DEVICES)
+    {
+        return 4;
+    }
+    g_slot[i] = this;
+    m_slot = i;
+
+    DRIVER_CH9120_LINK_INIT(&m_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&m_handle, g_hook[i].uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&m_handle, g_hook[i].uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&m_handle, g_hook[i].uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&m_handle, g_hook[i].uart_write);
+    DRIVER_CH9120_LINK_UART_FLUSH(&m_handle, g_hook[i].uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&m_handle, a_gpio_none);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&m_handle, a_gpio_none);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&m_handle, g_hook[i].reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&m_handle, a_gpio_none);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&m_handle, a_gpio_none);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&m_handle, g_hook[i].cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&m_handle, a_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&m_handle, a_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&m_handle, a_timestamp_us);
+    if (ch9120_init(&m_handle) != 0)
+    {
+        g_slot[i] = nullptr;
+        m_slot = CH9120_CO_MAX_DEVICES;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+}
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_iothread.h
+ * @brief     driver ch9120 iothread header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_CH9120_IOTHREAD_H
+#define DRIVER_CH9120_IOTHREAD_H
+
+#include "driver_ch9120.h"
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup ch9120_iothread ch9120 iothread function
+ * @brief    ch9120 iothread modules
+ * @ingroup  ch9120_driver
+ * @{
+ */
+
+/**
+ * @brief ch9120 iothread buffer definition
+ */
+#ifndef CH9120_IOTHREAD_BUF_SIZE
+    #define CH9120_IOTHREAD_BUF_SIZE    512        /**< 512 bytes of one buffer */
+#endif
+#ifndef CH9120_IOTHREAD_BUF_NUM
+    #define CH9120_IOTHREAD_BUF_NUM     32         /**< 32 buffers of one direction, a power of 2 */
+#endif
+
+/**
+ * @brief ch9120 iothread cache line definition
+ */
+#define CH9120_IOTHREAD_CACHE_LINE      64         /**< keeps the producer and the consumer index apart */
+
+/**
+ * @brief ch9120 iothread buffer structure definition
+ */
+typedef struct ch9120_iothread_buf_s
+{
+    uint16_t len;                                  /**< data length */
+    uint8_t buf[CH9120_IOTHREAD_BUF_SIZE];         /**< data */
+} ch9120_iothread_buf_t;
+
+/**
+ * @brief ch9120 iothread queue structure definition
+ */
+typedef struct ch9120_iothread_queue_s
+{
+    uint32_t head __attribute__((aligned(CH9120_IOTHREAD_CACHE_LINE)));            /**< consumer index */
+    uint32_t tail __attribute__((aligned(CH9120_IOTHREAD_CACHE_LINE)));            /**< producer index */
+    ch9120_iothread_buf_t *slot[CH9120_IOTHREAD_BUF_NUM] 
+                          __attribute__((aligned(CH9120_IOTHREAD_CACHE_LINE)));  /**< buffers */
+} ch9120_iothread_queue_t;
+
+/**
+ * @brief ch9120 iothread stats structure definition
+ */
+typedef struct ch9120_iothread_stats_s
+{
+    uint64_t rx_bytes;                             /**< received bytes */
+    uint64_t tx_bytes;                             /**< written bytes */
+    uint64_t rx_dropped;                           /**< received bytes without a free buffer */
+    uint64_t tx_errors;                            /**< failed writes */
+    uint64_t wakeups;                              /**< idle waits */
+} ch9120_iothread_stats_t;
+
+/**
+ * @brief ch9120 iothread structure definition
+ */
+typedef struct ch9120_iothread_s
+{
+    ch9120_handle_t *handle;                       /**< owned handle */
+    pthread_t thread;                              /**< io thread */
+    int rx_fd;                                     /**< eventfd, readable when received data is queued */
+    int tx_fd;                                     /**< eventfd, wakes the io thread */
+    uint32_t idle_us;                              /**< idle wait in us */
+    uint8_t running;                               /**< thread is started */
+    uint8_t stop;                                  /**< stop request */
+    uint8_t sleeping;                              /**< io thread waits on tx_fd */
+    ch9120_iothread_buf_t *rx_spare;               /**< io thread, free buffer of the next read */
+    ch9120_iothread_buf_t *rx_cur;                 /**< application, buffer being read */
+    uint16_t rx_off;                               /**< application, read offset of rx_cur */
+    ch9120_iothread_queue_t rx_queue;              /**< io thread to application, received data */
+    ch9120_iothread_queue_t rx_free;               /**< application to io thread, released buffers */
+    ch9120_iothread_queue_t tx_queue;              /**< application to io thread, data to write */
+    ch9120_iothread_queue_t tx_free;               /**< io thread to application, written buffers */
+    ch9120_iothread_stats_t stats;                 /**< stats written by the io thread */
+    ch9120_iothread_buf_t rx_pool[CH9120_IOTHREAD_BUF_NUM];    /**< rx buffers */
+    ch9120_iothread_buf_t tx_pool[CH9120_IOTHREAD_BUF_NUM];    /**< tx buffers */
+} ch9120_iothread_t;
+
+/**
+ * @brief     start the io thread
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *handle pointer to an initialized ch9120 handle structure
+ * @param[in] cpu cpu of the thread, -1 does not pin it
+ * @param[in] priority SCHED_FIFO priority 1 - 99, 0 keeps the default policy
+ * @param[in] idle_us idle wait in us when the uart has nothing to read
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 2 cpu is invalid
+ *            - 3 priority is not permitted
+ * @note      the thread owns ch9120_read and ch9120_write of the handle from here,
+ *            other commands may still run from the application when the mutex hooks are linked
+ */
+uint8_t ch9120_iothread_start(ch9120_iothread_t *io, ch9120_handle_t *handle,
+                              int32_t cpu, int32_t priority, uint32_t idle_us);
+
+/**
+ * @brief     stop the io thread
+ * @param[in] *io pointer to an iothread structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 stop failed
+ * @note      queued data is written first
+ */
+uint8_t ch9120_iothread_stop(ch9120_iothread_t *io);
+
+/**
+ * @brief     get a free tx buffer
+ * @param[in] *io pointer to an iothread structure
+ * @return    pointer to a buffer, NULL when all buffers are queued
+ * @note      application thread only
+ */
+ch9120_iothread_buf_t *ch9120_iothread_tx_alloc(ch9120_iothread_t *io);
+
+/**
+ * @brief     queue a tx buffer
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a buffer from ch9120_iothread_tx_alloc
+ * @note      application thread only, the io thread is woken only when it sleeps
+ */
+void ch9120_iothread_tx_submit(ch9120_iothread_t *io, ch9120_iothread_buf_t *buf);
+
+/**
+ * @brief     get a received buffer
+ * @param[in] *io pointer to an iothread structure
+ * @return    pointer to a buffer, NULL when nothing is received
+ * @note      application thread only, give it back with ch9120_iothread_rx_release
+ */
+ch9120_iothread_buf_t *ch9120_iothread_rx_receive(ch9120_iothread_t *io);
+
+/**
+ * @brief     release a received buffer
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a buffer from ch9120_iothread_rx_receive
+ * @note      application thread only
+ */
+void ch9120_iothread_rx_release(ch9120_iothread_t *io, ch9120_iothread_buf_t *buf);
+
+/**
+ * @brief     copy data to the tx queue
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    queued length, less than len when the tx buffers run out
+ * @note      application thread only
+ */
+uint32_t ch9120_iothread_write(ch9120_iothread_t *io, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief      copy data from the rx queue
+ * @param[in]  *io pointer to an iothread structure
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     read length
+ * @note       application thread only, never waits
+ */
+uint32_t ch9120_iothread_read(ch9120_iothread_t *io, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief     get the rx eventfd
+ * @param[in] *io pointer to an iothread structure
+ * @return    eventfd
+ * @note      it turns readable when the rx queue stops being empty,
+ *            read the eventfd before draining the queue until it is empty
+ */
+int ch9120_iothread_get_fd(ch9120_iothread_t *io);
+
+/**
+ * @brief      get the io thread stats
+ * @param[in]  *io pointer to an iothread structure
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void ch9120_iothread_get_stats(ch9120_iothread_t *io, ch9120_iothread_stats_t *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,19 +36,54 @@
 
 #include "driver_ch9120_interface.h"
 #include "uart.h"
+#include "uring.h"
 #include "wire.h"
+#include "trace.h"
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 /**
  * @brief uart device name definition
  */
 #define UART_DEVICE_NAME "/dev/ttyS0"        /**< uart device name */
 
+/**
+ * @brief uart transport definition
+ * @note  1 runs the uart on io_uring and falls back to the uart syscalls if the kernel refuses it
+ */
+#ifndef UART_USE_URING
+    #define UART_USE_URING 1
+#endif
+
+/**
+ * @brief storage file name definition
+ */
+#define STORAGE_FILE_NAME "/var/lib/ch9120.record"        /**< storage file name */
+
 /**
  * @brief uart device handle definition
  */
 static int gs_fd;                           /**< uart handle */
 
+/**
+ * @brief uring transport definition
+ */
+static uring_t gs_ring;                     /**< uring handle */
+static uring_uart_t gs_uart;                /**< uring uart handle */
+static uint8_t gs_uring;                    /**< uring is used */
+static uint8_t gs_peek[URING_RX_SIZE];      /**< peek buffer of the uart syscalls */
+static uint32_t gs_peek_len;                /**< peek buffer length */
+
+/**
+ * @brief crc32 slicing-by-8 table definition
+ */
+static uint32_t gs_crc32_table[8][256];        /**< crc32 table */
+static uint8_t gs_crc32_inited;                /**< crc32 table flag */
+
 /**
  * @brief  interface uart init
  * @return status code
@@ -58,6 +93,20 @@ static int gs_fd;                           /**< uart handle */
  */
 uint8_t ch9120_interface_uart_init(void)
 {
+    gs_uring = 0;
+#if (UART_USE_URING == 1)
+    if (uring_init(&gs_ring, 64) == 0)
+    {
+        if (uring_uart_open(&gs_ring, &gs_uart, UART_DEVICE_NAME, 9600, 8, 'N', 1) == 0)
+        {
+            gs_uring = 1;
+            
+            return 0;
+        }
+        (void)uring_deinit(&gs_ring);
+    }
+#endif
+    
     return uart_init(UART_DEVICE_NAME, &gs_fd, 9600, 8, 'N', 1);
 }
 
@@ -70,6 +119,17 @@ uint8_t ch9120_interface_uart_init(void)
  */
 uint8_t ch9120_interface_uart_deinit(void)
 {
+    uint8_t res;
+    
+    if (gs_uring != 0)
+    {
+        res = uring_uart_close(&gs_uart);
+        res |= uring_deinit(&gs_ring);
+        gs_uring = 0;
+        
+        return res;
+    }
+    
     return uart_deinit(gs_fd);
 }
 
@@ -86,6 +146,24 @@ uint16_t ch9120_interface_uart_read(uint8_t *buf, uint16_t len)
 {
     uint32_t l = len;
 
+    if (gs_uring != 0)
+    {
+        if (uring_uart_read(&gs_uart, buf, &l) != 0)
+        {
+            return 0;
+        }
+        
+        return (uint16_t)l;
+    }
+    if (gs_peek_len != 0)
+    {
+        l = (l < gs_peek_len) ? l : gs_peek_len;
+        memcpy(buf, gs_peek, l);
+        memmove(gs_peek, &gs_peek[l], gs_peek_len - l);
+        gs_peek_len -= l;
+        
+        return (uint16_t)l;
+    }
     if (uart_read(gs_fd, buf, (uint32_t *)&l))
     {
         return 0;
@@ -105,9 +183,88 @@ uint16_t ch9120_interface_uart_read(uint8_t *buf, uint16_t len)
  */
 uint8_t ch9120_interface_uart_flush(void)
 {
+    if (gs_uring != 0)
+    {
+        return uring_uart_flush(&gs_uart);
+    }
+    
+    gs_peek_len = 0;
+    
     return uart_flush(gs_fd);
 }
 
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       the uart syscalls have no ring, their data is read into a static buffer
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view)
+{
+    uint8_t *buf0;
+    uint8_t *buf1;
+    uint32_t len0;
+    uint32_t len1;
+    uint32_t l;
+    
+    if (gs_uring != 0)
+    {
+        if (uring_uart_peek(&gs_uart, &buf0, &len0, &buf1, &len1) != 0)
+        {
+            return 1;
+        }
+        view->buf[0] = buf0;
+        view->len[0] = (uint16_t)((len0 < 0xFFFFU) ? len0 : 0xFFFFU);
+        view->buf[1] = buf1;
+        view->len[1] = (uint16_t)((len1 < (0xFFFFU - view->len[0])) ? len1 : (0xFFFFU - view->len[0]));
+        
+        return 0;
+    }
+    l = URING_RX_SIZE - gs_peek_len;
+    if ((l != 0) && (uart_read(gs_fd, &gs_peek[gs_peek_len], &l) != 0))
+    {
+        return 1;
+    }
+    gs_peek_len += l;
+    view->buf[0] = gs_peek;
+    view->len[0] = (uint16_t)gs_peek_len;
+    view->buf[1] = NULL;
+    view->len[1] = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len)
+{
+    if (gs_uring != 0)
+    {
+        if (uring_uart_consume(&gs_uart, len) != len)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    if (len > gs_peek_len)
+    {
+        return 1;
+    }
+    memmove(gs_peek, &gs_peek[len], gs_peek_len - len);
+    gs_peek_len -= len;
+    
+    return 0;
+}
+
 /**
  * @brief     interface uart write
  * @param[in] *buf pointer to a data buffer
@@ -119,6 +276,11 @@ uint8_t ch9120_interface_uart_flush(void)
  */
 uint8_t ch9120_interface_uart_write(uint8_t *buf, uint16_t len)
 {
+    if (gs_uring != 0)
+    {
+        return uring_uart_write(&gs_uart, buf, len);
+    }
+    
     return uart_write(gs_fd, buf, len);
 }
 
@@ -193,6 +355,11 @@ uint8_t ch9120_interface_cfg_gpio_deinit(void)
  */
 uint8_t ch9120_interface_cfg_gpio_write(uint8_t data)
 {
+    if (gs_uring != 0)
+    {
+        (void)uring_uart_drain(&gs_uart, 1000);
+    }
+    
     return wire_write(data);
 }
 
@@ -203,6 +370,21 @@ uint8_t ch9120_interface_cfg_gpio_write(uint8_t data)
  */
 void ch9120_interface_delay_ms(uint32_t ms)
 {
+    uint64_t now;
+    uint64_t end;
+    
+    if (gs_uring != 0)
+    {
+        now = ch9120_interface_timestamp_us();
+        end = now + (uint64_t)ms * 1000;
+        while (now < end)
+        {
+            (void)uring_run(&gs_ring, (uint32_t)((end - now + 999) / 1000));
+            now = ch9120_interface_timestamp_us();
+        }
+        
+        return;
+    }
     usleep(1000 * ms);
 }
 
@@ -223,3 +405,262 @@ void ch9120_interface_debug_print(const char *const fmt, ...)
     
     (void)printf((uint8_t *)str);
 }
+
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t ch9120_interface_timestamp_us(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+/**
+ * @brief     trace record
+ * @param[in] *trace pointer to a trace structure
+ * @param[in] phase trace phase
+ * @note      none
+ */
+static void a_trace_record(const ch9120_trace_t *trace, char phase)
+{
+    const char *const name[4] = {"write_check", "write_read", "read", "write"};
+    trace_event_t event;
+    
+    event.name = name[trace->type & 0x03];
+    event.phase = phase;
+    event.id = trace->cmd;
+    event.status = trace->status;
+    event.tx_len = trace->tx_len;
+    event.rx_len = trace->rx_len;
+    event.timestamp_us = trace->timestamp_us;
+    (void)trace_record(&event);
+}
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace)
+{
+    a_trace_record(trace, 'B');
+}
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace)
+{
+    a_trace_record(trace, 'E');
+}
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len)
+{
+    FILE *fp;
+    size_t l;
+    
+    fp = fopen(STORAGE_FILE_NAME, "rb");
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    l = fread(buf, 1, len, fp);
+    (void)fclose(fp);
+    if (l != len)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len)
+{
+    FILE *fp;
+    size_t l;
+    
+    fp = fopen(STORAGE_FILE_NAME, "wb");
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    l = fwrite(buf, 1, len, fp);
+    if (fclose(fp) != 0)
+    {
+        return 1;
+    }
+    if (l != len)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      slicing-by-8, the tables are built on the first call
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t crc;
+    
+    if (gs_crc32_inited == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            crc = i;
+            for (j = 0; j < 8; j++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+            gs_crc32_table[0][i] = crc;
+        }
+        for (i = 0; i < 256; i++)
+        {
+            for (j = 1; j < 8; j++)
+            {
+                gs_crc32_table[j][i] = (gs_crc32_table[j - 1][i] >> 8) ^ 
+                                       gs_crc32_table[0][gs_crc32_table[j - 1][i] & 0xFF];
+            }
+        }
+        gs_crc32_inited = 1;
+    }
+    crc = 0xFFFFFFFFU;
+    while (len >= 8)
+    {
+        lo = crc ^ ((uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | 
+                    ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));
+        hi = (uint32_t)buf[4] | ((uint32_t)buf[5] << 8) | 
+             ((uint32_t)buf[6] << 16) | ((uint32_t)buf[7] << 24);
+        crc = gs_crc32_table[7][lo & 0xFF] ^ gs_crc32_table[6][(lo >> 8) & 0xFF] ^
+              gs_crc32_table[5][(lo >> 16) & 0xFF] ^ gs_crc32_table[4][lo >> 24] ^
+              gs_crc32_table[3][hi & 0xFF] ^ gs_crc32_table[2][(hi >> 8) & 0xFF] ^
+              gs_crc32_table[1][(hi >> 16) & 0xFF] ^ gs_crc32_table[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+    while (len != 0)
+    {
+        crc = (crc >> 8) ^ gs_crc32_table[0][(crc ^ *buf++) & 0xFF];
+        len--;
+    }
+    
+    return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       the context is the cfg and io mutex of one handle
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx)
+{
+    pthread_mutex_t *mutex;
+    
+    mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t) * 2);
+    if (mutex == NULL)
+    {
+        return 1;
+    }
+    if (pthread_mutex_init(&mutex[0], NULL) != 0)
+    {
+        free(mutex);
+        
+        return 1;
+    }
+    if (pthread_mutex_init(&mutex[1], NULL) != 0)
+    {
+        (void)pthread_mutex_destroy(&mutex[0]);
+        free(mutex);
+        
+        return 1;
+    }
+    *ctx = mutex;
+    
+    return 0;
+}
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      none
+ */
+void ch9120_interface_mutex_deinit(void *ctx)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    (void)pthread_mutex_destroy(&mutex[0]);
+    (void)pthread_mutex_destroy(&mutex[1]);
+    free(mutex);
+}
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      none
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    if (wait == 0)
+    {
+        return (pthread_mutex_trylock(&mutex[id]) == 0) ? 0 : 1;
+    }
+    
+    return (pthread_mutex_lock(&mutex[id]) == 0) ? 0 : 1;
+}
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      none
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)ctx;
+    
+    (void)pthread_mutex_unlock(&mutex[id]);
+}
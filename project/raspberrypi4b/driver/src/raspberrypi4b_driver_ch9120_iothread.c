@@ -0,0 +1,545 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_ch9120_iothread.c
+ * @brief     raspberrypi4b driver ch9120 iothread source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+#include "driver_ch9120_iothread.h"
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief queue mask definition
+ */
+#define CH9120_IOTHREAD_MASK    (CH9120_IOTHREAD_BUF_NUM - 1)
+
+_Static_assert((CH9120_IOTHREAD_BUF_NUM & CH9120_IOTHREAD_MASK) == 0, "CH9120_IOTHREAD_BUF_NUM must be a power of 2");
+
+/**
+ * @brief     push a buffer
+ * @param[in] *q pointer to a queue structure
+ * @param[in] *buf pointer to a buffer
+ * @return    1 if the queue was empty, else 0
+ * @note      producer only, a queue never holds more than its pool, so it is never full
+ */
+static uint8_t a_queue_push(ch9120_iothread_queue_t *q, ch9120_iothread_buf_t *buf)
+{
+    uint32_t tail;
+    
+    tail = q->tail;
+    q->slot[tail & CH9120_IOTHREAD_MASK] = buf;
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_SEQ_CST);
+    
+    return (__atomic_load_n(&q->head, __ATOMIC_SEQ_CST) == tail) ? 1 : 0;
+}
+
+/**
+ * @brief     pop a buffer
+ * @param[in] *q pointer to a queue structure
+ * @return    pointer to a buffer, NULL when the queue is empty
+ * @note      consumer only
+ */
+static ch9120_iothread_buf_t *a_queue_pop(ch9120_iothread_queue_t *q)
+{
+    uint32_t head;
+    ch9120_iothread_buf_t *buf;
+    
+    head = q->head;
+    if (head == __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+    buf = q->slot[head & CH9120_IOTHREAD_MASK];
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_SEQ_CST);
+    
+    return buf;
+}
+
+/**
+ * @brief     check a queue
+ * @param[in] *q pointer to a queue structure
+ * @return    1 if the queue is empty, else 0
+ * @note      consumer only
+ */
+static uint8_t a_queue_empty(ch9120_iothread_queue_t *q)
+{
+    return (q->head == __atomic_load_n(&q->tail, __ATOMIC_SEQ_CST)) ? 1 : 0;
+}
+
+/**
+ * @brief     add to a stats counter
+ * @param[in] *counter pointer to a counter
+ * @param[in] n added value
+ * @note      the io thread is the only writer
+ */
+static void a_stats_add(uint64_t *counter, uint64_t n)
+{
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief     signal an eventfd
+ * @param[in] fd eventfd
+ * @note      none
+ */
+static void a_event_signal(int fd)
+{
+    uint64_t one;
+    
+    one = 1;
+    (void)write(fd, &one, sizeof(one));
+}
+
+/**
+ * @brief     clear an eventfd
+ * @param[in] fd eventfd
+ * @note      none
+ */
+static void a_event_clear(int fd)
+{
+    uint64_t value;
+    
+    (void)read(fd, &value, sizeof(value));
+}
+
+/**
+ * @brief     write the queued buffers
+ * @param[in] *io pointer to an iothread structure
+ * @return    1 if anything was written, else 0
+ * @note      none
+ */
+static uint8_t a_iothread_tx(ch9120_iothread_t *io)
+{
+    uint8_t busy;
+    ch9120_iothread_buf_t *buf;
+    
+    busy = 0;
+    while ((buf = a_queue_pop(&io->tx_queue)) != NULL)
+    {
+        if (ch9120_write(io->handle, buf->buf, buf->len) != 0)
+        {
+            a_stats_add(&io->stats.tx_errors, 1);
+        }
+        else
+        {
+            a_stats_add(&io->stats.tx_bytes, buf->len);
+        }
+        (void)a_queue_push(&io->tx_free, buf);
+        busy = 1;
+    }
+    (void)ch9120_write_handler(io->handle);
+    
+    return busy;
+}
+
+/**
+ * @brief     read the uart into a free buffer
+ * @param[in] *io pointer to an iothread structure
+ * @return    1 if anything was read, else 0
+ * @note      the uart is drained into a scratch buffer when the application holds every buffer
+ */
+static uint8_t a_iothread_rx(ch9120_iothread_t *io)
+{
+    uint16_t len;
+    uint8_t scratch[CH9120_IOTHREAD_BUF_SIZE];
+    
+    if (io->rx_spare == NULL)
+    {
+        io->rx_spare = a_queue_pop(&io->rx_free);
+    }
+    len = CH9120_IOTHREAD_BUF_SIZE;
+    if (io->rx_spare == NULL)
+    {
+        if ((ch9120_read(io->handle, scratch, &len) != 0) || (len == 0))
+        {
+            return 0;
+        }
+        a_stats_add(&io->stats.rx_dropped, len);
+        
+        return 1;
+    }
+    if ((ch9120_read(io->handle, io->rx_spare->buf, &len) != 0) || (len == 0))
+    {
+        return 0;
+    }
+    io->rx_spare->len = len;
+    a_stats_add(&io->stats.rx_bytes, len);
+    if (a_queue_push(&io->rx_queue, io->rx_spare) != 0)
+    {
+        a_event_signal(io->rx_fd);
+    }
+    io->rx_spare = NULL;
+    
+    return 1;
+}
+
+/**
+ * @brief     wait until there is data to write or the idle time passes
+ * @param[in] *io pointer to an iothread structure
+ * @note      the application signals tx_fd only while sleeping is set
+ */
+static void a_iothread_idle(ch9120_iothread_t *io)
+{
+    struct pollfd pfd;
+    struct timespec ts;
+    
+    __atomic_store_n(&io->sleeping, 1, __ATOMIC_SEQ_CST);
+    if ((a_queue_empty(&io->tx_queue) != 0) && (__atomic_load_n(&io->stop, __ATOMIC_SEQ_CST) == 0))
+    {
+        pfd.fd = io->tx_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        ts.tv_sec = io->idle_us / 1000000;
+        ts.tv_nsec = (long)(io->idle_us % 1000000) * 1000;
+        if (ppoll(&pfd, 1, &ts, NULL) > 0)
+        {
+            a_event_clear(io->tx_fd);
+        }
+        a_stats_add(&io->stats.wakeups, 1);
+    }
+    __atomic_store_n(&io->sleeping, 0, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief     io thread
+ * @param[in] *arg pointer to an iothread structure
+ * @return    NULL
+ * @note      none
+ */
+static void *a_iothread_run(void *arg)
+{
+    uint8_t busy;
+    ch9120_iothread_t *io;
+    
+    io = (ch9120_iothread_t *)arg;
+    while (__atomic_load_n(&io->stop, __ATOMIC_ACQUIRE) == 0)
+    {
+        busy = a_iothread_tx(io);
+        busy |= a_iothread_rx(io);
+        if (busy == 0)
+        {
+            a_iothread_idle(io);
+        }
+    }
+    (void)a_iothread_tx(io);
+    (void)ch9120_write_flush(io->handle);
+    
+    return NULL;
+}
+
+/**
+ * @brief     close the eventfds
+ * @param[in] *io pointer to an iothread structure
+ * @note      none
+ */
+static void a_iothread_close(ch9120_iothread_t *io)
+{
+    if (io->rx_fd >= 0)
+    {
+        (void)close(io->rx_fd);
+    }
+    if (io->tx_fd >= 0)
+    {
+        (void)close(io->tx_fd);
+    }
+    io->rx_fd = -1;
+    io->tx_fd = -1;
+}
+
+/**
+ * @brief     start the io thread
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *handle pointer to an initialized ch9120 handle structure
+ * @param[in] cpu cpu of the thread, -1 does not pin it
+ * @param[in] priority SCHED_FIFO priority 1 - 99, 0 keeps the default policy
+ * @param[in] idle_us idle wait in us when the uart has nothing to read
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 2 cpu is invalid
+ *            - 3 priority is not permitted
+ * @note      the thread owns ch9120_read and ch9120_write of the handle from here,
+ *            other commands may still run from the application when the mutex hooks are linked
+ */
+uint8_t ch9120_iothread_start(ch9120_iothread_t *io, ch9120_handle_t *handle,
+                              int32_t cpu, int32_t priority, uint32_t idle_us)
+{
+    int res;
+    uint32_t i;
+    cpu_set_t set;
+    pthread_attr_t attr;
+    struct sched_param param;
+    
+    if ((cpu >= 0) && ((cpu >= CPU_SETSIZE) || (cpu >= sysconf(_SC_NPROCESSORS_CONF))))
+    {
+        return 2;
+    }
+    if ((priority < 0) || (priority > 99))
+    {
+        return 3;
+    }
+    
+    /* init the queues and the pools */
+    memset(io, 0, sizeof(ch9120_iothread_t));
+    io->handle = handle;
+    io->idle_us = idle_us;
+    for (i = 0; i < CH9120_IOTHREAD_BUF_NUM; i++)
+    {
+        (void)a_queue_push(&io->rx_free, &io->rx_pool[i]);
+        (void)a_queue_push(&io->tx_free, &io->tx_pool[i]);
+    }
+    io->rx_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    io->tx_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((io->rx_fd < 0) || (io->tx_fd < 0) || (pthread_attr_init(&attr) != 0))
+    {
+        a_iothread_close(io);
+        
+        return 1;
+    }
+    
+    /* set the affinity and the priority */
+    if (cpu >= 0)
+    {
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        (void)pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+    }
+    if (priority != 0)
+    {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        (void)pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        (void)pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        (void)pthread_attr_setschedparam(&attr, &param);
+    }
+    res = pthread_create(&io->thread, &attr, a_iothread_run, io);
+    (void)pthread_attr_destroy(&attr);
+    if (res != 0)
+    {
+        a_iothread_close(io);
+        
+        return ((res == EPERM) && (priority != 0)) ? 3 : 1;
+    }
+    io->running = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief     stop the io thread
+ * @param[in] *io pointer to an iothread structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 stop failed
+ * @note      queued data is written first
+ */
+uint8_t ch9120_iothread_stop(ch9120_iothread_t *io)
+{
+    if (io->running == 0)
+    {
+        return 1;
+    }
+    __atomic_store_n(&io->stop, 1, __ATOMIC_SEQ_CST);
+    a_event_signal(io->tx_fd);
+    if (pthread_join(io->thread, NULL) != 0)
+    {
+        return 1;
+    }
+    a_iothread_close(io);
+    io->running = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     get a free tx buffer
+ * @param[in] *io pointer to an iothread structure
+ * @return    pointer to a buffer, NULL when all buffers are queued
+ * @note      application thread only
+ */
+ch9120_iothread_buf_t *ch9120_iothread_tx_alloc(ch9120_iothread_t *io)
+{
+    return a_queue_pop(&io->tx_free);
+}
+
+/**
+ * @brief     queue a tx buffer
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a buffer from ch9120_iothread_tx_alloc
+ * @note      application thread only, the io thread is woken only when it sleeps
+ */
+void ch9120_iothread_tx_submit(ch9120_iothread_t *io, ch9120_iothread_buf_t *buf)
+{
+    (void)a_queue_push(&io->tx_queue, buf);
+    if (__atomic_load_n(&io->sleeping, __ATOMIC_SEQ_CST) != 0)
+    {
+        a_event_signal(io->tx_fd);
+    }
+}
+
+/**
+ * @brief     get a received buffer
+ * @param[in] *io pointer to an iothread structure
+ * @return    pointer to a buffer, NULL when nothing is received
+ * @note      application thread only, give it back with ch9120_iothread_rx_release
+ */
+ch9120_iothread_buf_t *ch9120_iothread_rx_receive(ch9120_iothread_t *io)
+{
+    return a_queue_pop(&io->rx_queue);
+}
+
+/**
+ * @brief     release a received buffer
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a buffer from ch9120_iothread_rx_receive
+ * @note      application thread only
+ */
+void ch9120_iothread_rx_release(ch9120_iothread_t *io, ch9120_iothread_buf_t *buf)
+{
+    (void)a_queue_push(&io->rx_free, buf);
+}
+
+/**
+ * @brief     copy data to the tx queue
+ * @param[in] *io pointer to an iothread structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    queued length, less than len when the tx buffers run out
+ * @note      application thread only
+ */
+uint32_t ch9120_iothread_write(ch9120_iothread_t *io, uint8_t *buf, uint32_t len)
+{
+    uint32_t n;
+    uint32_t done;
+    ch9120_iothread_buf_t *b;
+    
+    done = 0;
+    while (done < len)
+    {
+        b = ch9120_iothread_tx_alloc(io);
+        if (b == NULL)
+        {
+            break;
+        }
+        n = len - done;
+        if (n > CH9120_IOTHREAD_BUF_SIZE)
+        {
+            n = CH9120_IOTHREAD_BUF_SIZE;
+        }
+        memcpy(b->buf, &buf[done], n);
+        b->len = (uint16_t)n;
+        ch9120_iothread_tx_submit(io, b);
+        done += n;
+    }
+    
+    return done;
+}
+
+/**
+ * @brief      copy data from the rx queue
+ * @param[in]  *io pointer to an iothread structure
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     read length
+ * @note       application thread only, never waits
+ */
+uint32_t ch9120_iothread_read(ch9120_iothread_t *io, uint8_t *buf, uint32_t len)
+{
+    uint32_t n;
+    uint32_t done;
+    
+    done = 0;
+    while (done < len)
+    {
+        if (io->rx_cur == NULL)
+        {
+            io->rx_cur = ch9120_iothread_rx_receive(io);
+            io->rx_off = 0;
+            if (io->rx_cur == NULL)
+            {
+                break;
+            }
+        }
+        n = (uint32_t)(io->rx_cur->len - io->rx_off);
+        if (n > len - done)
+        {
+            n = len - done;
+        }
+        memcpy(&buf[done], &io->rx_cur->buf[io->rx_off], n);
+        io->rx_off += (uint16_t)n;
+        done += n;
+        if (io->rx_off == io->rx_cur->len)
+        {
+            ch9120_iothread_rx_release(io, io->rx_cur);
+            io->rx_cur = NULL;
+        }
+    }
+    
+    return done;
+}
+
+/**
+ * @brief     get the rx eventfd
+ * @param[in] *io pointer to an iothread structure
+ * @return    eventfd
+ * @note      it turns readable when the rx queue stops being empty,
+ *            read the eventfd before draining the queue until it is empty
+ */
+int ch9120_iothread_get_fd(ch9120_iothread_t *io)
+{
+    return io->rx_fd;
+}
+
+/**
+ * @brief      get the io thread stats
+ * @param[in]  *io pointer to an iothread structure
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void ch9120_iothread_get_stats(ch9120_iothread_t *io, ch9120_iothread_stats_t *stats)
+{
+    stats->rx_bytes = __atomic_load_n(&io->stats.rx_bytes, __ATOMIC_RELAXED);
+    stats->tx_bytes = __atomic_load_n(&io->stats.tx_bytes, __ATOMIC_RELAXED);
+    stats->rx_dropped = __atomic_load_n(&io->stats.rx_dropped, __ATOMIC_RELAXED);
+    stats->tx_errors = __atomic_load_n(&io->stats.tx_errors, __ATOMIC_RELAXED);
+    stats->wakeups = __atomic_load_n(&io->stats.wakeups, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      trace.h
+ * @brief     trace header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace trace function
+ * @brief    trace function modules
+ * @{
+ */
+
+/**
+ * @brief trace max events of one thread definition
+ */
+#ifndef TRACE_MAX_EVENTS
+    #define TRACE_MAX_EVENTS    8192        /**< 8192 events */
+#endif
+
+/**
+ * @brief trace event structure definition
+ */
+typedef struct trace_event_s
+{
+    const char *name;             /**< event name, must be a static string */
+    char phase;                   /**< 'B' begin or 'E' end */
+    uint8_t id;                   /**< command id */
+    uint8_t status;               /**< status code */
+    uint16_t tx_len;              /**< transmitted bytes */
+    uint16_t rx_len;              /**< received bytes */
+    uint64_t timestamp_us;        /**< monotonic timestamp in us */
+} trace_event_t;
+
+/**
+ * @brief     trace record an event
+ * @param[in] *event pointer to an event structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 record failed
+ * @note      every thread records into its own buffer without any lock,
+ *            events are dropped when the thread buffer is full
+ */
+uint8_t trace_record(const trace_event_t *event);
+
+/**
+ * @brief     trace export all recorded events
+ * @param[in] *path pointer to a file path buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 export failed
+ * @note      the file is written in the chrome trace event json format,
+ *            it can be opened by perfetto or chrome://tracing
+ */
+uint8_t trace_export(const char *path);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
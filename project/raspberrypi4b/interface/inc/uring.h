@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      uring.h
+ * @brief     uring header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef URING_H
+#define URING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup uring uring function
+ * @brief    uring function modules
+ * @{
+ */
+
+/**
+ * @brief uring buffer size definition
+ */
+#ifndef URING_RX_SIZE
+    #define URING_RX_SIZE       4096        /**< 4096 bytes received data of one uart */
+#endif
+#ifndef URING_TX_SIZE
+    #define URING_TX_SIZE       4096        /**< 4096 bytes queued data of one uart */
+#endif
+#ifndef URING_CHUNK_SIZE
+    #define URING_CHUNK_SIZE    256         /**< 256 bytes of one armed read */
+#endif
+
+/**
+ * @brief uring structure definition
+ */
+typedef struct uring_s
+{
+    int fd;                         /**< ring fd */
+    uint32_t *sq_head;              /**< submission queue head */
+    uint32_t *sq_tail;              /**< submission queue tail */
+    uint32_t *sq_mask;              /**< submission queue mask */
+    uint32_t *sq_array;             /**< submission queue index array */
+    uint32_t *cq_head;              /**< completion queue head */
+    uint32_t *cq_tail;              /**< completion queue tail */
+    uint32_t *cq_mask;              /**< completion queue mask */
+    uint32_t sq_entries;            /**< submission queue entries */
+    void *sqes;                     /**< submission queue entries */
+    void *cqes;                     /**< completion queue entries */
+    void *sq_ptr;                   /**< submission queue map */
+    size_t sq_size;                 /**< submission queue map size */
+    void *cq_ptr;                   /**< completion queue map */
+    size_t cq_size;                 /**< completion queue map size */
+    size_t sqes_size;               /**< submission entries map size */
+    uint64_t enters;                /**< io_uring_enter calls */
+    uint64_t completions;           /**< reaped completions */
+} uring_t;
+
+/**
+ * @brief uring uart structure definition
+ */
+typedef struct uring_uart_s
+{
+    uring_t *ring;                          /**< ring */
+    int fd;                                 /**< uart fd */
+    uint8_t read_armed;                     /**< a read is armed */
+    uint8_t write_armed;                    /**< a write is in flight */
+    uint8_t closing;                        /**< do not arm reads */
+    uint8_t tx_drain;                       /**< written data is not drained */
+    uint32_t rx_head;                       /**< received data head */
+    uint32_t rx_tail;                       /**< received data tail */
+    uint32_t rx_lost;                       /**< dropped bytes of a full rx buffer */
+    uint32_t tx_len;                        /**< queued bytes */
+    uint32_t tx_sent;                       /**< written bytes */
+    uint32_t tx_inflight;                   /**< bytes of the write in flight */
+    uint8_t chunk[URING_CHUNK_SIZE];        /**< armed read buffer */
+    uint8_t rx[URING_RX_SIZE];              /**< received data */
+    uint8_t tx[URING_TX_SIZE];              /**< queued data */
+} uring_uart_t;
+
+/**
+ * @brief     uring init
+ * @param[in] *ring pointer to a uring structure
+ * @param[in] entries submission queue entries
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      one ring serves any number of uarts
+ */
+uint8_t uring_init(uring_t *ring, uint32_t entries);
+
+/**
+ * @brief     uring deinit
+ * @param[in] *ring pointer to a uring structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      close all uarts first
+ */
+uint8_t uring_deinit(uring_t *ring);
+
+/**
+ * @brief     uring run
+ * @param[in] *ring pointer to a uring structure
+ * @param[in] timeout_ms max wait for a completion in ms, 0 never waits
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      submits every queued read and write with one syscall and reaps the completions
+ */
+uint8_t uring_run(uring_t *ring, uint32_t timeout_ms);
+
+/**
+ * @brief      uring uart open
+ * @param[in]  *ring pointer to a uring structure
+ * @param[out] *uart pointer to a uring uart structure
+ * @param[in]  *name pointer to a device name buffer
+ * @param[in]  baud_rate baud rate
+ * @param[in]  data_bits data bits
+ * @param[in]  parity data parity
+ * @param[in]  stop_bits stop bits
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       a read stays armed on the uart until it is closed
+ */
+uint8_t uring_uart_open(uring_t *ring, uring_uart_t *uart, char *name,
+                        uint32_t baud_rate, uint8_t data_bits, char parity, uint8_t stop_bits);
+
+/**
+ * @brief     uring uart close
+ * @param[in] *uart pointer to a uring uart structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      queued data is written first
+ */
+uint8_t uring_uart_close(uring_uart_t *uart);
+
+/**
+ * @brief     uring uart write data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the data is queued, it is submitted by the next uring_run, read, flush or drain
+ */
+uint8_t uring_uart_write(uring_uart_t *uart, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief          uring uart read data
+ * @param[in]      *uart pointer to a uring uart structure
+ * @param[out]     *buf pointer to a data buffer
+ * @param[in, out] *len pointer to a length of the data buffer
+ * @return         status code
+ *                 - 0 success
+ *                 - 1 read failed
+ * @note           never waits, the ring is run once when nothing is buffered
+ */
+uint8_t uring_uart_read(uring_uart_t *uart, uint8_t *buf, uint32_t *len);
+
+/**
+ * @brief      uring uart peek the received data
+ * @param[in]  *uart pointer to a uring uart structure
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       the segments point into the rx ring and stay valid until uring_uart_consume
+ */
+uint8_t uring_uart_peek(uring_uart_t *uart, uint8_t **buf0, uint32_t *len0, uint8_t **buf1, uint32_t *len1);
+
+/**
+ * @brief     uring uart consume the peeked data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint32_t uring_uart_consume(uring_uart_t *uart, uint32_t len);
+
+/**
+ * @brief     uring uart flush the received data
+ * @param[in] *uart pointer to a uring uart structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      queued data is kept
+ */
+uint8_t uring_uart_flush(uring_uart_t *uart);
+
+/**
+ * @brief     uring uart drain the queued data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] timeout_ms timeout in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 drain failed
+ * @note      returns when the tty has transmitted everything
+ */
+uint8_t uring_uart_drain(uring_uart_t *uart, uint32_t timeout_ms);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
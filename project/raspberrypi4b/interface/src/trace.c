@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      trace.c
+ * @brief     trace source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/**
+ * @brief trace buffer structure definition
+ */
+typedef struct trace_buffer_s
+{
+    struct trace_buffer_s *next;                 /**< next buffer */
+    long tid;                                    /**< thread id */
+    uint32_t count;                              /**< published events */
+    uint32_t dropped;                            /**< dropped events */
+    trace_event_t event[TRACE_MAX_EVENTS];       /**< events */
+} trace_buffer_t;
+
+static trace_buffer_t *gs_head = NULL;                /**< all thread buffers */
+static __thread trace_buffer_t *gs_local = NULL;      /**< current thread buffer */
+
+/**
+ * @brief  get the buffer of the current thread
+ * @return pointer to a trace buffer
+ * @note   the buffer is never freed, so it can be exported after the thread exits
+ */
+static trace_buffer_t *a_trace_get_local(void)
+{
+    trace_buffer_t *buffer;
+    
+    /* check the buffer */
+    if (gs_local != NULL)
+    {
+        return gs_local;
+    }
+    
+    /* alloc the buffer */
+    buffer = (trace_buffer_t *)calloc(1, sizeof(trace_buffer_t));
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    buffer->tid = syscall(SYS_gettid);
+    
+    /* push the buffer to the list */
+    buffer->next = __atomic_load_n(&gs_head, __ATOMIC_ACQUIRE);
+    while (__atomic_compare_exchange_n(&gs_head, &buffer->next, buffer, 1,
+                                       __ATOMIC_RELEASE, __ATOMIC_ACQUIRE) == 0)
+    {
+    }
+    gs_local = buffer;
+    
+    return buffer;
+}
+
+/**
+ * @brief     trace record an event
+ * @param[in] *event pointer to an event structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 record failed
+ * @note      every thread records into its own buffer without any lock,
+ *            events are dropped when the thread buffer is full
+ */
+uint8_t trace_record(const trace_event_t *event)
+{
+    trace_buffer_t *buffer;
+    uint32_t count;
+    
+    /* get the buffer */
+    buffer = a_trace_get_local();
+    if (buffer == NULL)
+    {
+        return 1;
+    }
+    
+    /* check the space */
+    count = buffer->count;
+    if (count >= TRACE_MAX_EVENTS)
+    {
+        buffer->dropped++;
+        
+        return 1;
+    }
+    
+    /* write the event and publish it */
+    buffer->event[count] = *event;
+    __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+    
+    return 0;
+}
+
+/**
+ * @brief     trace export all recorded events
+ * @param[in] *path pointer to a file path buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 export failed
+ * @note      the file is written in the chrome trace event json format,
+ *            it can be opened by perfetto or chrome://tracing
+ */
+uint8_t trace_export(const char *path)
+{
+    FILE *fp;
+    trace_buffer_t *buffer;
+    uint8_t first;
+    int pid;
+    
+    /* open the file */
+    fp = fopen(path, "w");
+    if (fp == NULL)
+    {
+        perror("trace: open failed.\n");
+        
+        return 1;
+    }
+    
+    /* write all events */
+    pid = (int)getpid();
+    first = 1;
+    (void)fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    buffer = __atomic_load_n(&gs_head, __ATOMIC_ACQUIRE);
+    while (buffer != NULL)
+    {
+        uint32_t i;
+        uint32_t count;
+        
+        /* only read the published events */
+        count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+        for (i = 0; i < count; i++)
+        {
+            trace_event_t *e = &buffer->event[i];
+            
+            (void)fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"ch9120\",\"ph\":\"%c\",\"ts\":%llu,"
+                          "\"pid\":%d,\"tid\":%ld,\"args\":{\"cmd\":%d,\"tx\":%d,\"rx\":%d,\"status\":%d}}",
+                          first != 0 ? "" : ",", e->name, e->phase, (unsigned long long)e->timestamp_us,
+                          pid, buffer->tid, e->id, e->tx_len, e->rx_len, e->status);
+            first = 0;
+        }
+        
+        /* output the dropped events as metadata */
+        if (buffer->dropped != 0)
+        {
+            (void)fprintf(fp, "%s\n{\"name\":\"dropped\",\"ph\":\"M\",\"pid\":%d,\"tid\":%ld,\"args\":{\"count\":%u}}",
+                          first != 0 ? "" : ",", pid, buffer->tid, buffer->dropped);
+            first = 0;
+        }
+        buffer = buffer->next;
+    }
+    (void)fprintf(fp, "\n]}\n");
+    
+    /* close the file */
+    if (fclose(fp) != 0)
+    {
+        perror("trace: close failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,725 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      uring.c
+ * @brief     uring source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+
+#include "uring.h"
+#include "uart.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/**
+ * @brief uring user data definition
+ * @note  the low bits of the uart pointer carry the operation
+ */
+#define URING_OP_READ      1        /**< armed read */
+#define URING_OP_WRITE     2        /**< queued write */
+#define URING_OP_CANCEL    3        /**< read cancel */
+#define URING_OP_MASK      3        /**< operation mask */
+
+/**
+ * @brief  get the monotonic time
+ * @return time in ms
+ * @note   none
+ */
+static uint64_t a_uring_ms(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+/**
+ * @brief     get a free submission entry
+ * @param[in] *ring pointer to a uring structure
+ * @return    pointer to a cleared entry, NULL if the queue is full
+ * @note      the entry is published by a_uring_commit
+ */
+static struct io_uring_sqe *a_uring_sqe(uring_t *ring)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t index;
+    struct io_uring_sqe *sqe;
+    
+    /* check the queue space */
+    head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    tail = *ring->sq_tail;
+    if ((tail - head) >= ring->sq_entries)
+    {
+        /* submit the queued entries */
+        if (uring_run(ring, 0) != 0)
+        {
+            return NULL;
+        }
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if ((tail - head) >= ring->sq_entries)
+        {
+            return NULL;
+        }
+    }
+    
+    /* clear the entry */
+    index = tail & *ring->sq_mask;
+    sqe = &((struct io_uring_sqe *)ring->sqes)[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sq_array[index] = index;
+    
+    return sqe;
+}
+
+/**
+ * @brief     publish the last submission entry
+ * @param[in] *ring pointer to a uring structure
+ * @note      none
+ */
+static void a_uring_commit(uring_t *ring)
+{
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief     arm a read
+ * @param[in] *uart pointer to a uring uart structure
+ * @note      the read is retried by uring_uart_read when the queue is full
+ */
+static void a_uring_arm_read(uring_uart_t *uart)
+{
+    struct io_uring_sqe *sqe;
+    
+    if ((uart->read_armed != 0) || (uart->closing != 0))
+    {
+        return;
+    }
+    sqe = a_uring_sqe(uart->ring);
+    if (sqe == NULL)
+    {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = uart->fd;
+    sqe->addr = (uint64_t)(uintptr_t)uart->chunk;
+    sqe->len = URING_CHUNK_SIZE;
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = (uint64_t)(uintptr_t)uart | URING_OP_READ;
+    a_uring_commit(uart->ring);
+    uart->read_armed = 1;
+}
+
+/**
+ * @brief     arm a write of all queued data
+ * @param[in] *uart pointer to a uring uart structure
+ * @note      writes queued while one is in flight go out with the next one
+ */
+static void a_uring_arm_write(uring_uart_t *uart)
+{
+    struct io_uring_sqe *sqe;
+    
+    if ((uart->write_armed != 0) || (uart->tx_sent == uart->tx_len))
+    {
+        return;
+    }
+    sqe = a_uring_sqe(uart->ring);
+    if (sqe == NULL)
+    {
+        return;
+    }
+    uart->tx_inflight = uart->tx_len - uart->tx_sent;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = uart->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&uart->tx[uart->tx_sent];
+    sqe->len = uart->tx_inflight;
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = (uint64_t)(uintptr_t)uart | URING_OP_WRITE;
+    a_uring_commit(uart->ring);
+    uart->write_armed = 1;
+}
+
+/**
+ * @brief     handle a completion
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] op operation
+ * @param[in] res result
+ * @note      none
+ */
+static void a_uring_complete(uring_uart_t *uart, uint32_t op, int32_t res)
+{
+    int32_t i;
+    
+    if (op == URING_OP_READ)
+    {
+        /* keep the received data */
+        uart->read_armed = 0;
+        for (i = 0; i < res; i++)
+        {
+            if ((uart->rx_tail - uart->rx_head) < URING_RX_SIZE)
+            {
+                uart->rx[uart->rx_tail % URING_RX_SIZE] = uart->chunk[i];
+                uart->rx_tail++;
+            }
+            else
+            {
+                uart->rx_lost++;
+            }
+        }
+        
+        /* a failed or closed tty is re-armed by the next read */
+        if ((res > 0) || (res == -EAGAIN) || (res == -EINTR))
+        {
+            a_uring_arm_read(uart);
+        }
+    }
+    else if (op == URING_OP_WRITE)
+    {
+        uart->write_armed = 0;
+        if (res > 0)
+        {
+            uart->tx_sent += (uint32_t)res;
+            uart->tx_drain = 1;
+        }
+        else if ((res != -EAGAIN) && (res != -EINTR))
+        {
+            /* drop the queued data */
+            errno = -res;
+            perror("uring: write failed.\n");
+            uart->tx_sent = uart->tx_len;
+        }
+        else
+        {
+            
+        }
+        if (uart->tx_sent == uart->tx_len)
+        {
+            uart->tx_sent = 0;
+            uart->tx_len = 0;
+        }
+        else
+        {
+            a_uring_arm_write(uart);
+        }
+    }
+    else
+    {
+        
+    }
+}
+
+/**
+ * @brief     reap all completions
+ * @param[in] *ring pointer to a uring structure
+ * @return    number of completions
+ * @note      none
+ */
+static uint32_t a_uring_reap(uring_t *ring)
+{
+    uint32_t n;
+    uint32_t head;
+    uint64_t data;
+    int32_t res;
+    struct io_uring_cqe *cqe;
+    
+    n = 0;
+    head = *ring->cq_head;
+    while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+    {
+        /* release the slot before the handler queues new work */
+        cqe = &((struct io_uring_cqe *)ring->cqes)[head & *ring->cq_mask];
+        data = cqe->user_data;
+        res = cqe->res;
+        head++;
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+        
+        a_uring_complete((uring_uart_t *)(uintptr_t)(data & ~(uint64_t)URING_OP_MASK),
+                         (uint32_t)(data & URING_OP_MASK), res);
+        n++;
+    }
+    ring->completions += n;
+    
+    return n;
+}
+
+/**
+ * @brief     uring init
+ * @param[in] *ring pointer to a uring structure
+ * @param[in] entries submission queue entries
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      one ring serves any number of uarts
+ */
+uint8_t uring_init(uring_t *ring, uint32_t entries)
+{
+    struct io_uring_params p;
+    uint8_t *sq;
+    uint8_t *cq;
+    
+    /* setup the ring */
+    memset(ring, 0, sizeof(uring_t));
+    memset(&p, 0, sizeof(struct io_uring_params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (ring->fd < 0)
+    {
+        perror("uring: setup failed.\n");
+        
+        return 1;
+    }
+    if ((p.features & IORING_FEAT_EXT_ARG) == 0)
+    {
+        (void)fprintf(stderr, "uring: kernel is too old.\n");
+        (void)close(ring->fd);
+        
+        return 1;
+    }
+    
+    /* map the queues */
+    ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    ring->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        ring->sq_size = (ring->cq_size > ring->sq_size) ? ring->cq_size : ring->sq_size;
+        ring->cq_size = 0;
+    }
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED)
+    {
+        perror("uring: map failed.\n");
+        (void)close(ring->fd);
+        
+        return 1;
+    }
+    ring->cq_ptr = ring->sq_ptr;
+    if (ring->cq_size != 0)
+    {
+        ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED)
+        {
+            perror("uring: map failed.\n");
+            (void)munmap(ring->sq_ptr, ring->sq_size);
+            (void)close(ring->fd);
+            
+            return 1;
+        }
+    }
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        perror("uring: map failed.\n");
+        if (ring->cq_size != 0)
+        {
+            (void)munmap(ring->cq_ptr, ring->cq_size);
+        }
+        (void)munmap(ring->sq_ptr, ring->sq_size);
+        (void)close(ring->fd);
+        
+        return 1;
+    }
+    
+    /* set the queue pointers */
+    sq = (uint8_t *)ring->sq_ptr;
+    cq = (uint8_t *)ring->cq_ptr;
+    ring->sq_head = (uint32_t *)(sq + p.sq_off.head);
+    ring->sq_tail = (uint32_t *)(sq + p.sq_off.tail);
+    ring->sq_mask = (uint32_t *)(sq + p.sq_off.ring_mask);
+    ring->sq_array = (uint32_t *)(sq + p.sq_off.array);
+    ring->sq_entries = p.sq_entries;
+    ring->cq_head = (uint32_t *)(cq + p.cq_off.head);
+    ring->cq_tail = (uint32_t *)(cq + p.cq_off.tail);
+    ring->cq_mask = (uint32_t *)(cq + p.cq_off.ring_mask);
+    ring->cqes = cq + p.cq_off.cqes;
+    
+    return 0;
+}
+
+/**
+ * @brief     uring deinit
+ * @param[in] *ring pointer to a uring structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 deinit failed
+ * @note      close all uarts first
+ */
+uint8_t uring_deinit(uring_t *ring)
+{
+    (void)munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_size != 0)
+    {
+        (void)munmap(ring->cq_ptr, ring->cq_size);
+    }
+    (void)munmap(ring->sq_ptr, ring->sq_size);
+    if (close(ring->fd) < 0)
+    {
+        perror("uring: close failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     uring run
+ * @param[in] *ring pointer to a uring structure
+ * @param[in] timeout_ms max wait for a completion in ms, 0 never waits
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      submits every queued read and write with one syscall and reaps the completions
+ */
+uint8_t uring_run(uring_t *ring, uint32_t timeout_ms)
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    uint32_t submit;
+    int res;
+    
+    /* completions already posted end the wait */
+    if (a_uring_reap(ring) != 0)
+    {
+        timeout_ms = 0;
+    }
+    submit = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if ((submit == 0) && (timeout_ms == 0))
+    {
+        return 0;
+    }
+    
+    /* submit and wait with one syscall */
+    if (timeout_ms != 0)
+    {
+        memset(&arg, 0, sizeof(struct io_uring_getevents_arg));
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+        res = (int)syscall(__NR_io_uring_enter, ring->fd, submit, 1,
+                           IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+    else
+    {
+        res = (int)syscall(__NR_io_uring_enter, ring->fd, submit, 0, 0, NULL, 0);
+    }
+    ring->enters++;
+    if ((res < 0) && (errno != ETIME) && (errno != EINTR) && (errno != EBUSY))
+    {
+        perror("uring: enter failed.\n");
+        
+        return 1;
+    }
+    (void)a_uring_reap(ring);
+    
+    return 0;
+}
+
+/**
+ * @brief      uring uart open
+ * @param[in]  *ring pointer to a uring structure
+ * @param[out] *uart pointer to a uring uart structure
+ * @param[in]  *name pointer to a device name buffer
+ * @param[in]  baud_rate baud rate
+ * @param[in]  data_bits data bits
+ * @param[in]  parity data parity
+ * @param[in]  stop_bits stop bits
+ * @return     status code
+ *             - 0 success
+ *             - 1 open failed
+ * @note       a read stays armed on the uart until it is closed
+ */
+uint8_t uring_uart_open(uring_t *ring, uring_uart_t *uart, char *name,
+                        uint32_t baud_rate, uint8_t data_bits, char parity, uint8_t stop_bits)
+{
+    int flags;
+    
+    /* open and config the tty */
+    memset(uart, 0, sizeof(uring_uart_t));
+    uart->ring = ring;
+    if (uart_init(name, &uart->fd, baud_rate, data_bits, parity, stop_bits) != 0)
+    {
+        return 1;
+    }
+    
+    /* the ring waits on the tty instead of the caller */
+    flags = fcntl(uart->fd, F_GETFL, 0);
+    (void)fcntl(uart->fd, F_SETFL, flags & ~O_NONBLOCK);
+    a_uring_arm_read(uart);
+    
+    return uring_run(ring, 0);
+}
+
+/**
+ * @brief     uring uart close
+ * @param[in] *uart pointer to a uring uart structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      queued data is written first
+ */
+uint8_t uring_uart_close(uring_uart_t *uart)
+{
+    struct io_uring_sqe *sqe;
+    uint32_t i;
+    
+    /* write the queued data */
+    uart->closing = 1;
+    (void)uring_uart_drain(uart, 1000);
+    
+    /* cancel the armed read */
+    if (uart->read_armed != 0)
+    {
+        sqe = a_uring_sqe(uart->ring);
+        if (sqe != NULL)
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = (uint64_t)(uintptr_t)uart | URING_OP_READ;
+            sqe->user_data = (uint64_t)(uintptr_t)uart | URING_OP_CANCEL;
+            a_uring_commit(uart->ring);
+        }
+        for (i = 0; (i < 100) && (uart->read_armed != 0); i++)
+        {
+            (void)uring_run(uart->ring, 10);
+        }
+    }
+    
+    return uart_deinit(uart->fd);
+}
+
+/**
+ * @brief     uring uart write data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the data is queued, it is submitted by the next uring_run, read, flush or drain
+ */
+uint8_t uring_uart_write(uring_uart_t *uart, uint8_t *buf, uint32_t len)
+{
+    uint32_t l;
+    uint64_t deadline;
+    
+    deadline = a_uring_ms() + 1000;
+    while (len != 0)
+    {
+        /* wait for space */
+        while (uart->tx_len == URING_TX_SIZE)
+        {
+            a_uring_arm_write(uart);
+            if ((uring_run(uart->ring, 10) != 0) || (a_uring_ms() > deadline))
+            {
+                (void)fprintf(stderr, "uring: write timeout.\n");
+                
+                return 1;
+            }
+        }
+        
+        /* queue the data */
+        l = URING_TX_SIZE - uart->tx_len;
+        l = (len < l) ? len : l;
+        memcpy(&uart->tx[uart->tx_len], buf, l);
+        uart->tx_len += l;
+        buf += l;
+        len -= l;
+        a_uring_arm_write(uart);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief          uring uart read data
+ * @param[in]      *uart pointer to a uring uart structure
+ * @param[out]     *buf pointer to a data buffer
+ * @param[in, out] *len pointer to a length of the data buffer
+ * @return         status code
+ *                 - 0 success
+ *                 - 1 read failed
+ * @note           never waits, the ring is run once when nothing is buffered
+ */
+uint8_t uring_uart_read(uring_uart_t *uart, uint8_t *buf, uint32_t *len)
+{
+    uint32_t i;
+    
+    /* run the ring when nothing is buffered */
+    if (uart->rx_tail == uart->rx_head)
+    {
+        a_uring_arm_read(uart);
+        if (uring_run(uart->ring, 0) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* copy the received data */
+    for (i = 0; (i < *len) && (uart->rx_head != uart->rx_tail); i++)
+    {
+        buf[i] = uart->rx[uart->rx_head % URING_RX_SIZE];
+        uart->rx_head++;
+    }
+    *len = i;
+    
+    return 0;
+}
+
+/**
+ * @brief      uring uart peek the received data
+ * @param[in]  *uart pointer to a uring uart structure
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       the segments point into the rx ring and stay valid until uring_uart_consume
+ */
+uint8_t uring_uart_peek(uring_uart_t *uart, uint8_t **buf0, uint32_t *len0, uint8_t **buf1, uint32_t *len1)
+{
+    uint32_t head;
+    uint32_t used;
+    
+    /* run the ring when nothing is buffered */
+    if (uart->rx_tail == uart->rx_head)
+    {
+        a_uring_arm_read(uart);
+        if (uring_run(uart->ring, 0) != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* split on wrap */
+    head = uart->rx_head % URING_RX_SIZE;
+    used = uart->rx_tail - uart->rx_head;
+    *buf0 = &uart->rx[head];
+    *buf1 = &uart->rx[0];
+    *len0 = (used < (URING_RX_SIZE - head)) ? used : (URING_RX_SIZE - head);
+    *len1 = used - *len0;
+    
+    return 0;
+}
+
+/**
+ * @brief     uring uart consume the peeked data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint32_t uring_uart_consume(uring_uart_t *uart, uint32_t len)
+{
+    uint32_t used;
+    
+    /* move the head */
+    used = uart->rx_tail - uart->rx_head;
+    len = (len < used) ? len : used;
+    uart->rx_head += len;
+    
+    return len;
+}
+
+/**
+ * @brief     uring uart flush the received data
+ * @param[in] *uart pointer to a uring uart structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      queued data is kept
+ */
+uint8_t uring_uart_flush(uring_uart_t *uart)
+{
+    (void)uring_run(uart->ring, 0);
+    if (tcflush(uart->fd, TCIFLUSH) < 0)
+    {
+        perror("uring: flush failed.\n");
+        
+        return 1;
+    }
+    uart->rx_head = uart->rx_tail;
+    
+    return 0;
+}
+
+/**
+ * @brief     uring uart drain the queued data
+ * @param[in] *uart pointer to a uring uart structure
+ * @param[in] timeout_ms timeout in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 drain failed
+ * @note      returns when the tty has transmitted everything
+ */
+uint8_t uring_uart_drain(uring_uart_t *uart, uint32_t timeout_ms)
+{
+    uint64_t deadline;
+    
+    if ((uart->tx_len == 0) && (uart->write_armed == 0) && (uart->tx_drain == 0))
+    {
+        return 0;
+    }
+    deadline = a_uring_ms() + timeout_ms;
+    while ((uart->tx_len != 0) || (uart->write_armed != 0))
+    {
+        a_uring_arm_write(uart);
+        if ((uring_run(uart->ring, 10) != 0) || (a_uring_ms() > deadline))
+        {
+            (void)fprintf(stderr, "uring: drain timeout.\n");
+            
+            return 1;
+        }
+    }
+    if (tcdrain(uart->fd) < 0)
+    {
+        perror("uring: drain failed.\n");
+        
+        return 1;
+    }
+    uart->tx_drain = 0;
+    
+    return 0;
+}
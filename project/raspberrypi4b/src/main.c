@@ -37,7 +37,12 @@
 #include "driver_ch9120_basic.h"
 #include "driver_ch9120_register_test.h"
 #include "driver_ch9120_net_test.h"
+#include "driver_ch9120_fault_test.h"
+#include "driver_ch9120_monitor_test.h"
+#include "driver_ch9120_client_test.h"
+#include "driver_ch9120_frame_test.h"
 #include "shell.h"
+#include "trace.h"
 #include <getopt.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -85,10 +90,12 @@ uint8_t ch9120(uint8_t argc, char **argv)
         {"mode", required_argument, NULL, 6},
         {"sip", required_argument, NULL, 7},
         {"sport", required_argument, NULL, 8},
+        {"file", required_argument, NULL, 9},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
     char data[49] = "LibDriver";
+    char file[129] = "ch9120_trace.json";
     uint8_t dest_ip[4] = {192, 168, 1, 10};
     uint16_t dest_port = 1000;
     uint8_t gateway[4] = {192, 168, 1, 1};
@@ -283,6 +290,16 @@ uint8_t ch9120(uint8_t argc, char **argv)
                 break;
             } 
             
+            /* file */
+            case 9 :
+            {
+                /* copy file */
+                memset(file, 0, sizeof(char) * 129);
+                strncpy(file, optarg, 128);
+                
+                break;
+            } 
+            
             /* the end */
             case -1 :
             {
@@ -308,6 +325,52 @@ uint8_t ch9120(uint8_t argc, char **argv)
         
         return 0;
     }
+    else if (strcmp("t_fault", type) == 0)
+    {
+        /* run fault test */
+        if (ch9120_fault_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_monitor", type) == 0)
+    {
+        /* run monitor test */
+        if (ch9120_monitor_test(30) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_client", type) == 0)
+    {
+        ch9120_client_dest_t dest;
+        
+        /* set the dest */
+        memcpy(dest.ip, dest_ip, 4);
+        dest.port = dest_port;
+        
+        /* run client test */
+        if (ch9120_client_test(&dest, 1, 60) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_frame", type) == 0)
+    {
+        /* run frame test */
+        if (ch9120_frame_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
     else if (strcmp("t_net", type) == 0)
     {
         /* run net test */
@@ -397,6 +460,19 @@ uint8_t ch9120(uint8_t argc, char **argv)
         
         return 0;
     }
+    else if (strcmp("e_trace-export", type) == 0)
+    {
+        /* export the trace */
+        if (trace_export(file) != 0)
+        {
+            return 1;
+        }
+        
+        /* output */
+        ch9120_interface_debug_print("ch9120: trace export %s.\n", file);
+        
+        return 0;
+    }
     else if (strcmp("h", type) == 0)
     {
         help:
@@ -405,6 +481,10 @@ uint8_t ch9120(uint8_t argc, char **argv)
         ch9120_interface_debug_print("  ch9120 (-h | --help)\n");
         ch9120_interface_debug_print("  ch9120 (-p | --port)\n");
         ch9120_interface_debug_print("  ch9120 (-t reg | --test=reg)\n");
+        ch9120_interface_debug_print("  ch9120 (-t fault | --test=fault)\n");
+        ch9120_interface_debug_print("  ch9120 (-t monitor | --test=monitor)\n");
+        ch9120_interface_debug_print("  ch9120 (-t client | --test=client) [--dip=<dip>] [--dport=<dport>]\n");
+        ch9120_interface_debug_print("  ch9120 (-t frame | --test=frame)\n");
         ch9120_interface_debug_print("  ch9120 (-t net | --test=net) [--mode=<TCP_CLIENT | TCP_SERVER | UDP_CLIENT | UDP_SERVER>]\n");
         ch9120_interface_debug_print("  ch9120 (-e net-init | --example=net-init)\n");
         ch9120_interface_debug_print("  ch9120 (-e net-deinit | --example=net-deinit)\n");
@@ -412,13 +492,15 @@ uint8_t ch9120(uint8_t argc, char **argv)
         ch9120_interface_debug_print("         [--sip=<sip>] [--sport=<sport>] [--mask=<mask>] [--gateway=<gateway>] [--dip=<dip>] [--dport=<dport>]\n");
         ch9120_interface_debug_print("  ch9120 (-e net-write | --example=net-write) [--data=<str>]\n");
         ch9120_interface_debug_print("  ch9120 (-e net-read | --example=net-read)\n");
+        ch9120_interface_debug_print("  ch9120 (-e trace-export | --example=trace-export) [--file=<path>]\n");
         ch9120_interface_debug_print("\n");
         ch9120_interface_debug_print("Options:\n");
-        ch9120_interface_debug_print("  -e <net-init | net-deinit | net-cfg | net-write | net-read>, --example=<net-init | net-deinit | net-cfg | net-write | net-read>\n");
+        ch9120_interface_debug_print("  -e <net-init | net-deinit | net-cfg | net-write | net-read | trace-export>, --example=<net-init | net-deinit | net-cfg | net-write | net-read | trace-export>\n");
         ch9120_interface_debug_print("                             Run the driver example.\n");
         ch9120_interface_debug_print("      --data=<str>           Set write data.([default: LibDriver])\n");
         ch9120_interface_debug_print("      --dip=<dip>            Set the dest ip.([default: 192.168.1.10])\n");
         ch9120_interface_debug_print("      --dport=<dport>        Set dest port.([default: 1000])\n");
+        ch9120_interface_debug_print("      --file=<path>          Set the trace export file.([default: ch9120_trace.json])\n");
         ch9120_interface_debug_print("      --gateway=<gateway>    Set the gateway.([default: 192.168.1.1])\n");
         ch9120_interface_debug_print("  -h, --help                 Show the help.\n");
         ch9120_interface_debug_print("  -i, --information          Show the chip information.\n");
@@ -428,7 +510,7 @@ uint8_t ch9120(uint8_t argc, char **argv)
         ch9120_interface_debug_print("  -p, --port                 Display the pin connections of the current board.\n");
         ch9120_interface_debug_print("      --sip=<sip>            Set the source ip.([default: 192.168.1.230])\n");
         ch9120_interface_debug_print("      --sport=<sport>        Set source port.([default: 2000])\n");
-        ch9120_interface_debug_print("  -t <reg | net>, --test=<reg | net>\n");
+        ch9120_interface_debug_print("  -t <reg | fault | monitor | client | frame | net>, --test=<reg | fault | monitor | client | frame | net>\n");
         ch9120_interface_debug_print("                             Run the driver test.\n");
           
         return 0;
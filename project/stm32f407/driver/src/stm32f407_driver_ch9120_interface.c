@@ -40,6 +40,13 @@
 #include "wire.h"
 #include <stdarg.h>
 
+/**
+ * @brief lock flag definition
+ */
+#define LOCK_HANDLE_NUM    2                                /**< handles with locks */
+static volatile uint8_t gs_lock[LOCK_HANDLE_NUM][2];        /**< cfg and io lock flag of each handle */
+static volatile uint8_t gs_lock_used[LOCK_HANDLE_NUM];      /**< lock pair used flag */
+
 /**
  * @brief  interface uart init
  * @return status code
@@ -90,6 +97,39 @@ uint8_t ch9120_interface_uart_flush(void)
     return uart2_flush();
 }
 
+/**
+ * @brief      interface uart peek
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 peek failed
+ * @note       none
+ */
+uint8_t ch9120_interface_uart_peek(ch9120_view_t *view)
+{
+    uart2_peek(&view->buf[0], &view->len[0], &view->buf[1], &view->len[1]);
+    
+    return 0;
+}
+
+/**
+ * @brief     interface uart consume
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 consume failed
+ * @note      none
+ */
+uint8_t ch9120_interface_uart_consume(uint16_t len)
+{
+    if (uart2_consume(len) != len)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
 /**
  * @brief     interface uart write
  * @param[in] *buf pointer to a data buffer
@@ -207,3 +247,199 @@ void ch9120_interface_debug_print(const char *const fmt, ...)
     len = strlen((char *)str);
     (void)uart_write((uint8_t *)str, len);
 }
+
+/**
+ * @brief  interface timestamp us
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t ch9120_interface_timestamp_us(void)
+{
+    return delay_timestamp_us();
+}
+
+/**
+ * @brief     interface trace begin
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_begin(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief     interface trace end
+ * @param[in] *trace pointer to a trace structure
+ * @note      none
+ */
+void ch9120_interface_trace_end(const ch9120_trace_t *trace)
+{
+    
+}
+
+/**
+ * @brief      interface storage read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       no storage is reserved on this board
+ */
+uint8_t ch9120_interface_storage_read(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface storage write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      no storage is reserved on this board
+ */
+uint8_t ch9120_interface_storage_write(uint8_t *buf, uint16_t len)
+{
+    return 1;
+}
+
+/**
+ * @brief     interface crc32
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    crc-32 of the data
+ * @note      the crc unit runs on bit reversed words, the tail bytes are done in software
+ */
+uint32_t ch9120_interface_crc32(uint8_t *buf, uint16_t len)
+{
+    uint8_t i;
+    uint32_t crc;
+    uint32_t w;
+    
+    __HAL_RCC_CRC_CLK_ENABLE();
+    CRC->CR = CRC_CR_RESET;
+    while (len >= 4)
+    {
+        w = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | 
+            ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        CRC->DR = __RBIT(w);
+        buf += 4;
+        len -= 4;
+    }
+    crc = __RBIT(CRC->DR);
+    while (len != 0)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+        len--;
+    }
+    
+    return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief      interface mutex init
+ * @param[out] **ctx pointer to a mutex context buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 mutex init failed
+ * @note       the context is a free cfg and io lock pair, LOCK_HANDLE_NUM handles can lock at once
+ */
+uint8_t ch9120_interface_mutex_init(void **ctx)
+{
+    uint8_t i;
+    uint32_t primask;
+    
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (i = 0; i < LOCK_HANDLE_NUM; i++)
+    {
+        if (gs_lock_used[i] == 0)
+        {
+            gs_lock_used[i] = 1;
+            gs_lock[i][0] = 0;
+            gs_lock[i][1] = 0;
+            *ctx = (void *)gs_lock[i];
+            __set_PRIMASK(primask);
+            
+            return 0;
+        }
+    }
+    __set_PRIMASK(primask);
+    
+    return 1;
+}
+
+/**
+ * @brief     interface mutex deinit
+ * @param[in] *ctx pointer to a mutex context
+ * @note      none
+ */
+void ch9120_interface_mutex_deinit(void *ctx)
+{
+    uint8_t i;
+    
+    for (i = 0; i < LOCK_HANDLE_NUM; i++)
+    {
+        if ((void *)gs_lock[i] == ctx)
+        {
+            __DMB();
+            gs_lock_used[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief     interface mutex lock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @param[in] wait 1 blocks until the lock is free, 0 returns at once
+ * @return    status code
+ *            - 0 success
+ *            - 1 lock is busy
+ * @note      the interrupts are only masked while the flag is tested,
+ *            an interrupt handler must use wait 0 or it spins forever on the owner it preempted
+ */
+uint8_t ch9120_interface_mutex_lock(void *ctx, uint8_t id, uint8_t wait)
+{
+    volatile uint8_t *lock = (volatile uint8_t *)ctx;
+    uint8_t taken;
+    uint32_t primask;
+    
+    while (1)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        taken = (lock[id] == 0) ? 1 : 0;
+        lock[id] = 1;
+        __set_PRIMASK(primask);
+        if (taken != 0)
+        {
+            return 0;
+        }
+        if (wait == 0)
+        {
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief     interface mutex unlock
+ * @param[in] *ctx pointer to a mutex context
+ * @param[in] id lock id
+ * @note      none
+ */
+void ch9120_interface_mutex_unlock(void *ctx, uint8_t id)
+{
+    volatile uint8_t *lock = (volatile uint8_t *)ctx;
+    
+    __DMB();
+    lock[id] = 0;
+}
@@ -164,10 +164,28 @@ uint8_t uart2_write(uint8_t *buf, uint16_t len);
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len data length
  * @return     length of the read data
- * @note       this function will clear all received buffer even read length is less than received length
+ * @note       the data which is not read stays in the buffer
  */
 uint16_t uart2_read(uint8_t *buf, uint16_t len);
 
+/**
+ * @brief      uart2 peek data
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @note       the segments point into the rx buffer and stay valid until uart2_consume
+ */
+void uart2_peek(uint8_t **buf0, uint16_t *len0, uint8_t **buf1, uint16_t *len1);
+
+/**
+ * @brief     uart2 consume data
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint16_t uart2_consume(uint16_t len);
+
 /**
  * @brief  uart2 flush data
  * @return status code
@@ -191,7 +209,7 @@ void uart2_set_tx_done(void);
 
 /**
  * @brief uart2 irq handler
- * @note  none
+ * @note  one slot is kept free to tell a full ring from an empty one
  */
 void uart2_irq_handler(void);
 
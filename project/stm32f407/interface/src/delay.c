@@ -107,3 +107,29 @@ void delay_ms(uint32_t ms)
     /* use the hal delay */
     HAL_Delay(ms);
 }
+
+/**
+ * @brief  delay get the timestamp
+ * @return monotonic timestamp in us
+ * @note   none
+ */
+uint64_t delay_timestamp_us(void)
+{
+    uint32_t ms;
+    uint32_t val;
+    
+    /* read the tick and the counter in the same ms */
+    do
+    {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    
+    /* check the fac */
+    if (gs_fac_us == 0)
+    {
+        return (uint64_t)ms * 1000;
+    }
+    
+    return (uint64_t)ms * 1000 + (SysTick->LOAD - val) / gs_fac_us;
+}
@@ -55,6 +55,7 @@ UART_HandleTypeDef g_uart2_handle;               /**< uart2 handle */
 uint8_t g_uart2_rx_buffer[UART2_MAX_LEN];        /**< uart2 rx buffer */
 uint8_t g_uart2_buffer;                          /**< uart2 one buffer */
 volatile uint16_t g_uart2_point;                 /**< uart2 rx point */
+volatile uint16_t g_uart2_head;                  /**< uart2 rx read point */
 volatile uint8_t g_uart2_tx_done;                /**< uart2 tx done flag */
 
 /**
@@ -321,30 +322,85 @@ uint8_t uart2_write(uint8_t *buf, uint16_t len)
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len data length
  * @return     length of the read data
- * @note       this function will clear all received buffer even read length is less than received length
+ * @note       the data which is not read stays in the buffer
  */
 uint16_t uart2_read(uint8_t *buf, uint16_t len)
 {
-    uint16_t read_len;
+    uint8_t *buf0;
+    uint8_t *buf1;
+    uint16_t len0;
+    uint16_t len1;
     uint16_t g_uart_point_old;
     
     /* check receiving */
     start:
     g_uart_point_old = g_uart2_point;
     HAL_Delay(1);
-    if (g_uart2_point > g_uart_point_old)
+    if (g_uart2_point != g_uart_point_old)
     {
         goto start;
     }
     
     /* copy the data */
-    read_len = (len < g_uart2_point) ? len : g_uart2_point;
-    memcpy(buf, g_uart2_rx_buffer, read_len);
+    uart2_peek(&buf0, &len0, &buf1, &len1);
+    len0 = (len < len0) ? len : len0;
+    len1 = ((len - len0) < len1) ? (len - len0) : len1;
+    memcpy(buf, buf0, len0);
+    memcpy(buf + len0, buf1, len1);
     
-    /* clear the buffer */
-    g_uart2_point = 0;
+    return uart2_consume(len0 + len1);
+}
+
+/**
+ * @brief      uart2 peek data
+ * @param[out] **buf0 pointer to the first segment
+ * @param[out] *len0 pointer to the first segment length
+ * @param[out] **buf1 pointer to the wrapped segment
+ * @param[out] *len1 pointer to the wrapped segment length
+ * @note       the segments point into the rx buffer and stay valid until uart2_consume
+ */
+void uart2_peek(uint8_t **buf0, uint16_t *len0, uint8_t **buf1, uint16_t *len1)
+{
+    uint16_t head;
+    uint16_t tail;
     
-    return read_len;
+    /* get the ring */
+    head = g_uart2_head;
+    tail = g_uart2_point;
+    
+    /* split on wrap */
+    *buf0 = &g_uart2_rx_buffer[head];
+    *buf1 = &g_uart2_rx_buffer[0];
+    if (tail >= head)
+    {
+        *len0 = tail - head;
+        *len1 = 0;
+    }
+    else
+    {
+        *len0 = UART2_MAX_LEN - head;
+        *len1 = tail;
+    }
+}
+
+/**
+ * @brief     uart2 consume data
+ * @param[in] len length of the peeked data
+ * @return    length of the removed data
+ * @note      none
+ */
+uint16_t uart2_consume(uint16_t len)
+{
+    uint16_t used;
+    
+    /* check the length */
+    used = (uint16_t)((g_uart2_point + UART2_MAX_LEN - g_uart2_head) % UART2_MAX_LEN);
+    len = (len < used) ? len : used;
+    
+    /* move the read point */
+    g_uart2_head = (uint16_t)((g_uart2_head + len) % UART2_MAX_LEN);
+    
+    return len;
 }
 
 /**
@@ -356,7 +412,7 @@ uint16_t uart2_read(uint8_t *buf, uint16_t len)
 uint16_t uart2_flush(void)
 {
     /* clear the buffer */
-    g_uart2_point = 0;
+    g_uart2_head = g_uart2_point;
     
     return 0;
 }
@@ -419,16 +475,18 @@ void uart_irq_handler(void)
 
 /**
  * @brief uart2 irq handler
- * @note  none
+ * @note  one slot is kept free to tell a full ring from an empty one
  */
 void uart2_irq_handler(void)
 {
-    /* save one byte */
-    g_uart2_rx_buffer[g_uart2_point] = g_uart2_buffer;
-    g_uart2_point++;
-    if (g_uart2_point > (UART2_MAX_LEN - 1))
+    uint16_t next;
+    
+    /* save one byte, drop it when the ring is full */
+    next = (uint16_t)((g_uart2_point + 1) % UART2_MAX_LEN);
+    if (next != g_uart2_head)
     {
-        g_uart2_point = 0;
+        g_uart2_rx_buffer[g_uart2_point] = g_uart2_buffer;
+        g_uart2_point = next;
     }
     
     /* receive one byte */
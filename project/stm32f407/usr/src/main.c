@@ -37,6 +37,10 @@
 #include "driver_ch9120_basic.h"
 #include "driver_ch9120_register_test.h"
 #include "driver_ch9120_net_test.h"
+#include "driver_ch9120_fault_test.h"
+#include "driver_ch9120_monitor_test.h"
+#include "driver_ch9120_client_test.h"
+#include "driver_ch9120_frame_test.h"
 #include "shell.h"
 #include "clock.h"
 #include "delay.h"
@@ -304,6 +308,52 @@ uint8_t ch9120(uint8_t argc, char **argv)
         
         return 0;
     }
+    else if (strcmp("t_fault", type) == 0)
+    {
+        /* run fault test */
+        if (ch9120_fault_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_monitor", type) == 0)
+    {
+        /* run monitor test */
+        if (ch9120_monitor_test(30) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_client", type) == 0)
+    {
+        ch9120_client_dest_t dest;
+        
+        /* set the dest */
+        memcpy(dest.ip, dest_ip, 4);
+        dest.port = dest_port;
+        
+        /* run client test */
+        if (ch9120_client_test(&dest, 1, 60) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_frame", type) == 0)
+    {
+        /* run frame test */
+        if (ch9120_frame_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
     else if (strcmp("t_net", type) == 0)
     {
         /* run net test */
@@ -401,6 +451,10 @@ uint8_t ch9120(uint8_t argc, char **argv)
         ch9120_interface_debug_print("  ch9120 (-h | --help)\n");
         ch9120_interface_debug_print("  ch9120 (-p | --port)\n");
         ch9120_interface_debug_print("  ch9120 (-t reg | --test=reg)\n");
+        ch9120_interface_debug_print("  ch9120 (-t fault | --test=fault)\n");
+        ch9120_interface_debug_print("  ch9120 (-t monitor | --test=monitor)\n");
+        ch9120_interface_debug_print("  ch9120 (-t client | --test=client) [--dip=<dip>] [--dport=<dport>]\n");
+        ch9120_interface_debug_print("  ch9120 (-t frame | --test=frame)\n");
         ch9120_interface_debug_print("  ch9120 (-t net | --test=net) [--mode=<TCP_CLIENT | TCP_SERVER | UDP_CLIENT | UDP_SERVER>]\n");
         ch9120_interface_debug_print("  ch9120 (-e net-init | --example=net-init)\n");
         ch9120_interface_debug_print("  ch9120 (-e net-deinit | --example=net-deinit)\n");
@@ -424,7 +478,7 @@ uint8_t ch9120(uint8_t argc, char **argv)
         ch9120_interface_debug_print("  -p, --port                 Display the pin connections of the current board.\n");
         ch9120_interface_debug_print("      --sip=<sip>            Set the source ip.([default: 192.168.1.230])\n");
         ch9120_interface_debug_print("      --sport=<sport>        Set source port.([default: 2000])\n");
-        ch9120_interface_debug_print("  -t <reg | net>, --test=<reg | net>\n");
+        ch9120_interface_debug_print("  -t <reg | fault | monitor | client | frame | net>, --test=<reg | fault | monitor | client | frame | net>\n");
         ch9120_interface_debug_print("                             Run the driver test.\n");
           
         return 0;
@@ -48,6 +48,15 @@
 #define TEMPERATURE_MAX           85.0f               /**< chip max operating temperature */
 #define DRIVER_VERSION            1000                /**< driver version */
 
+/**
+ * @brief debug print definition
+ */
+#if (CH9120_ENABLE_DEBUG_PRINT == 1)
+    #define CH9120_DEBUG_PRINT(HANDLE, ...)    (HANDLE)->debug_print(__VA_ARGS__)
+#else
+    #define CH9120_DEBUG_PRINT(HANDLE, ...)    (void)(HANDLE)
+#endif
+
 /**
  * @brief chip command definition
  */
@@ -86,6 +95,590 @@
 #define CH9120_CMD_GET_LEN                  0x75        /**< get package length command */
 #define CH9120_CMD_GET_FLUSH                0x76        /**< get flush command */
 
+/**
+ * @brief pending flag definition
+ */
+#define CH9120_PENDING_RESET                (1 << 1)    /**< parameters need a reset */
+
+/**
+ * @brief cached parameter definition
+ */
+#define CH9120_PARAM_INDEX_LEN              12                             /**< package length index in gs_param_cmd */
+#define CH9120_PARAM_VALID_LEN              (1U << CH9120_PARAM_INDEX_LEN) /**< package length valid bit */
+
+/**
+ * @brief record definition
+ */
+#define CH9120_RECORD_MAGIC                 0x39313230U /**< record magic */
+
+/**
+ * @brief frame definition
+ */
+#define CH9120_SLIP_END                     0xC0        /**< slip frame end */
+#define CH9120_SLIP_ESC                     0xDB        /**< slip escape */
+#define CH9120_SLIP_ESC_END                 0xDC        /**< slip escaped frame end */
+#define CH9120_SLIP_ESC_ESC                 0xDD        /**< slip escaped escape */
+#define CH9120_FRAME_CHUNK                  64          /**< frame encode chunk */
+#define CH9120_ZIP_RAW                      0x00        /**< stored payload */
+#define CH9120_ZIP_LZ                       0x01        /**< lz compressed payload */
+#define CH9120_ZIP_HASH_BITS                7           /**< match finder hash bits */
+#define CH9120_ZIP_WINDOW                   2048        /**< max match offset */
+#define CH9120_ZIP_MIN_MATCH                3           /**< min match length */
+
+/**
+ * @brief pool definition
+ */
+#define CH9120_POOL_EMPTY                   0xFFFF      /**< free list end */
+#define CH9120_POOL_OWN_TX                  (1 << 0)    /**< coalesce buffer is a pool block */
+#define CH9120_POOL_OWN_FRAME               (1 << 1)    /**< frame decode buffer is a pool block */
+#define CH9120_POOL_OWN_ZIP                 (1 << 2)    /**< compress buffer is a pool block */
+
+/**
+ * @brief async command state definition
+ */
+#define CH9120_ASYNC_IDLE                   0           /**< no command */
+#define CH9120_ASYNC_WRITTEN                1           /**< command written, waiting for the first poll */
+#define CH9120_ASYNC_READING                2           /**< waiting for the answer */
+
+/**
+ * @brief cached setter command table
+ */
+static const uint8_t gs_param_cmd[CH9120_PARAM_NUM] =
+{
+    CH9120_CMD_SET_MODE, CH9120_CMD_SET_IP, CH9120_CMD_SET_NETMASK,
+    CH9120_CMD_SET_GATEWAY, CH9120_CMD_SET_PORT, CH9120_CMD_SET_DST_IP,
+    CH9120_CMD_SET_DST_PORT, CH9120_CMD_RANDOM_PORT, CH9120_CMD_SET_BAUD,
+    CH9120_CMD_SET_CONFIG, CH9120_CMD_SET_TIMEOUT, CH9120_CMD_SET_DISCONNECT,
+    CH9120_CMD_SET_LEN, CH9120_CMD_SET_FLUSH, CH9120_CMD_DHCP,
+};
+
+/**
+ * @brief command flag definition
+ */
+#define CH9120_EXEC_FLAG_BOOT               (1 << 0)    /**< the chip reboots, wait until it answers */
+#define CH9120_EXEC_TIMEOUT                 1000        /**< answer timeout in ms, the answer is read after CH9120_UART_PRE_DELAY */
+
+/**
+ * @brief command descriptor structure definition
+ */
+typedef struct ch9120_exec_desc_s
+{
+    uint8_t cmd;                /**< command */
+    uint8_t in_len;             /**< payload length */
+    uint8_t out_len;            /**< response length, 0 waits for the 0xAA answer */
+    uint8_t flag;               /**< command flag */
+} ch9120_exec_desc_t;
+
+/**
+ * @brief command table, indexed by ch9120_command_t
+ */
+static const ch9120_exec_desc_t gs_exec_table[CH9120_COMMAND_NUM] =
+{
+    {CH9120_CMD_CHIP_VERSION,   0, 1, 0},                        /* get version */
+    {CH9120_CMD_RESET,          0, 0, CH9120_EXEC_FLAG_BOOT},    /* reset */
+    {CH9120_CMD_GET_STATUS,     0, 1, 0},                        /* get status */
+    {CH9120_CMD_SAVE_TO_EEPROM, 0, 0, 0},                        /* save to eeprom */
+    {CH9120_CMD_RUN_AND_RESET,  0, 0, CH9120_EXEC_FLAG_BOOT},    /* config and reset */
+    {CH9120_CMD_EXIT,           0, 0, 0},                        /* exit */
+    {CH9120_CMD_SET_MODE,       1, 0, 0},                        /* set mode */
+    {CH9120_CMD_GET_MODE,       0, 1, 0},                        /* get mode */
+    {CH9120_CMD_SET_IP,         4, 0, 0},                        /* set ip */
+    {CH9120_CMD_GET_IP,         0, 4, 0},                        /* get ip */
+    {CH9120_CMD_SET_NETMASK,    4, 0, 0},                        /* set subnet mask */
+    {CH9120_CMD_GET_NETMASK,    0, 4, 0},                        /* get subnet mask */
+    {CH9120_CMD_SET_GATEWAY,    4, 0, 0},                        /* set gateway */
+    {CH9120_CMD_GET_GATEWAY,    0, 4, 0},                        /* get gateway */
+    {CH9120_CMD_SET_PORT,       2, 0, 0},                        /* set source port */
+    {CH9120_CMD_GET_PORT,       0, 2, 0},                        /* get source port */
+    {CH9120_CMD_SET_DST_IP,     4, 0, 0},                        /* set dest ip */
+    {CH9120_CMD_GET_DST_IP,     0, 4, 0},                        /* get dest ip */
+    {CH9120_CMD_SET_DST_PORT,   2, 0, 0},                        /* set dest port */
+    {CH9120_CMD_GET_DST_PORT,   0, 2, 0},                        /* get dest port */
+    {CH9120_CMD_RANDOM_PORT,    1, 0, 0},                        /* set source port random */
+    {CH9120_CMD_SET_BAUD,       4, 0, 0},                        /* set uart baud */
+    {CH9120_CMD_GET_BAUD,       0, 4, 0},                        /* get uart baud */
+    {CH9120_CMD_SET_CONFIG,     3, 0, 0},                        /* set uart config */
+    {CH9120_CMD_GET_CONFIG,     0, 3, 0},                        /* get uart config */
+    {CH9120_CMD_SET_TIMEOUT,    4, 0, 0},                        /* set uart timeout */
+    {CH9120_CMD_GET_TIMEOUT,    0, 1, 0},                        /* get uart timeout */
+    {CH9120_CMD_SET_LEN,        4, 0, 0},                        /* set uart buffer length */
+    {CH9120_CMD_GET_LEN,        0, 4, 0},                        /* get uart buffer length */
+    {CH9120_CMD_SET_FLUSH,      1, 0, 0},                        /* set uart flush */
+    {CH9120_CMD_GET_FLUSH,      0, 1, 0},                        /* get uart flush */
+    {CH9120_CMD_SET_DISCONNECT, 1, 0, 0},                        /* set disconnect with no rj45 */
+    {CH9120_CMD_GET_DISCONNECT, 0, 1, 0},                        /* get disconnect with no rj45 */
+    {CH9120_CMD_DHCP,           1, 0, 0},                        /* set dhcp */
+};
+
+/**
+ * @brief parameter getter table, indexed like gs_param_cmd, CH9120_COMMAND_NUM has no getter
+ */
+static const ch9120_command_t gs_param_get[CH9120_PARAM_NUM] =
+{
+    CH9120_COMMAND_GET_MODE, CH9120_COMMAND_GET_IP, CH9120_COMMAND_GET_SUBNET_MASK,
+    CH9120_COMMAND_GET_GATEWAY, CH9120_COMMAND_GET_SOURCE_PORT, CH9120_COMMAND_GET_DEST_IP,
+    CH9120_COMMAND_GET_DEST_PORT, CH9120_COMMAND_NUM, CH9120_COMMAND_GET_UART_BAUD,
+    CH9120_COMMAND_GET_UART_CONFIG, CH9120_COMMAND_GET_UART_TIMEOUT, CH9120_COMMAND_GET_DISCONNECT_WITH_NO_RJ45,
+    CH9120_COMMAND_GET_UART_BUFFER_LENGTH, CH9120_COMMAND_GET_UART_FLUSH, CH9120_COMMAND_NUM,
+};
+
+#if (CH9120_ENABLE_FRAME == 1)
+/**
+ * @brief crc-16/ccitt-false table, poly 0x1021
+ */
+static const uint16_t gs_crc16_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+/**
+ * @brief crc-32 table, reflected poly 0xEDB88320
+ */
+static const uint32_t gs_crc32_table[256] =
+{
+    0x00000000U, 0x77073096U, 0xEE0E612CU, 0x990951BAU, 0x076DC419U, 0x706AF48FU,
+    0xE963A535U, 0x9E6495A3U, 0x0EDB8832U, 0x79DCB8A4U, 0xE0D5E91EU, 0x97D2D988U,
+    0x09B64C2BU, 0x7EB17CBDU, 0xE7B82D07U, 0x90BF1D91U, 0x1DB71064U, 0x6AB020F2U,
+    0xF3B97148U, 0x84BE41DEU, 0x1ADAD47DU, 0x6DDDE4EBU, 0xF4D4B551U, 0x83D385C7U,
+    0x136C9856U, 0x646BA8C0U, 0xFD62F97AU, 0x8A65C9ECU, 0x14015C4FU, 0x63066CD9U,
+    0xFA0F3D63U, 0x8D080DF5U, 0x3B6E20C8U, 0x4C69105EU, 0xD56041E4U, 0xA2677172U,
+    0x3C03E4D1U, 0x4B04D447U, 0xD20D85FDU, 0xA50AB56BU, 0x35B5A8FAU, 0x42B2986CU,
+    0xDBBBC9D6U, 0xACBCF940U, 0x32D86CE3U, 0x45DF5C75U, 0xDCD60DCFU, 0xABD13D59U,
+    0x26D930ACU, 0x51DE003AU, 0xC8D75180U, 0xBFD06116U, 0x21B4F4B5U, 0x56B3C423U,
+    0xCFBA9599U, 0xB8BDA50FU, 0x2802B89EU, 0x5F058808U, 0xC60CD9B2U, 0xB10BE924U,
+    0x2F6F7C87U, 0x58684C11U, 0xC1611DABU, 0xB6662D3DU, 0x76DC4190U, 0x01DB7106U,
+    0x98D220BCU, 0xEFD5102AU, 0x71B18589U, 0x06B6B51FU, 0x9FBFE4A5U, 0xE8B8D433U,
+    0x7807C9A2U, 0x0F00F934U, 0x9609A88EU, 0xE10E9818U, 0x7F6A0DBBU, 0x086D3D2DU,
+    0x91646C97U, 0xE6635C01U, 0x6B6B51F4U, 0x1C6C6162U, 0x856530D8U, 0xF262004EU,
+    0x6C0695EDU, 0x1B01A57BU, 0x8208F4C1U, 0xF50FC457U, 0x65B0D9C6U, 0x12B7E950U,
+    0x8BBEB8EAU, 0xFCB9887CU, 0x62DD1DDFU, 0x15DA2D49U, 0x8CD37CF3U, 0xFBD44C65U,
+    0x4DB26158U, 0x3AB551CEU, 0xA3BC0074U, 0xD4BB30E2U, 0x4ADFA541U, 0x3DD895D7U,
+    0xA4D1C46DU, 0xD3D6F4FBU, 0x4369E96AU, 0x346ED9FCU, 0xAD678846U, 0xDA60B8D0U,
+    0x44042D73U, 0x33031DE5U, 0xAA0A4C5FU, 0xDD0D7CC9U, 0x5005713CU, 0x270241AAU,
+    0xBE0B1010U, 0xC90C2086U, 0x5768B525U, 0x206F85B3U, 0xB966D409U, 0xCE61E49FU,
+    0x5EDEF90EU, 0x29D9C998U, 0xB0D09822U, 0xC7D7A8B4U, 0x59B33D17U, 0x2EB40D81U,
+    0xB7BD5C3BU, 0xC0BA6CADU, 0xEDB88320U, 0x9ABFB3B6U, 0x03B6E20CU, 0x74B1D29AU,
+    0xEAD54739U, 0x9DD277AFU, 0x04DB2615U, 0x73DC1683U, 0xE3630B12U, 0x94643B84U,
+    0x0D6D6A3EU, 0x7A6A5AA8U, 0xE40ECF0BU, 0x9309FF9DU, 0x0A00AE27U, 0x7D079EB1U,
+    0xF00F9344U, 0x8708A3D2U, 0x1E01F268U, 0x6906C2FEU, 0xF762575DU, 0x806567CBU,
+    0x196C3671U, 0x6E6B06E7U, 0xFED41B76U, 0x89D32BE0U, 0x10DA7A5AU, 0x67DD4ACCU,
+    0xF9B9DF6FU, 0x8EBEEFF9U, 0x17B7BE43U, 0x60B08ED5U, 0xD6D6A3E8U, 0xA1D1937EU,
+    0x38D8C2C4U, 0x4FDFF252U, 0xD1BB67F1U, 0xA6BC5767U, 0x3FB506DDU, 0x48B2364BU,
+    0xD80D2BDAU, 0xAF0A1B4CU, 0x36034AF6U, 0x41047A60U, 0xDF60EFC3U, 0xA867DF55U,
+    0x316E8EEFU, 0x4669BE79U, 0xCB61B38CU, 0xBC66831AU, 0x256FD2A0U, 0x5268E236U,
+    0xCC0C7795U, 0xBB0B4703U, 0x220216B9U, 0x5505262FU, 0xC5BA3BBEU, 0xB2BD0B28U,
+    0x2BB45A92U, 0x5CB36A04U, 0xC2D7FFA7U, 0xB5D0CF31U, 0x2CD99E8BU, 0x5BDEAE1DU,
+    0x9B64C2B0U, 0xEC63F226U, 0x756AA39CU, 0x026D930AU, 0x9C0906A9U, 0xEB0E363FU,
+    0x72076785U, 0x05005713U, 0x95BF4A82U, 0xE2B87A14U, 0x7BB12BAEU, 0x0CB61B38U,
+    0x92D28E9BU, 0xE5D5BE0DU, 0x7CDCEFB7U, 0x0BDBDF21U, 0x86D3D2D4U, 0xF1D4E242U,
+    0x68DDB3F8U, 0x1FDA836EU, 0x81BE16CDU, 0xF6B9265BU, 0x6FB077E1U, 0x18B74777U,
+    0x88085AE6U, 0xFF0F6A70U, 0x66063BCAU, 0x11010B5CU, 0x8F659EFFU, 0xF862AE69U,
+    0x616BFFD3U, 0x166CCF45U, 0xA00AE278U, 0xD70DD2EEU, 0x4E048354U, 0x3903B3C2U,
+    0xA7672661U, 0xD06016F7U, 0x4969474DU, 0x3E6E77DBU, 0xAED16A4AU, 0xD9D65ADCU,
+    0x40DF0B66U, 0x37D83BF0U, 0xA9BCAE53U, 0xDEBB9EC5U, 0x47B2CF7FU, 0x30B5FFE9U,
+    0xBDBDF21CU, 0xCABAC28AU, 0x53B39330U, 0x24B4A3A6U, 0xBAD03605U, 0xCDD70693U,
+    0x54DE5729U, 0x23D967BFU, 0xB3667A2EU, 0xC4614AB8U, 0x5D681B02U, 0x2A6F2B94U,
+    0xB40BBE37U, 0xC30C8EA1U, 0x5A05DF1BU, 0x2D02EF8DU,
+};
+#endif
+
+/**
+ * @brief     find the cached parameter index
+ * @param[in] cmd setter command
+ * @return    index or 0xFF if the command is not cached
+ * @note      none
+ */
+static uint8_t a_ch9120_param_index(uint8_t cmd)
+{
+    uint8_t i;
+    
+    for (i = 0; i < CH9120_PARAM_NUM; i++)                          /* check all */
+    {
+        if (gs_param_cmd[i] == cmd)                                 /* check command */
+        {
+            return i;                                               /* return index */
+        }
+    }
+    
+    return 0xFF;                                                    /* not found */
+}
+
+/**
+ * @brief     cache a readback
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] cmd getter command
+ * @param[in] *out pointer to an out buffer
+ * @param[in] out_len output length
+ * @note      getters are the setter command plus 0x50
+ */
+static void a_ch9120_readback(ch9120_handle_t *handle, uint8_t cmd, uint8_t *out, uint16_t out_len)
+{
+    uint8_t i;
+    
+    if ((cmd < CH9120_CMD_GET_MODE) || (out_len > 4))               /* check getter */
+    {
+        return;                                                     /* not a getter */
+    }
+    i = a_ch9120_param_index(cmd - 0x50);                           /* get index */
+    if (i == 0xFF)                                                  /* check index */
+    {
+        return;                                                     /* not a cached getter */
+    }
+    memset(handle->param[i], 0, sizeof(uint8_t) * 4);               /* clear value */
+    memcpy(handle->param[i], out, out_len);                         /* cache value */
+    handle->param_valid |= (uint16_t)(1U << i);                     /* set valid */
+}
+
+/**
+ * @brief     save the eeprom record
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 storage write failed
+ * @note      the record is kept in ram only if storage_write is not linked
+ */
+static uint8_t a_ch9120_record_save(ch9120_handle_t *handle)
+{
+    ch9120_record_t record;
+    
+    if (handle->storage_write == NULL)                              /* check storage_write */
+    {
+        return 0;                                                   /* success return 0 */
+    }
+    
+    memset(&record, 0, sizeof(ch9120_record_t));                    /* clear record */
+    record.magic = CH9120_RECORD_MAGIC;                             /* set magic */
+    record.eeprom_writes = handle->eeprom_writes;                   /* set counter */
+    record.valid = handle->param_valid & 
+                   (uint16_t)(~handle->param_dirty);                /* only saved values */
+    memcpy(record.param, handle->param, sizeof(record.param));      /* copy snapshot */
+    if (handle->storage_write((uint8_t *)&record, sizeof(ch9120_record_t)) != 0)   /* write record */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: storage write failed.\n");     /* storage write failed */
+        
+        return 1;                                                   /* return error */
+    }
+    
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief     load the eeprom record
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @note      a missing or invalid record starts from an empty cache
+ */
+static void a_ch9120_record_load(ch9120_handle_t *handle)
+{
+    ch9120_record_t record;
+    
+    handle->eeprom_writes = 0;                                      /* init 0 */
+    handle->param_valid = 0;                                        /* init 0 */
+    handle->param_dirty = 0;                                        /* init 0 */
+    if (handle->storage_read == NULL)                               /* check storage_read */
+    {
+        return;                                                     /* nothing to load */
+    }
+    if (handle->storage_read((uint8_t *)&record, sizeof(ch9120_record_t)) != 0)    /* read record */
+    {
+        return;                                                     /* no record */
+    }
+    if (record.magic != CH9120_RECORD_MAGIC)                        /* check magic */
+    {
+        return;                                                     /* invalid record */
+    }
+    
+    handle->eeprom_writes = record.eeprom_writes;                   /* set counter */
+    handle->param_valid = record.valid;                             /* set valid */
+    memcpy(handle->param, record.param, sizeof(record.param));      /* copy snapshot */
+}
+
+/**
+ * @brief     track an acked command
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *param pointer to a param buffer
+ * @param[in] len param length
+ * @param[in] known 1 if the ack proves the value is set
+ * @note      setters only mark the parameter dirty when the value changes
+ */
+static void a_ch9120_track(ch9120_handle_t *handle, uint8_t *param, uint16_t len, uint8_t known)
+{
+    uint8_t i;
+    uint8_t v[4];
+    uint16_t bit;
+    
+    if (len == 0)                                                   /* check length */
+    {
+        return;                                                     /* nothing to track */
+    }
+    if (param[0] == CH9120_CMD_RESET)                               /* reset reloads the eeprom */
+    {
+        handle->param_valid &= (uint16_t)(~handle->param_dirty);    /* unsaved values are lost */
+        handle->param_dirty = 0;                                    /* clear dirty */
+        handle->pending = 0;                                        /* clear pending */
+        
+        return;                                                     /* return */
+    }
+    if (param[0] == CH9120_CMD_SAVE_TO_EEPROM)                      /* save to eeprom */
+    {
+        handle->param_dirty = 0;                                    /* clear dirty */
+        handle->eeprom_writes++;                                    /* count the write */
+        (void)a_ch9120_record_save(handle);                         /* save the record */
+        
+        return;                                                     /* return */
+    }
+    if (param[0] == CH9120_CMD_RUN_AND_RESET)                       /* run and reset saves and reboots */
+    {
+        handle->param_dirty = 0;                                    /* clear dirty */
+        handle->pending = 0;                                        /* clear pending */
+        handle->eeprom_writes++;                                    /* count the write */
+        (void)a_ch9120_record_save(handle);                         /* save the record */
+        
+        return;                                                     /* return */
+    }
+    
+    i = a_ch9120_param_index(param[0]);                             /* get index */
+    if (i == 0xFF)                                                  /* check index */
+    {
+        return;                                                     /* not a cached setter */
+    }
+    bit = (uint16_t)(1U << i);                                      /* set bit */
+    memset(v, 0, sizeof(uint8_t) * 4);                              /* clear value */
+    memcpy(v, &param[1], ((len - 1) > 4) ? 4 : (len - 1));          /* copy value */
+    if ((known != 0) && ((handle->param_valid & bit) != 0) &&
+        (memcmp(handle->param[i], v, 4) == 0))                      /* check unchanged */
+    {
+        return;                                                     /* nothing changed */
+    }
+    if (known != 0)                                                 /* check known */
+    {
+        memcpy(handle->param[i], v, 4);                             /* cache value */
+        handle->param_valid |= bit;                                 /* set valid */
+    }
+    else
+    {
+        handle->param_valid &= (uint16_t)(~bit);                    /* clear valid */
+    }
+    handle->param_dirty |= bit;                                     /* set dirty */
+    handle->pending |= CH9120_PENDING_RESET;                        /* only a reset applies it */
+}
+
+/**
+ * @brief     start a trace
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *trace pointer to a trace structure
+ * @param[in] type trace type
+ * @param[in] cmd command id
+ * @param[in] tx_len transmitted length
+ * @param[in] rx_len expected length
+ * @note      none
+ */
+static void a_ch9120_trace_begin(ch9120_handle_t *handle, ch9120_trace_t *trace,
+                                 ch9120_trace_type_t type, uint8_t cmd,
+                                 uint16_t tx_len, uint16_t rx_len)
+{
+    trace->type = type;                                             /* set type */
+    trace->cmd = cmd;                                               /* set command */
+    trace->status = 0;                                              /* init 0 */
+    trace->tx_len = tx_len;                                         /* set tx length */
+    trace->rx_len = rx_len;                                         /* set rx length */
+    if (handle->trace_begin != NULL)                                /* check trace_begin */
+    {
+        if (handle->timestamp_us != NULL)                           /* check timestamp_us */
+        {
+            trace->timestamp_us = handle->timestamp_us();           /* get timestamp */
+        }
+        else
+        {
+            trace->timestamp_us = 0;                                /* no timestamp */
+        }
+        handle->trace_begin(trace);                                 /* run the hook */
+    }
+}
+
+/**
+ * @brief     end a trace
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *trace pointer to a trace structure
+ * @param[in] rx_len received length
+ * @param[in] status status code
+ * @note      none
+ */
+static void a_ch9120_trace_end(ch9120_handle_t *handle, ch9120_trace_t *trace,
+                               uint16_t rx_len, uint8_t status)
+{
+    if (handle->trace_end != NULL)                                  /* check trace_end */
+    {
+        trace->rx_len = rx_len;                                     /* set rx length */
+        trace->status = status;                                     /* set status */
+        if (handle->timestamp_us != NULL)                           /* check timestamp_us */
+        {
+            trace->timestamp_us = handle->timestamp_us();           /* get timestamp */
+        }
+        else
+        {
+            trace->timestamp_us = 0;                                /* no timestamp */
+        }
+        handle->trace_end(trace);                                   /* run the hook */
+    }
+}
+
+/**
+ * @brief     take a lock
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] id lock id
+ * @note      with the lock stats a try lock comes first, so only a contended lock pays for the timestamps
+ */
+static void a_ch9120_lock(ch9120_handle_t *handle, uint8_t id)
+{
+#if (CH9120_ENABLE_LOCK_STATS == 1)
+    uint64_t start;
+    uint32_t wait;
+    ch9120_lock_stats_t *stats;
+#endif
+    
+    if ((handle->mutex_lock == NULL) || (handle->mutex_unlock == NULL))   /* check the hooks */
+    {
+        return;                                                     /* not thread safe */
+    }
+#if (CH9120_ENABLE_LOCK_STATS == 1)
+    if (handle->mutex_lock(handle->mutex_ctx, id, 0) != 0)          /* try lock */
+    {
+        start = 0;                                                  /* init 0 */
+        if (handle->timestamp_us != NULL)                           /* check timestamp_us */
+        {
+            start = handle->timestamp_us();                         /* wait start */
+        }
+        (void)handle->mutex_lock(handle->mutex_ctx, id, 1);         /* wait for the lock */
+        wait = 0;                                                   /* init 0 */
+        if (handle->timestamp_us != NULL)                           /* check timestamp_us */
+        {
+            wait = (uint32_t)(handle->timestamp_us() - start);      /* wait time */
+        }
+        stats = &handle->lock_stats[id];                            /* owned from here */
+        stats->contended++;                                         /* contended++ */
+        stats->wait_us += wait;                                     /* total wait */
+        if (wait > stats->max_wait_us)                              /* check max */
+        {
+            stats->max_wait_us = wait;                              /* set max */
+        }
+    }
+    handle->lock_stats[id].acquired++;                              /* acquired++ */
+#else
+    (void)handle->mutex_lock(handle->mutex_ctx, id, 1);             /* lock */
+#endif
+}
+
+/**
+ * @brief     release a lock
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] id lock id
+ * @note      none
+ */
+static void a_ch9120_unlock(ch9120_handle_t *handle, uint8_t id)
+{
+    if ((handle->mutex_lock == NULL) || (handle->mutex_unlock == NULL))   /* check the hooks */
+    {
+        return;                                                     /* not thread safe */
+    }
+    handle->mutex_unlock(handle->mutex_ctx, id);                    /* unlock */
+}
+
+/**
+ * @brief     free the locks
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @note      none
+ */
+static void a_ch9120_mutex_deinit(ch9120_handle_t *handle)
+{
+    if (handle->mutex_lock == NULL)                                 /* check the hooks */
+    {
+        return;                                                     /* not thread safe */
+    }
+    handle->mutex_deinit(handle->mutex_ctx);                        /* mutex deinit */
+    handle->mutex_ctx = NULL;                                       /* no mutex context */
+}
+
+/**
+ * @brief     check the async command
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    1 if an async command owns the uart, else 0
+ * @note      none
+ */
+static uint8_t a_ch9120_async_busy(ch9120_handle_t *handle)
+{
+#if (CH9120_ENABLE_ASYNC == 1)
+    if (handle->async_state != CH9120_ASYNC_IDLE)                   /* check state */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: command is busy.\n");   /* command is busy */
+        
+        return 1;                                                   /* busy */
+    }
+#else
+    (void)handle;                                                   /* no async command */
+#endif
+    
+    return 0;                                                       /* idle */
+}
+
+/**
+ * @brief     write a command
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *param pointer to a param buffer
+ * @param[in] len param length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the header and the params are written back to back from the caller buffers
+ */
+static uint8_t a_ch9120_write_command(ch9120_handle_t *handle, uint8_t *param, uint16_t len)
+{
+    uint8_t header[2];
+    
+    header[0] = 0x57;                                         /* set header 0 */
+    header[1] = 0xAB;                                         /* set header 1 */
+    if (handle->uart_write(header, 2) != 0)                   /* write header */
+    {
+        return 1;                                             /* return error */
+    }
+    if ((len != 0) && (handle->uart_write(param, len) != 0))  /* write param */
+    {
+        return 1;                                             /* return error */
+    }
+    
+    return 0;                                                 /* success return 0 */
+}
+
 /**
  * @brief     write and check
  * @param[in] *handle pointer to a ch9120 handle structure
@@ -96,34 +689,32 @@
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- *            - 2 len is invalid
  *            - 3 error
  *            - 4 timeout
  * @note      none
  */
-static uint8_t a_ch9120_write_check(ch9120_handle_t *handle,
-                                    uint8_t *param, uint16_t len,
-                                    uint16_t pre_delay, uint16_t timeout)
+static uint8_t a_ch9120_write_check_unlocked(ch9120_handle_t *handle,
+                                             uint8_t *param, uint16_t len,
+                                             uint16_t pre_delay, uint16_t timeout)
 {
     uint16_t t;
     uint8_t res;
+    ch9120_trace_t trace;
     
-    if (len > 126)                                            /* check length */
+    if (a_ch9120_async_busy(handle) != 0)                     /* check async command */
     {
-        handle->debug_print("ch9120: len is invalid.\n");     /* len is invalid */
-        
-        return 2;                                             /* return error */
+        return 1;                                             /* return error */
     }
+    a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_WRITE_CHECK,
+                         (len != 0) ? param[0] : 0, 2 + len, 1);   /* trace begin */
     
-    handle->buf[0] = 0x57;                                    /* set header 0 */
-    handle->buf[1] = 0xAB;                                    /* set header 1 */
-    memcpy(&handle->buf[2], param, len);                      /* copy param */
     handle->cfg_gpio_write(0);                                /* set low */
     handle->uart_flush();                                     /* uart flush */
-    if (handle->uart_write(handle->buf, 2 + len) != 0)        /* write command */
+    if (a_ch9120_write_command(handle, param, len) != 0)      /* write command */
     {
-        handle->debug_print("ch9120: write failed.\n");       /* write failed */
+        CH9120_DEBUG_PRINT(handle, "ch9120: write failed.\n");       /* write failed */
         handle->cfg_gpio_write(1);                            /* set high */
+        a_ch9120_trace_end(handle, &trace, 0, 1);             /* trace end */
         
         return 1;                                             /* return error */
     }
@@ -140,13 +731,16 @@ static uint8_t a_ch9120_write_check(ch9120_handle_t *handle,
             if (res == 0xAA)                                  /* check 0xAA */
             {
                 handle->cfg_gpio_write(1);                    /* set high */
+                a_ch9120_track(handle, param, len, 1);        /* track the command */
+                a_ch9120_trace_end(handle, &trace, 1, 0);     /* trace end */
                 
                 return 0;                                     /* success return 0 */
             }
             else
             {
-                handle->debug_print("ch9120: error.\n");      /* error */
+                CH9120_DEBUG_PRINT(handle, "ch9120: error.\n");      /* error */
                 handle->cfg_gpio_write(1);                    /* set high */
+                a_ch9120_trace_end(handle, &trace, 1, 3);     /* trace end */
                 
                 return 3;                                     /* return error */
             }
@@ -155,12 +749,43 @@ static uint8_t a_ch9120_write_check(ch9120_handle_t *handle,
         t--;                                                  /* timeout-- */
     }
     
-    handle->debug_print("ch9120: timeout.\n");                /* timeout */
+    CH9120_DEBUG_PRINT(handle, "ch9120: timeout.\n");         /* timeout */
     handle->cfg_gpio_write(1);                                /* set high */
+    a_ch9120_trace_end(handle, &trace, 0, 4);                 /* trace end */
     
     return 4;                                                 /* return error */
 }
 
+/**
+ * @brief     write and check
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *param pointer to a param buffer
+ * @param[in] len param length
+ * @param[in] pre_delay delay in ms
+ * @param[in] timeout timeout in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 3 error
+ *            - 4 timeout
+ * @note      the command owns the cfg pin and the uart until the answer arrives
+ */
+static uint8_t a_ch9120_write_check(ch9120_handle_t *handle,
+                                    uint8_t *param, uint16_t len,
+                                    uint16_t pre_delay, uint16_t timeout)
+{
+    uint8_t res;
+    
+    a_ch9120_lock(handle, CH9120_LOCK_CFG);                   /* lock cfg */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                    /* lock io */
+    res = a_ch9120_write_check_unlocked(handle, param, len, 
+                                        pre_delay, timeout);  /* write check */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                  /* unlock io */
+    a_ch9120_unlock(handle, CH9120_LOCK_CFG);                 /* unlock cfg */
+    
+    return res;                                               /* return the result */
+}
+
 /**
  * @brief      write and read
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -173,34 +798,32 @@ static uint8_t a_ch9120_write_check(ch9120_handle_t *handle,
  * @return     status code
  *             - 0 success
  *             - 1 write failed
- *             - 2 len is invalid
  *             - 3 timeout
  * @note       none
  */
-static uint8_t a_ch9120_write_read(ch9120_handle_t *handle,
-                                   uint8_t *param, uint16_t len,
-                                   uint8_t *out, uint16_t out_len,
-                                   uint16_t pre_delay, uint16_t timeout)
+static uint8_t a_ch9120_write_read_unlocked(ch9120_handle_t *handle,
+                                            uint8_t *param, uint16_t len,
+                                            uint8_t *out, uint16_t out_len,
+                                            uint16_t pre_delay, uint16_t timeout)
 {
     uint16_t t;
     uint16_t point;
+    ch9120_trace_t trace;
     
-    if (len > 126)                                            /* check length */
+    if (a_ch9120_async_busy(handle) != 0)                     /* check async command */
     {
-        handle->debug_print("ch9120: len is invalid.\n");     /* len is invalid */
-        
-        return 2;                                             /* return error */
+        return 1;                                             /* return error */
     }
+    a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_WRITE_READ,
+                         (len != 0) ? param[0] : 0, 2 + len, out_len);   /* trace begin */
     
-    handle->buf[0] = 0x57;                                    /* set header 0 */
-    handle->buf[1] = 0xAB;                                    /* set header 1 */
-    memcpy(&handle->buf[2], param, len);                      /* copy param */
     handle->cfg_gpio_write(0);                                /* set low */
     handle->uart_flush();                                     /* uart flush */
-    if (handle->uart_write(handle->buf, 2 + len) != 0)        /* write command */
+    if (a_ch9120_write_command(handle, param, len) != 0)      /* write command */
     {
-        handle->debug_print("ch9120: write failed.\n");       /* write failed */
+        CH9120_DEBUG_PRINT(handle, "ch9120: write failed.\n");       /* write failed */
         handle->cfg_gpio_write(1);                            /* set high */
+        a_ch9120_trace_end(handle, &trace, 0, 1);             /* trace end */
         
         return 1;                                             /* return error */
     }
@@ -222,6 +845,17 @@ static uint8_t a_ch9120_write_read(ch9120_handle_t *handle,
             if (point >= out_len)                             /* check length */
             {
                 handle->cfg_gpio_write(1);                    /* set high */
+                if ((len == 1) && 
+                    (param[0] >= CH9120_CMD_GET_MODE))        /* check getter */
+                {
+                    a_ch9120_readback(handle, param[0], 
+                                      out, out_len);          /* cache readback */
+                }
+                else
+                {
+                    a_ch9120_track(handle, param, len, 0);    /* raw command */
+                }
+                a_ch9120_trace_end(handle, &trace, point, 0); /* trace end */
                 
                 return 0;                                     /* success return 0 */
             }
@@ -230,340 +864,2611 @@ static uint8_t a_ch9120_write_read(ch9120_handle_t *handle,
         t--;                                                  /* timeout-- */
     }
     
-    handle->debug_print("ch9120: timeout.\n");                /* timeout */
+    CH9120_DEBUG_PRINT(handle, "ch9120: timeout.\n");         /* timeout */
     handle->cfg_gpio_write(1);                                /* set high */
+    a_ch9120_trace_end(handle, &trace, point, 3);             /* trace end */
     
     return 3;                                                 /* return error */
 }
 
 /**
- * @brief      get version
+ * @brief      write and read
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *version pointer to a version buffer
+ * @param[in]  *param pointer to a param buffer
+ * @param[in]  len param length
+ * @param[out] *out pointer to an out buffer
+ * @param[in]  out_len output length
+ * @param[in]  pre_delay delay in ms
+ * @param[in]  timeout timeout in ms
  * @return     status code
  *             - 0 success
- *             - 1 get version failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ *             - 1 write failed
+ *             - 3 timeout
+ * @note       the command owns the cfg pin and the uart until the answer arrives
  */
-uint8_t ch9120_get_version(ch9120_handle_t *handle, uint8_t *version)
+static uint8_t a_ch9120_write_read(ch9120_handle_t *handle,
+                                   uint8_t *param, uint16_t len,
+                                   uint8_t *out, uint16_t out_len,
+                                   uint16_t pre_delay, uint16_t timeout)
+{
+    uint8_t res;
+    
+    a_ch9120_lock(handle, CH9120_LOCK_CFG);                   /* lock cfg */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                    /* lock io */
+    res = a_ch9120_write_read_unlocked(handle, param, len, out, out_len,
+                                       pre_delay, timeout);   /* write read */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                  /* unlock io */
+    a_ch9120_unlock(handle, CH9120_LOCK_CFG);                 /* unlock cfg */
+    
+    return res;                                               /* return the result */
+}
+
+/**
+ * @brief     wait until the chip is ready
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] max_ms max wait time in ms
+ * @return    status code
+ *            - 0 success
+ *            - 1 not ready
+ * @note      it probes the chip with the get version command and stores the boot time,
+ *            a stale 0xAA ack or an idle line byte 0x00 or 0xFF is not a version reply,
+ *            the chip is ready once two probes in a row answer the same version, so a
+ *            noise byte is never taken as a ready chip, the uart is not flushed between
+ *            the probes so a late reply is still taken
+ */
+static uint8_t a_ch9120_wait_ready_unlocked(ch9120_handle_t *handle, uint32_t max_ms)
 {
+    uint8_t res;
     uint8_t cmd;
+    uint8_t version;
+    uint8_t count;
+    uint8_t got;
+    uint16_t t;
+    uint32_t elapsed;
+    uint64_t start;
+    ch9120_trace_t trace;
     
-    if (handle == NULL)                                             /* check handle */
-    {
-        return 2;                                                   /* return error */
-    }
-    if (handle->inited != 1)                                        /* check handle initialization */
+    start = 0;                                                /* init 0 */
+    if (handle->timestamp_us != NULL)                         /* check timestamp_us */
     {
-        return 3;                                                   /* return error */
+        start = handle->timestamp_us();                       /* get timestamp */
     }
+    handle->delay_ms(CH9120_BOOT_MIN_DELAY);                  /* delay min delay */
+    elapsed = CH9120_BOOT_MIN_DELAY;                          /* set elapsed */
     
-    cmd = CH9120_CMD_CHIP_VERSION;                                  /* set chip version */
-    if (a_ch9120_write_read(handle, &cmd, 1, version, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)      /* get version */
+    cmd = CH9120_CMD_CHIP_VERSION;                            /* set chip version */
+    version = 0;                                              /* init 0 */
+    count = 0;                                                /* no version yet */
+    handle->uart_flush();                                     /* uart flush */
+    while (elapsed < max_ms)                                  /* check max time */
     {
-        return 1;                                                   /* return error */
+        a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_WRITE_READ,
+                             CH9120_CMD_CHIP_VERSION, 3, 1);  /* trace begin */
+        handle->cfg_gpio_write(0);                            /* set low */
+        if (a_ch9120_write_command(handle, &cmd, 1) != 0)     /* write command */
+        {
+            handle->cfg_gpio_write(1);                        /* set high */
+            a_ch9120_trace_end(handle, &trace, 0, 1);         /* trace end */
+            handle->delay_ms(1);                              /* delay 1ms */
+            elapsed++;                                        /* elapsed++ */
+            
+            continue;                                         /* try again */
+        }
+        got = 0;                                              /* no reply yet */
+        for (t = 0; (t < CH9120_BOOT_PROBE_TIMEOUT) && 
+             (elapsed < max_ms); t++)                         /* probe timeout */
+        {
+            if ((handle->uart_read(&res, 1) == 1) &&
+                (res != 0xAA) && (res != 0x00) && (res != 0xFF))    /* read a version */
+            {
+                if ((count == 0) || (res != version))         /* check the version */
+                {
+                    version = res;                            /* save the version */
+                    count = 1;                                /* confirm it with the next probe */
+                    got = 1;                                  /* got a reply */
+                    
+                    break;                                    /* probe again */
+                }
+                handle->cfg_gpio_write(1);                    /* set high */
+                handle->uart_flush();                         /* drop the other replies */
+                a_ch9120_trace_end(handle, &trace, 1, 0);     /* trace end */
+                if (handle->timestamp_us != NULL)             /* check timestamp_us */
+                {
+                    handle->boot_ms = (uint32_t)((handle->timestamp_us() - start) 
+                                      / 1000);                /* measured boot time */
+                }
+                else
+                {
+                    handle->boot_ms = elapsed;                /* counted boot time */
+                }
+                
+                return 0;                                     /* success return 0 */
+            }
+            handle->delay_ms(1);                              /* delay 1ms */
+            elapsed++;                                        /* elapsed++ */
+        }
+        handle->cfg_gpio_write(1);                            /* set high */
+        a_ch9120_trace_end(handle, &trace, got, (got != 0) ? 0 : 3);      /* trace end */
     }
+    handle->boot_ms = max_ms;                                 /* worst case */
     
-    return 0;                                                       /* success return 0 */
+    return 1;                                                 /* return error */
 }
 
 /**
- * @brief     reset the chip
+ * @brief     wait until the chip is ready
  * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] max_ms max wait time in ms
  * @return    status code
  *            - 0 success
- *            - 1 reset failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ *            - 1 not ready
+ * @note      the probe owns the cfg pin and the uart until the chip answers
  */
-uint8_t ch9120_reset(ch9120_handle_t *handle)
+static uint8_t a_ch9120_wait_ready(ch9120_handle_t *handle, uint32_t max_ms)
 {
-    uint8_t cmd;
+    uint8_t res;
     
-    if (handle == NULL)                                               /* check handle */
+    a_ch9120_lock(handle, CH9120_LOCK_CFG);                   /* lock cfg */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                    /* lock io */
+    res = a_ch9120_wait_ready_unlocked(handle, max_ms);       /* wait ready */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                  /* unlock io */
+    a_ch9120_unlock(handle, CH9120_LOCK_CFG);                 /* unlock cfg */
+    
+    return res;                                               /* return the result */
+}
+
+/**
+ * @brief      write a command from the command table and read its answer
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 run failed
+ * @note       it never waits for a reboot
+ */
+static uint8_t a_ch9120_exec_run(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out)
+{
+    uint8_t res;
+    uint8_t cmd[5];
+    const ch9120_exec_desc_t *desc;
+    
+    desc = &gs_exec_table[id];                                /* get the descriptor */
+    cmd[0] = desc->cmd;                                       /* set command */
+    if (desc->in_len != 0)                                    /* check payload */
     {
-        return 2;                                                     /* return error */
+        memcpy(&cmd[1], in, desc->in_len);                    /* set payload */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (desc->out_len == 0)                                   /* check response */
     {
-        return 3;                                                     /* return error */
+        res = a_ch9120_write_check(handle, cmd, 1 + desc->in_len,
+                                   CH9120_UART_PRE_DELAY, CH9120_EXEC_TIMEOUT);    /* write check */
     }
-    
-    cmd = CH9120_CMD_RESET;                                           /* set reset */
-    if (a_ch9120_write_check(handle, &cmd, 1,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)       /* reset */
+    else
     {
-        return 1;                                                     /* return error */
+        res = a_ch9120_write_read(handle, cmd, 1 + desc->in_len, out, desc->out_len,
+                                  CH9120_UART_PRE_DELAY, CH9120_EXEC_TIMEOUT);     /* write read */
     }
-    handle->delay_ms(1000);                                           /* delay 1000ms */
     
-    return 0;                                                         /* success return 0 */
+    return (res != 0) ? 1 : 0;                                /* return the result */
 }
 
 /**
- * @brief      get status
+ * @brief      run a command from the command table
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *status pointer to a status buffer
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
  * @return     status code
  *             - 0 success
- *             - 1 get status failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ *             - 1 run failed or the chip is not ready after a reboot
+ * @note       the payload and the response are in the wire order
  */
-uint8_t ch9120_get_status(ch9120_handle_t *handle, ch9120_status_t *status)
+static uint8_t a_ch9120_exec(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out)
 {
-    uint8_t cmd;
-    uint8_t param;
-    
-    if (handle == NULL)                                               /* check handle */
+    if (a_ch9120_exec_run(handle, id, in, out) != 0)          /* run */
     {
-        return 2;                                                     /* return error */
+        return 1;                                             /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if ((gs_exec_table[id].flag & CH9120_EXEC_FLAG_BOOT) != 0)    /* check boot */
     {
-        return 3;                                                     /* return error */
+        if (a_ch9120_wait_ready(handle, 1000) != 0)           /* wait ready */
+        {
+            CH9120_DEBUG_PRINT(handle, "ch9120: chip is not ready.\n");    /* chip is not ready */
+            
+            return 1;                                         /* return error */
+        }
     }
     
-    cmd = CH9120_CMD_GET_STATUS;                                      /* get status */
-    if (a_ch9120_write_read(handle, &cmd, 1, &param, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get status */
+    return 0;                                                 /* success return 0 */
+}
+
+/**
+ * @brief     check the eeprom record against the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @note      every cached parameter is read back, so a swapped module or an eeprom written by
+ *            another tool never leaves a stale value that hides a change, the parameters without
+ *            a getter are only kept if all the read backs match the record
+ */
+static void a_ch9120_record_verify(ch9120_handle_t *handle)
+{
+    uint8_t i;
+    uint8_t match;
+    uint8_t out[4];
+    uint8_t saved[4];
+    uint16_t bit;
+    uint16_t blind;
+    
+    match = 0;                                                /* nothing proven yet */
+    blind = 0;                                                /* no unchecked parameter */
+    for (i = 0; i < CH9120_PARAM_NUM; i++)                    /* check all */
+    {
+        bit = (uint16_t)(1U << i);                            /* set bit */
+        if ((handle->param_valid & bit) == 0)                 /* check cached */
+        {
+            continue;                                         /* nothing to check */
+        }
+        if (gs_param_get[i] == CH9120_COMMAND_NUM)            /* check getter */
+        {
+            blind |= bit;                                     /* no getter */
+            
+            continue;                                         /* check it later */
+        }
+        memcpy(saved, handle->param[i], sizeof(uint8_t) * 4); /* save the record value */
+        handle->param_valid &= (uint16_t)(~bit);              /* drop until the chip answers */
+        (void)a_ch9120_exec(handle, gs_param_get[i], NULL, out);         /* the read back refreshes the cache */
+        if (((handle->param_valid & bit) != 0) &&
+            (memcmp(saved, handle->param[i], 4) == 0))        /* check the chip value */
+        {
+            match = (match == 0) ? 1 : match;                 /* matched */
+        }
+        else
+        {
+            match = 2;                                        /* the record is stale */
+        }
+    }
+    if (match != 1)                                           /* check the record */
     {
-        return 1;                                                     /* return error */
+        handle->param_valid &= (uint16_t)(~blind);            /* unchecked values are not trusted */
     }
-    *status = (ch9120_status_t)(param);                               /* get the status */
-    
-    return 0;                                                         /* success return 0 */
 }
 
 /**
- * @brief     save to eeprom
+ * @brief     save to eeprom if anything changed
  * @param[in] *handle pointer to a ch9120 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 save to eeprom failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ *            - 1 save failed
  * @note      none
  */
-uint8_t ch9120_save_to_eeprom(ch9120_handle_t *handle)
+static uint8_t a_ch9120_save(ch9120_handle_t *handle)
 {
-    uint8_t cmd;
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle->param_dirty == 0)                             /* check dirty */
     {
-        return 2;                                                     /* return error */
-    }
-    if (handle->inited != 1)                                          /* check handle initialization */
-    {
-        return 3;                                                     /* return error */
+        return 0;                                             /* eeprom already matches */
     }
     
-    cmd = CH9120_CMD_SAVE_TO_EEPROM;                                  /* set save to eeprom */
-    if (a_ch9120_write_check(handle, &cmd, 1,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)       /* save to eeprom */
+    if (a_ch9120_exec(handle, CH9120_COMMAND_SAVE_TO_EEPROM,
+                      NULL, NULL) != 0)                       /* save to eeprom */
     {
-        return 1;                                                     /* return error */
+        return 1;                                             /* return error */
     }
     
-    return 0;                                                         /* success return 0 */
+    return 0;                                                 /* success return 0 */
 }
 
+#if (CH9120_ENABLE_AUTOTUNE == 1)
 /**
- * @brief     config and reset the chip
+ * @brief     sample a uart burst for the auto tune
  * @param[in] *handle pointer to a ch9120 handle structure
- * @return    status code
- *            - 0 success
- *            - 1 config and reset failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ * @param[in] start burst start time
+ * @param[in] end burst end time
+ * @param[in] len burst length
  * @note      none
  */
-uint8_t ch9120_config_and_reset(ch9120_handle_t *handle)
+static void a_ch9120_tune_record(ch9120_handle_t *handle, uint64_t start, uint64_t end, uint16_t len)
 {
-    uint8_t cmd;
+    ch9120_autotune_sample_t *sample;
     
-    if (handle == NULL)                                               /* check handle */
+    if ((handle->tune_sample == NULL) || (handle->tune_count >= handle->tune_num))   /* check training */
     {
-        return 2;                                                     /* return error */
+        return;                                                      /* not sampling */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if ((handle->tune_count != 0) && (handle->tune_window_ms != 0) &&
+        ((start - handle->tune_start_us) >= (uint64_t)handle->tune_window_ms * 1000))  /* check window */
     {
-        return 3;                                                     /* return error */
+        return;                                                      /* window is over */
     }
     
-    cmd = CH9120_CMD_RUN_AND_RESET;                                   /* set run config reset */
-    if (a_ch9120_write_check(handle, &cmd, 1,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)       /* run config reset */
+    sample = &handle->tune_sample[handle->tune_count];               /* get sample */
+    if (handle->tune_count == 0)                                     /* check first */
     {
-        return 1;                                                     /* return error */
+        handle->tune_start_us = start;                               /* training start */
+        sample->idle_us = 0xFFFFFFFFU;                               /* always a new packet */
     }
-    handle->delay_ms(1000);                                           /* delay 1000ms */
-    
-    return 0;                                                         /* success return 0 */
+    else if ((start - handle->tune_last_us) > 0xFFFFFFFFU)           /* check long idle */
+    {
+        sample->idle_us = 0xFFFFFFFFU;                               /* clamp */
+    }
+    else
+    {
+        sample->idle_us = (uint32_t)(start - handle->tune_last_us);  /* idle time */
+    }
+    sample->busy_us = (uint32_t)(end - start);                       /* transfer time */
+    sample->len = len;                                               /* length */
+    handle->tune_last_us = end;                                      /* last end */
+    handle->tune_count++;                                            /* count++ */
 }
 
 /**
- * @brief     exit
- * @param[in] *handle pointer to a ch9120 handle structure
- * @return    status code
- *            - 0 success
- *            - 1 exit failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief      replay the samples through the chip packetizer
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  timeout_us uart timeout in us
+ * @param[in]  len uart buffer length
+ * @param[out] *latency_us pointer to a max packet latency buffer
+ * @return     packet number
+ * @note       a packet ends after timeout_us of uart idle time or at len bytes
  */
-uint8_t ch9120_exit(ch9120_handle_t *handle)
+static uint32_t a_ch9120_tune_replay(ch9120_handle_t *handle, uint32_t timeout_us, 
+                                     uint32_t len, uint32_t *latency_us)
 {
-    uint8_t cmd;
-    
-    if (handle == NULL)                                               /* check handle */
-    {
-        return 2;                                                     /* return error */
+    uint16_t i;
+    uint32_t take;
+    uint32_t left;
+    uint32_t bytes;
+    uint32_t packets;
+    uint64_t span;
+    uint64_t latency;
+    ch9120_autotune_sample_t *sample;
+    
+    packets = 0;                                                     /* init 0 */
+    bytes = 0;                                                       /* init 0 */
+    span = 0;                                                        /* init 0 */
+    latency = 0;                                                     /* init 0 */
+    for (i = 0; i < handle->tune_count; i++)                         /* replay all */
+    {
+        sample = &handle->tune_sample[i];                            /* get sample */
+        if ((bytes != 0) && (sample->idle_us > timeout_us))          /* check timeout */
+        {
+            packets++;                                               /* packet sent */
+            if (span + timeout_us > latency)                         /* check latency */
+            {
+                latency = span + timeout_us;                         /* max latency */
+            }
+            bytes = 0;                                               /* new packet */
+            span = 0;                                                /* new packet */
+        }
+        else if (bytes != 0)                                         /* same packet */
+        {
+            span += sample->idle_us;                                 /* add idle time */
+        }
+        left = sample->len;                                          /* set left */
+        while (left != 0)                                            /* split at len */
+        {
+            take = len - bytes;                                      /* room */
+            if (take > left)                                         /* check left */
+            {
+                take = left;                                         /* set take */
+            }
+            span += (uint64_t)sample->busy_us * take / sample->len;  /* add transfer time */
+            bytes += take;                                           /* add bytes */
+            left -= take;                                            /* sub left */
+            if (bytes >= len)                                        /* check full */
+            {
+                packets++;                                           /* packet sent */
+                if (span > latency)                                  /* check latency */
+                {
+                    latency = span;                                  /* max latency */
+                }
+                bytes = 0;                                           /* new packet */
+                span = 0;                                            /* new packet */
+            }
+        }
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (bytes != 0)                                                  /* last packet */
     {
-        return 3;                                                     /* return error */
+        packets++;                                                   /* packet sent */
+        if (span + timeout_us > latency)                             /* check latency */
+        {
+            latency = span + timeout_us;                             /* max latency */
+        }
     }
+    *latency_us = (latency > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)latency;   /* set latency */
     
-    cmd = CH9120_CMD_EXIT;                                            /* set exit */
-    if (a_ch9120_write_check(handle, &cmd, 1,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)       /* exit */
-    {
-        return 1;                                                     /* return error */
+    return packets;                                                  /* return packets */
+}
+
+/**
+ * @brief      pick the uart timeout and the uart buffer length
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *timeout_ms pointer to a uart timeout buffer
+ * @param[out] *len pointer to a uart buffer length buffer
+ * @note       the fewest packets within the latency target win, ties go to the lower latency,
+ *             when nothing meets the target the lowest latency wins
+ */
+static void a_ch9120_tune_pick(ch9120_handle_t *handle, uint16_t *timeout_ms, uint32_t *len)
+{
+    uint8_t fit;
+    uint8_t best_fit;
+    uint16_t t;
+    uint32_t l;
+    uint32_t packets;
+    uint32_t latency;
+    uint32_t best_packets;
+    uint32_t best_latency;
+    
+    best_fit = 0;                                                    /* init 0 */
+    best_packets = 0xFFFFFFFFU;                                      /* init max */
+    best_latency = 0xFFFFFFFFU;                                      /* init max */
+    *timeout_ms = 5;                                                 /* shortest timeout */
+    *len = CH9120_AUTOTUNE_MAX_LEN;                                  /* largest length */
+    for (t = 5; (t <= 1275) && ((t <= handle->tune_latency_ms) || (t == 5)); t += 5)  /* every register step */
+    {
+        for (l = CH9120_AUTOTUNE_MAX_LEN; l >= CH9120_AUTOTUNE_MIN_LEN; l /= 2)       /* every length */
+        {
+            packets = a_ch9120_tune_replay(handle, (uint32_t)t * 1000, l, &latency);  /* replay */
+            fit = (latency <= (uint32_t)handle->tune_latency_ms * 1000) ? 1 : 0;      /* check target */
+            if (((fit != 0) && ((best_fit == 0) || (packets < best_packets) ||
+                ((packets == best_packets) && (latency < best_latency)))) ||
+                ((fit == 0) && (best_fit == 0) && (latency < best_latency)))          /* check better */
+            {
+                best_fit = fit;                                      /* save fit */
+                best_packets = packets;                              /* save packets */
+                best_latency = latency;                              /* save latency */
+                *timeout_ms = t;                                     /* save timeout */
+                *len = l;                                            /* save length */
+            }
+        }
     }
-    
-    return 0;                                                         /* success return 0 */
 }
+#endif
 
+#if (CH9120_ENABLE_FRAME == 1)
 /**
- * @brief     set mode
+ * @brief     compute the frame crc
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] mode chip mode
- * @return    status code
- *            - 0 success
- *            - 1 set mode failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    crc of the data
  * @note      none
  */
-uint8_t ch9120_set_mode(ch9120_handle_t *handle, ch9120_mode_t mode)
+static uint32_t a_ch9120_frame_crc(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
 {
-    uint8_t cmd[2];
+    uint16_t i;
+    uint16_t crc16;
+    uint32_t crc32;
     
-    if (handle == NULL)                                              /* check handle */
+    if (handle->frame_crc == CH9120_FRAME_CRC_16)                    /* crc-16 */
     {
-        return 2;                                                    /* return error */
+        crc16 = 0xFFFF;                                              /* init */
+        for (i = 0; i < len; i++)                                    /* every byte */
+        {
+            crc16 = (uint16_t)((crc16 << 8) ^ gs_crc16_table[((crc16 >> 8) ^ buf[i]) & 0xFF]);  /* update */
+        }
+        
+        return crc16;                                                /* return crc */
     }
-    if (handle->inited != 1)                                         /* check handle initialization */
+    if (handle->crc32 != NULL)                                       /* check crc32 */
     {
-        return 3;                                                    /* return error */
+        return handle->crc32(buf, len);                              /* linked crc */
     }
-    
-    cmd[0] = CH9120_CMD_SET_MODE;                                    /* set mode */
-    cmd[1] = mode;                                                   /* set mode */
-    if (a_ch9120_write_check(handle, cmd, 2,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write mode */
+    crc32 = 0xFFFFFFFFU;                                             /* init */
+    for (i = 0; i < len; i++)                                        /* every byte */
     {
-        return 1;                                                    /* return error */
+        crc32 = (crc32 >> 8) ^ gs_crc32_table[(crc32 ^ buf[i]) & 0xFF];   /* update */
     }
     
-    return 0;                                                        /* success return 0 */
+    return crc32 ^ 0xFFFFFFFFU;                                      /* return crc */
 }
 
 /**
- * @brief      get mode
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *mode pointer to a mode buffer
- * @return     status code
- *             - 0 success
- *             - 1 get mode failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     get the frame crc length
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    trailer length
+ * @note      none
  */
-uint8_t ch9120_get_mode(ch9120_handle_t *handle, ch9120_mode_t *mode)
+static uint8_t a_ch9120_frame_crc_len(ch9120_handle_t *handle)
 {
-    uint8_t cmd;
-    uint8_t param;
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle->frame_crc == CH9120_FRAME_CRC_16)                    /* crc-16 */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* 2 bytes */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    else if (handle->frame_crc == CH9120_FRAME_CRC_32)               /* crc-32 */
     {
-        return 3;                                                     /* return error */
+        return 4;                                                    /* 4 bytes */
     }
-    
-    cmd = CH9120_CMD_GET_MODE;                                        /* get mode */
-    if (a_ch9120_write_read(handle, &cmd, 1, &param, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get mode */
+    else
     {
-        return 1;                                                     /* return error */
+        return 0;                                                    /* no trailer */
     }
-    *mode = (ch9120_mode_t)(param);                                   /* get mode */
-    
-    return 0;                                                         /* success return 0 */
 }
 
 /**
- * @brief     set ip address
- * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *ip pointer to an ip buffer
- * @return    status code
- *            - 0 success
- *            - 1 set ip failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief     compress a payload
+ * @param[in] *in pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] *out pointer to an output buffer
+ * @param[in] size output buffer size
+ * @return    compressed length, 0 if the data does not get smaller
+ * @note      a literal run is 0LLLLLLL with L + 1 bytes, a match is 1MMMMOOO OOOOOOOO with
+ *            M + 3 bytes at O + 1 bytes back, M 15 adds the next byte to the length
  */
-uint8_t ch9120_set_ip(ch9120_handle_t *handle, uint8_t ip[4])
+static uint16_t a_ch9120_zip(uint8_t *in, uint16_t len, uint8_t *out, uint16_t size)
 {
-    uint8_t cmd[5];
+    uint16_t i;
+    uint16_t o;
+    uint16_t h;
+    uint16_t m;
+    uint16_t k;
+    uint16_t off;
+    uint16_t cand;
+    uint16_t lit;
+    uint16_t head[1 << CH9120_ZIP_HASH_BITS];
     
-    if (handle == NULL)                                              /* check handle */
+    if (size > len)                                                  /* check size */
     {
-        return 2;                                                    /* return error */
+        size = len;                                                  /* must get smaller */
     }
-    if (handle->inited != 1)                                         /* check handle initialization */
+    for (i = 0; i < (1 << CH9120_ZIP_HASH_BITS); i++)                /* clear the hash */
     {
-        return 3;                                                    /* return error */
+        head[i] = 0xFFFF;                                            /* empty */
     }
-    
-    cmd[0] = CH9120_CMD_SET_IP;                                      /* set ip  */
-    cmd[1] = ip[0];                                                  /* set ip[0] */
-    cmd[2] = ip[1];                                                  /* set ip[1] */
-    cmd[3] = ip[2];                                                  /* set ip[2] */
-    cmd[4] = ip[3];                                                  /* set ip[3] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write ip */
+    i = 0;                                                           /* init 0 */
+    o = 0;                                                           /* init 0 */
+    lit = 0;                                                         /* init 0 */
+    while (i < len)                                                  /* every byte */
     {
-        return 1;                                                    /* return error */
-    }
-    
-    return 0;                                                        /* success return 0 */
+        m = 0;                                                       /* no match */
+        if (i + CH9120_ZIP_MIN_MATCH <= len)                         /* check the rest */
+        {
+            h = (uint16_t)((((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2]) *
+                           2654435761U >> (32 - CH9120_ZIP_HASH_BITS));   /* hash 3 bytes */
+            cand = head[h];                                          /* get candidate */
+            head[h] = i;                                             /* set head */
+            if ((cand != 0xFFFF) && (i - cand <= CH9120_ZIP_WINDOW))  /* check window */
+            {
+                while ((i + m < len) && (m < 18 + 255) && (in[cand + m] == in[i + m]))   /* match length */
+                {
+                    m++;                                             /* m++ */
+                }
+            }
+        }
+        if (m < CH9120_ZIP_MIN_MATCH)                                /* literal */
+        {
+            i++;                                                     /* next byte */
+            if ((i - lit == 128) || (i == len))                      /* check literal run */
+            {
+                if (o + 1 + (i - lit) > size)                        /* check size */
+                {
+                    return 0;                                        /* not smaller */
+                }
+                out[o++] = (uint8_t)(i - lit - 1);                   /* literal run */
+                memcpy(&out[o], &in[lit], i - lit);                  /* literals */
+                o += i - lit;                                        /* add literals */
+                lit = i;                                             /* next literal */
+            }
+            
+            continue;                                                /* next */
+        }
+        if (i != lit)                                                /* flush literals */
+        {
+            if (o + 1 + (i - lit) > size)                            /* check size */
+            {
+                return 0;                                            /* not smaller */
+            }
+            out[o++] = (uint8_t)(i - lit - 1);                       /* literal run */
+            memcpy(&out[o], &in[lit], i - lit);                      /* literals */
+            o += i - lit;                                            /* add literals */
+        }
+        off = i - cand - 1;                                          /* offset */
+        k = (m - CH9120_ZIP_MIN_MATCH < 15) ? (m - CH9120_ZIP_MIN_MATCH) : 15;   /* length field */
+        if (o + 2 + ((k == 15) ? 1 : 0) > size)                      /* check size */
+        {
+            return 0;                                                /* not smaller */
+        }
+        out[o++] = (uint8_t)(0x80 | (k << 3) | (off >> 8));          /* match */
+        out[o++] = (uint8_t)(off & 0xFF);                            /* offset */
+        if (k == 15)                                                 /* long match */
+        {
+            out[o++] = (uint8_t)(m - CH9120_ZIP_MIN_MATCH - 15);     /* extra length */
+        }
+        for (k = 1; (k < m) && (i + k + CH9120_ZIP_MIN_MATCH <= len); k++)  /* hash the matched bytes */
+        {
+            h = (uint16_t)((((uint32_t)in[i + k] << 16) | ((uint32_t)in[i + k + 1] << 8) | in[i + k + 2]) *
+                           2654435761U >> (32 - CH9120_ZIP_HASH_BITS));   /* hash 3 bytes */
+            head[h] = i + k;                                         /* set head */
+        }
+        i += m;                                                      /* skip the match */
+        lit = i;                                                     /* next literal */
+    }
+    
+    return (o < len) ? o : 0;                                        /* return length */
+}
+
+/**
+ * @brief         decompress a payload
+ * @param[in]     *in pointer to a compressed buffer
+ * @param[in]     len compressed length
+ * @param[out]    *out pointer to an output buffer
+ * @param[in,out] *size pointer to an output size buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 payload is broken
+ *                - 5 output is too small
+ * @note          none
+ */
+static uint8_t a_ch9120_unzip(uint8_t *in, uint16_t len, uint8_t *out, uint16_t *size)
+{
+    uint8_t c;
+    uint16_t i;
+    uint16_t o;
+    uint16_t m;
+    uint16_t off;
+    
+    i = 0;                                                           /* init 0 */
+    o = 0;                                                           /* init 0 */
+    while (i < len)                                                  /* every token */
+    {
+        c = in[i++];                                                 /* get token */
+        if ((c & 0x80) == 0)                                         /* literal run */
+        {
+            m = (uint16_t)c + 1;                                     /* run length */
+            if (m > len - i)                                         /* check input */
+            {
+                return 1;                                            /* broken */
+            }
+            if (m > *size - o)                                       /* check output */
+            {
+                return 5;                                            /* too small */
+            }
+            memcpy(&out[o], &in[i], m);                              /* copy literals */
+            i += m;                                                  /* add input */
+            o += m;                                                  /* add output */
+            
+            continue;                                                /* next */
+        }
+        if (i >= len)                                                /* check offset */
+        {
+            return 1;                                                /* broken */
+        }
+        off = (uint16_t)((((uint16_t)(c & 0x07)) << 8) | in[i++]) + 1;   /* offset */
+        m = ((c >> 3) & 0x0F) + CH9120_ZIP_MIN_MATCH;                /* length */
+        if (((c >> 3) & 0x0F) == 15)                                 /* long match */
+        {
+            if (i >= len)                                            /* check length */
+            {
+                return 1;                                            /* broken */
+            }
+            m += in[i++];                                            /* extra length */
+        }
+        if (off > o)                                                 /* check offset */
+        {
+            return 1;                                                /* broken */
+        }
+        if (m > *size - o)                                           /* check output */
+        {
+            return 5;                                                /* too small */
+        }
+        while (m != 0)                                               /* copy the match */
+        {
+            out[o] = out[o - off];                                   /* copy byte */
+            o++;                                                     /* o++ */
+            m--;                                                     /* m-- */
+        }
+    }
+    *size = o;                                                       /* set size */
+    
+    return 0;                                                        /* success return 0 */
+}
+
+/**
+ * @brief     reset the frame decoder
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @note      the raw bytes are kept
+ */
+static void a_ch9120_frame_reset(ch9120_handle_t *handle)
+{
+    handle->frame_len = 0;                                           /* clear decoded bytes */
+    handle->frame_code = 0;                                          /* no block */
+    handle->frame_left = 0;                                          /* no block */
+    handle->frame_esc = 0;                                           /* no escape */
+    handle->frame_drop = 0;                                          /* keep data */
+}
+
+/**
+ * @brief     decode one raw frame byte
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] b raw byte
+ * @return    1 if b ends a frame, else 0
+ * @note      the decoded bytes are written in place, never ahead of the raw bytes,
+ *            the frame end is not consumed
+ */
+static uint8_t a_ch9120_frame_decode(ch9120_handle_t *handle, uint8_t b)
+{
+    if (handle->frame_type == CH9120_FRAME_COBS)                     /* cobs */
+    {
+        if (b == 0x00)                                               /* frame end */
+        {
+            if ((handle->frame_drop == 0) && (handle->frame_left == 0) &&
+                (handle->frame_len != 0))                            /* check whole frame */
+            {
+                return 1;                                            /* frame end */
+            }
+            if ((handle->frame_drop == 0) && (handle->frame_left != 0))  /* check truncated */
+            {
+                handle->frame_errors++;                              /* broken frame */
+            }
+            a_ch9120_frame_reset(handle);                            /* resync */
+            
+            return 0;                                                /* consumed */
+        }
+        if (handle->frame_left == 0)                                 /* block code */
+        {
+            if ((handle->frame_code != 0) && (handle->frame_code != 0xFF) &&
+                (handle->frame_drop == 0))                           /* check implied zero */
+            {
+                handle->frame_buf[handle->frame_len++] = 0x00;       /* implied zero */
+            }
+            handle->frame_code = b;                                  /* set code */
+            handle->frame_left = b - 1;                              /* set left */
+        }
+        else
+        {
+            if (handle->frame_drop == 0)                             /* check drop */
+            {
+                handle->frame_buf[handle->frame_len++] = b;          /* data */
+            }
+            handle->frame_left--;                                    /* left-- */
+        }
+        
+        return 0;                                                    /* consumed */
+    }
+    
+    if (b == CH9120_SLIP_END)                                        /* frame end */
+    {
+        if ((handle->frame_drop == 0) && (handle->frame_esc == 0) &&
+            (handle->frame_len != 0))                                /* check whole frame */
+        {
+            return 1;                                                /* frame end */
+        }
+        if ((handle->frame_drop == 0) && (handle->frame_esc != 0))   /* check escape */
+        {
+            handle->frame_errors++;                                  /* broken frame */
+        }
+        a_ch9120_frame_reset(handle);                                /* resync */
+        
+        return 0;                                                    /* consumed */
+    }
+    if (handle->frame_esc != 0)                                      /* escaped byte */
+    {
+        handle->frame_esc = 0;                                       /* clear escape */
+        if (b == CH9120_SLIP_ESC_END)                                /* escaped end */
+        {
+            b = CH9120_SLIP_END;                                     /* set end */
+        }
+        else if (b == CH9120_SLIP_ESC_ESC)                           /* escaped escape */
+        {
+            b = CH9120_SLIP_ESC;                                     /* set escape */
+        }
+        else
+        {
+            if (handle->frame_drop == 0)                             /* check drop */
+            {
+                handle->frame_errors++;                              /* broken frame */
+                handle->frame_drop = 1;                              /* drop the frame */
+            }
+            
+            return 0;                                                /* consumed */
+        }
+    }
+    else if (b == CH9120_SLIP_ESC)                                   /* escape */
+    {
+        handle->frame_esc = 1;                                       /* set escape */
+        
+        return 0;                                                    /* consumed */
+    }
+    if (handle->frame_drop == 0)                                     /* check drop */
+    {
+        handle->frame_buf[handle->frame_len++] = b;                  /* data */
+    }
+    
+    return 0;                                                        /* consumed */
+}
+
+/**
+ * @brief     check the crc of a decoded frame
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    1 if the frame is good, else 0
+ * @note      a bad frame is counted and dropped, its end is then consumed by the caller
+ */
+static uint8_t a_ch9120_frame_check(ch9120_handle_t *handle)
+{
+    uint8_t t;
+    uint16_t l;
+    uint32_t crc;
+    
+    t = a_ch9120_frame_crc_len(handle);                              /* get trailer length */
+    if (t == 0)                                                      /* check crc */
+    {
+        return 1;                                                    /* good */
+    }
+    if (handle->frame_len > t)                                       /* check length */
+    {
+        l = handle->frame_len - t;                                   /* data length */
+        crc = a_ch9120_frame_crc(handle, handle->frame_buf, l);      /* get crc */
+        if ((handle->frame_buf[l + 0] == (uint8_t)(crc >> 0)) &&
+            (handle->frame_buf[l + 1] == (uint8_t)(crc >> 8)) &&
+            ((t == 2) || ((handle->frame_buf[l + 2] == (uint8_t)(crc >> 16)) &&
+                          (handle->frame_buf[l + 3] == (uint8_t)(crc >> 24)))))  /* check trailer */
+        {
+            return 1;                                                /* good */
+        }
+    }
+    CH9120_DEBUG_PRINT(handle, "ch9120: frame crc is error.\n");    /* frame crc is error */
+    handle->frame_errors++;                                          /* broken frame */
+    a_ch9120_frame_reset(handle);                                    /* drop the frame */
+    
+    return 0;                                                        /* bad */
+}
+
+/**
+ * @brief         output a checked frame
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[in]     l payload length
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 payload is broken
+ *                - 5 buffer is too small
+ * @note          with compression the first payload byte is the codec
+ */
+static uint8_t a_ch9120_frame_output(ch9120_handle_t *handle, uint16_t l, uint8_t *buf, uint16_t *len)
+{
+    uint8_t res;
+    uint16_t size;
+    
+    if (handle->frame_zip == 0)                                      /* no compression */
+    {
+        if (*len < l)                                                /* check buffer */
+        {
+            return 5;                                                /* too small */
+        }
+        memcpy(buf, handle->frame_buf, l);                           /* copy frame */
+        *len = l;                                                    /* set length */
+        
+        return 0;                                                    /* success return 0 */
+    }
+    if (handle->frame_buf[0] == CH9120_ZIP_RAW)                      /* stored */
+    {
+        if (*len < l - 1)                                            /* check buffer */
+        {
+            return 5;                                                /* too small */
+        }
+        memcpy(buf, &handle->frame_buf[1], l - 1);                   /* copy frame */
+        *len = l - 1;                                                /* set length */
+        
+        return 0;                                                    /* success return 0 */
+    }
+    if (handle->frame_buf[0] == CH9120_ZIP_LZ)                       /* compressed */
+    {
+        size = *len;                                                 /* output size */
+        res = a_ch9120_unzip(&handle->frame_buf[1], l - 1, buf, &size);   /* decompress */
+        if (res != 0)                                                /* check result */
+        {
+            return res;                                              /* return error */
+        }
+        *len = size;                                                 /* set length */
+        
+        return 0;                                                    /* success return 0 */
+    }
+    
+    return 1;                                                        /* unknown codec */
+}
+
+/**
+ * @brief     get one frame byte
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] *trailer pointer to a crc trailer
+ * @param[in] i byte index
+ * @return    data byte, then trailer byte
+ * @note      none
+ */
+static uint8_t a_ch9120_frame_at(uint8_t *buf, uint16_t len, uint8_t *trailer, uint32_t i)
+{
+    return (i < len) ? buf[i] : trailer[i - len];                    /* return byte */
+}
+
+/**
+ * @brief         put one encoded frame byte
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[in]     *out pointer to a chunk buffer
+ * @param[in,out] *n pointer to a chunk length buffer
+ * @param[in]     b encoded byte
+ * @return        status code
+ *                - 0 success
+ *                - 1 write failed
+ * @note          a full chunk is written
+ */
+static uint8_t a_ch9120_frame_put(ch9120_handle_t *handle, uint8_t *out, uint16_t *n, uint8_t b)
+{
+    out[(*n)++] = b;                                                 /* add byte */
+    if (*n == CH9120_FRAME_CHUNK)                                    /* check full */
+    {
+        *n = 0;                                                      /* clear chunk */
+        
+        return ch9120_write(handle, out, CH9120_FRAME_CHUNK);        /* write chunk */
+    }
+    
+    return 0;                                                        /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     write data to the network
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_ch9120_write_data_unlocked(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
+{
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+    uint64_t start;
+#endif
+    ch9120_trace_t trace;
+    
+    if (a_ch9120_async_busy(handle) != 0)                            /* check async command */
+    {
+        return 1;                                                    /* return error */
+    }
+    a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_WRITE,
+                         0, len, 0);                                 /* trace begin */
+    if (handle->cfg_gpio_write(1) != 0)                              /* cfg gpio write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio write failed.\n");     /* cfg gpio write failed */
+        a_ch9120_trace_end(handle, &trace, 0, 1);                    /* trace end */
+        
+        return 1;                                                    /* return error */
+    }
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+    start = 0;                                                       /* init 0 */
+    if (handle->timestamp_us != NULL)                                /* check timestamp_us */
+    {
+        start = handle->timestamp_us();                              /* burst start */
+    }
+#endif
+    if (handle->uart_write(buf, len) != 0)                           /* uart write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120:uart write failed.\n");   /* uart write failed */
+        a_ch9120_trace_end(handle, &trace, 0, 1);                    /* trace end */
+        
+        return 1;                                                    /* return error */
+    }
+    if (handle->timestamp_us != NULL)                                /* check timestamp_us */
+    {
+        handle->io_last_us = handle->timestamp_us();                 /* mark the data path busy */
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+        a_ch9120_tune_record(handle, start, handle->io_last_us, len);/* sample the burst */
+#endif
+    }
+    a_ch9120_trace_end(handle, &trace, 0, 0);                        /* trace end */
+    
+    return 0;                                                        /* success return 0 */
+}
+
+/**
+ * @brief     write data to the uart
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the data path only takes the io lock
+ */
+static uint8_t a_ch9120_write_data(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
+{
+    uint8_t res;
+    
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    res = a_ch9120_write_data_unlocked(handle, buf, len);            /* write data */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
+    
+    return res;                                                      /* return the result */
+}
+
+#if (CH9120_ENABLE_COALESCE == 1)
+/**
+ * @brief     get the coalesce batch limit
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    batch limit in bytes
+ * @note      a batch never exceeds the cached uart buffer length, so the chip sends it as one packet
+ */
+static uint16_t a_ch9120_tx_limit(ch9120_handle_t *handle)
+{
+    const uint8_t *v;
+    uint32_t len;
+    uint16_t limit;
+    
+    limit = handle->tx_size;                                         /* buffer size */
+    if ((handle->param_valid & CH9120_PARAM_VALID_LEN) != 0)         /* check cached buffer length */
+    {
+        v = handle->param[CH9120_PARAM_INDEX_LEN];                   /* cached package length */
+        len = (uint32_t)(((uint32_t)v[0] << 0) | ((uint32_t)v[1] << 8) |
+                         ((uint32_t)v[2] << 16) | ((uint32_t)v[3] << 24));    /* get length */
+        if ((len != 0) && (len < limit))                             /* check length */
+        {
+            limit = (uint16_t)len;                                   /* chip limit */
+        }
+    }
+    
+    return limit;                                                    /* return limit */
+}
+
+/**
+ * @brief     flush the coalesced data
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the batch is kept when the write fails
+ */
+static uint8_t a_ch9120_tx_flush(ch9120_handle_t *handle)
+{
+    if (handle->tx_len == 0)                                         /* check pending */
+    {
+        return 0;                                                    /* success return 0 */
+    }
+    if (a_ch9120_write_data(handle, handle->tx_buf, 
+                            handle->tx_len) != 0)                    /* write batch */
+    {
+        return 1;                                                    /* return error */
+    }
+    handle->tx_len = 0;                                              /* clear batch */
+    
+    return 0;                                                        /* success return 0 */
+}
+#endif
+
+#if (CH9120_ENABLE_POOL == 1)
+/**
+ * @brief     pop a pool block
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    pointer to a block, NULL when the pool is empty
+ * @note      the head keeps a 16 bit tag above the index, so a lock-free pop never
+ *            mistakes a block that was freed again for the one it read
+ */
+static uint8_t *a_ch9120_pool_pop(ch9120_handle_t *handle)
+{
+    uint16_t idx;
+    uint16_t next;
+    uint32_t head;
+    uint16_t used;
+    uint8_t *block;
+    
+#if (CH9120_POOL_LOCK_FREE == 1)
+    head = __atomic_load_n(&handle->pool_head, __ATOMIC_ACQUIRE);            /* get head */
+    do
+    {
+        idx = (uint16_t)(head & 0xFFFF);                                     /* get index */
+        if (idx == CH9120_POOL_EMPTY)                                        /* check empty */
+        {
+            __atomic_fetch_add(&handle->pool_fails, 1, __ATOMIC_RELAXED);    /* fails++ */
+            
+            return NULL;                                                     /* pool is empty */
+        }
+        block = &handle->pool_buf[(uint32_t)idx * handle->pool_block];      /* get block */
+        next = __atomic_load_n((uint16_t *)block, __ATOMIC_RELAXED);         /* get next */
+    } while (__atomic_compare_exchange_n(&handle->pool_head, &head, 
+                                         ((head + 0x10000U) & 0xFFFF0000U) | next, 1,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0);  /* swap head */
+    __atomic_fetch_add(&handle->pool_allocs, 1, __ATOMIC_RELAXED);           /* allocs++ */
+    used = __atomic_add_fetch(&handle->pool_used, 1, __ATOMIC_RELAXED);      /* used++ */
+    next = __atomic_load_n(&handle->pool_peak, __ATOMIC_RELAXED);            /* get peak */
+    while ((used > next) && 
+           (__atomic_compare_exchange_n(&handle->pool_peak, &next, used, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0))   /* raise peak */
+    {
+        
+    }
+#else
+    head = handle->pool_head;                                                /* get head */
+    idx = (uint16_t)(head & 0xFFFF);                                         /* get index */
+    if (idx == CH9120_POOL_EMPTY)                                            /* check empty */
+    {
+        handle->pool_fails++;                                                /* fails++ */
+        
+        return NULL;                                                         /* pool is empty */
+    }
+    block = &handle->pool_buf[(uint32_t)idx * handle->pool_block];          /* get block */
+    next = *(uint16_t *)block;                                               /* get next */
+    handle->pool_head = ((head + 0x10000U) & 0xFFFF0000U) | next;            /* set head */
+    handle->pool_allocs++;                                                   /* allocs++ */
+    used = ++handle->pool_used;                                              /* used++ */
+    if (used > handle->pool_peak)                                            /* check peak */
+    {
+        handle->pool_peak = used;                                            /* set peak */
+    }
+#endif
+    
+    return block;                                                            /* return the block */
+}
+
+#if (CH9120_POOL_DEBUG == 1)
+/**
+ * @brief     check if a pool block is on the free list
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] idx block index
+ * @return    1 if the block is free, else 0
+ * @note      the walk stops after pool_num blocks, so a broken list never loops
+ */
+static uint8_t a_ch9120_pool_is_free(ch9120_handle_t *handle, uint16_t idx)
+{
+    uint16_t i;
+    uint16_t next;
+    
+    next = (uint16_t)(handle->pool_head & 0xFFFF);                           /* get head */
+    for (i = 0; (i < handle->pool_num) && (next != CH9120_POOL_EMPTY); i++)  /* walk the list */
+    {
+        if (next == idx)                                                     /* check index */
+        {
+            return 1;                                                        /* block is free */
+        }
+        next = *(uint16_t *)&handle->pool_buf[(uint32_t)next * handle->pool_block];   /* get next */
+    }
+    
+    return 0;                                                                /* block is allocated */
+}
+#endif
+
+/**
+ * @brief     push a pool block
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *block pointer to a block
+ * @return    status code
+ *            - 0 success
+ *            - 1 block is invalid
+ * @note      the block must start a block inside the pool and a block must be allocated,
+ *            CH9120_POOL_DEBUG also refuses a block that is already on the free list
+ */
+static uint8_t a_ch9120_pool_push(ch9120_handle_t *handle, uint8_t *block)
+{
+    uintptr_t offset;
+    uint32_t head;
+    uint16_t idx;
+    
+    if ((handle->pool_buf == NULL) || (block == NULL) ||
+        ((uintptr_t)block < (uintptr_t)handle->pool_buf))                    /* check range */
+    {
+        return 1;                                                            /* block is invalid */
+    }
+    offset = (uintptr_t)block - (uintptr_t)handle->pool_buf;                 /* get offset */
+    if ((offset >= (uintptr_t)handle->pool_block * handle->pool_num) ||
+        ((offset % handle->pool_block) != 0))                                /* check block */
+    {
+        return 1;                                                            /* block is invalid */
+    }
+    idx = (uint16_t)(offset / handle->pool_block);                           /* get index */
+    
+#if (CH9120_POOL_LOCK_FREE == 1)
+    if (__atomic_fetch_sub(&handle->pool_used, 1, __ATOMIC_RELAXED) == 0)   /* used-- before the block is visible */
+    {
+        __atomic_fetch_add(&handle->pool_used, 1, __ATOMIC_RELAXED);         /* undo the used-- */
+        
+        return 1;                                                            /* no block is allocated */
+    }
+    head = __atomic_load_n(&handle->pool_head, __ATOMIC_RELAXED);            /* get head */
+    do
+    {
+        __atomic_store_n((uint16_t *)block, (uint16_t)(head & 0xFFFF), 
+                         __ATOMIC_RELAXED);                                  /* link the head */
+    } while (__atomic_compare_exchange_n(&handle->pool_head, &head, 
+                                         ((head + 0x10000U) & 0xFFFF0000U) | idx, 1,
+                                         __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0);  /* swap head */
+#else
+    if (handle->pool_used == 0)                                              /* check used */
+    {
+        return 1;                                                            /* no block is allocated */
+    }
+#if (CH9120_POOL_DEBUG == 1)
+    if (a_ch9120_pool_is_free(handle, idx) != 0)                             /* check double free */
+    {
+        return 1;                                                            /* block is already free */
+    }
+#endif
+    head = handle->pool_head;                                                /* get head */
+    *(uint16_t *)block = (uint16_t)(head & 0xFFFF);                          /* link the head */
+    handle->pool_head = ((head + 0x10000U) & 0xFFFF0000U) | idx;             /* set head */
+    handle->pool_used--;                                                     /* used-- */
+#endif
+    
+    return 0;                                                                /* success return 0 */
+}
+
+/**
+ * @brief         take a driver buffer from the pool
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[in]     own owner flag
+ * @param[in]     *old pointer to the buffer the owner holds now
+ * @param[in,out] **buf pointer to a buffer pointer
+ * @param[in]     size wanted size
+ * @return        status code
+ *                - 0 success
+ *                - 1 no pool block fits
+ * @note          the block that the owner held before goes back to the pool first,
+ *                a caller buffer or no pool keeps *buf as it is
+ */
+static uint8_t a_ch9120_pool_take(ch9120_handle_t *handle, uint8_t own, uint8_t *old, 
+                                  uint8_t **buf, uint16_t size)
+{
+    if ((handle->pool_owned & own) != 0)                                     /* check owned */
+    {
+        (void)a_ch9120_pool_push(handle, old);                               /* give it back */
+        handle->pool_owned &= (uint8_t)(~own);                               /* clear owned */
+    }
+    if ((*buf != NULL) || (size == 0) || (handle->pool_num == 0))            /* check pool use */
+    {
+        return 0;                                                            /* nothing to take */
+    }
+    if (size > handle->pool_block)                                           /* check size */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: pool block is too small.\n");    /* pool block is too small */
+        
+        return 1;                                                            /* return error */
+    }
+    *buf = a_ch9120_pool_pop(handle);                                        /* take a block */
+    if (*buf == NULL)                                                        /* check block */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: pool is empty.\n");              /* pool is empty */
+        
+        return 1;                                                            /* return error */
+    }
+    handle->pool_owned |= own;                                               /* set owned */
+    
+    return 0;                                                                /* success return 0 */
+}
+#endif
+
+/**
+ * @brief      get version
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *version pointer to a version buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get version failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 version is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_version(ch9120_handle_t *handle, uint8_t *version)
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_VERSION, NULL, version); /* get version */
+}
+
+/**
+ * @brief     reset the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 reset failed or the chip is not ready
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      it returns as soon as the chip answers again
+ */
+uint8_t ch9120_reset(ch9120_handle_t *handle)
+{
+    return ch9120_exec(handle, CH9120_COMMAND_RESET, NULL, NULL);     /* reset */
+}
+
+/**
+ * @brief      get the boot time
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *ms pointer to a ms buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       measured by the last init, reset or config and reset
+ */
+uint8_t ch9120_get_boot_time(ch9120_handle_t *handle, uint32_t *ms)
+{
+    if (handle == NULL)                                             /* check handle */
+    {
+        return 2;                                                   /* return error */
+    }
+    if (handle->inited != 1)                                        /* check handle initialization */
+    {
+        return 3;                                                   /* return error */
+    }
+    
+    *ms = handle->boot_ms;                                          /* get boot time */
+    
+    return 0;                                                       /* success return 0 */
+}
+
+/**
+ * @brief      get status
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *status pointer to a status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get status failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 status is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_status(ch9120_handle_t *handle, ch9120_status_t *status)
+{
+    uint8_t res;
+    uint8_t param;
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_STATUS, NULL,
+                      (status != NULL) ? &param : NULL);              /* get status */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *status = (ch9120_status_t)(param);                               /* get param */
+    
+    return 0;                                                         /* success return 0 */
+}
+
+#if (CH9120_ENABLE_MONITOR == 1)
+/**
+ * @brief     enable or disable the link monitor
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the first poll reports the current link
+ */
+uint8_t ch9120_set_monitor(ch9120_handle_t *handle, ch9120_bool_t enable)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    handle->monitor_enable = (uint8_t)enable;                         /* set enable */
+    handle->monitor_interval_ms = CH9120_MONITOR_FAST_MS;             /* start fast */
+    handle->monitor_next_us = 0;                                      /* poll now */
+    handle->link = 0xFF;                                              /* unknown link */
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     link monitor handler
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 get status failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ * @note      call it from the main loop, polls are placed into idle gaps of the data path and
+ *            a drop is seen within CH9120_MONITOR_SLOW_MS + CH9120_MONITOR_MAX_DEFER_MS,
+ *            a poll flushes the uart so it waits while received data is unread if uart_peek is linked,
+ *            without uart_peek read the data before calling it
+ */
+uint8_t ch9120_monitor_handler(ch9120_handle_t *handle)
+{
+    uint8_t res;
+    uint16_t l;
+    uint64_t now;
+    ch9120_view_t view;
+    ch9120_status_t status;
+    
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    if (handle->monitor_enable == 0)                                  /* check enable */
+    {
+        return 0;                                                     /* success return 0 */
+    }
+#if (CH9120_ENABLE_ASYNC == 1)
+    if (handle->async_state != CH9120_ASYNC_IDLE)                     /* check async command */
+    {
+        return 0;                                                     /* wait for the command */
+    }
+#endif
+    if (handle->timestamp_us == NULL)                                 /* check timestamp_us */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: timestamp_us is null.\n");       /* timestamp_us is null */
+        
+        return 4;                                                     /* return error */
+    }
+    
+    now = handle->timestamp_us();                                     /* get timestamp */
+    if (now < handle->monitor_next_us)                                /* check due */
+    {
+        return 0;                                                     /* not due */
+    }
+    if (((now - handle->io_last_us) < (uint64_t)CH9120_MONITOR_IDLE_MS * 1000) &&
+        ((now - handle->monitor_next_us) < (uint64_t)CH9120_MONITOR_MAX_DEFER_MS * 1000))   /* check idle gap */
+    {
+        return 0;                                                     /* wait for an idle gap */
+    }
+    if (handle->uart_peek != NULL)                                    /* check uart_peek */
+    {
+        l = handle->peek_len;                                         /* lent data */
+        if (l == 0)                                                   /* check lent data */
+        {
+            a_ch9120_lock(handle, CH9120_LOCK_IO);                    /* lock io */
+            if (handle->uart_peek(&view) == 0)                        /* uart peek */
+            {
+                l = view.len[0] + view.len[1];                        /* unread data */
+            }
+            a_ch9120_unlock(handle, CH9120_LOCK_IO);                  /* unlock io */
+        }
+        if (l != 0)                                                   /* check unread data */
+        {
+            return 0;                                                 /* the poll would flush it */
+        }
+    }
+    
+    res = ch9120_get_status(handle, &status);                         /* get status */
+    now = handle->timestamp_us();                                     /* get timestamp */
+    if (res != 0)                                                     /* check result */
+    {
+        handle->monitor_interval_ms = CH9120_MONITOR_FAST_MS;         /* retry fast */
+        handle->monitor_next_us = now + 
+                                  (uint64_t)handle->monitor_interval_ms * 1000;   /* set next poll */
+        
+        return 1;                                                     /* return error */
+    }
+    if ((uint8_t)status != handle->link)                              /* check change */
+    {
+        handle->link = (uint8_t)status;                               /* save link */
+        handle->monitor_interval_ms = CH9120_MONITOR_FAST_MS;         /* poll fast */
+        if (handle->receive_callback != NULL)                         /* check receive_callback */
+        {
+            handle->receive_callback((uint8_t)status);                /* run the callback */
+        }
+    }
+    else if (status == CH9120_STATUS_CONNECT)                         /* stable link */
+    {
+        handle->monitor_interval_ms *= 2;                             /* slow down */
+        if (handle->monitor_interval_ms > CH9120_MONITOR_SLOW_MS)     /* check max */
+        {
+            handle->monitor_interval_ms = CH9120_MONITOR_SLOW_MS;     /* set max */
+        }
+    }
+    else
+    {
+        handle->monitor_interval_ms = CH9120_MONITOR_FAST_MS;         /* wait for the link fast */
+    }
+    handle->monitor_next_us = now + 
+                              (uint64_t)handle->monitor_interval_ms * 1000;       /* set next poll */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     save to eeprom
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 save to eeprom failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      it is skipped when no parameter changed since the last save
+ */
+uint8_t ch9120_save_to_eeprom(ch9120_handle_t *handle)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    if (a_ch9120_save(handle) != 0)                                   /* save to eeprom */
+    {
+        return 1;                                                     /* return error */
+    }
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief      get the eeprom write count
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *count pointer to a count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the count survives a restart when the storage functions are linked
+ */
+uint8_t ch9120_get_eeprom_write_count(ch9120_handle_t *handle, uint32_t *count)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    *count = handle->eeprom_writes;                                   /* get count */
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     clear the eeprom record
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 storage write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      it clears the write count and the cached parameters, call it after the module is replaced
+ *            to restart the count, or after another tool wrote the chip eeprom while the handle is
+ *            initialized, else a setter that matches the stale cache is not applied
+ */
+uint8_t ch9120_clear_eeprom_record(ch9120_handle_t *handle)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    handle->eeprom_writes = 0;                                        /* clear count */
+    handle->param_valid = 0;                                          /* clear cache */
+    if (a_ch9120_record_save(handle) != 0)                            /* save the record */
+    {
+        return 1;                                                     /* return error */
+    }
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     config and reset the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 config and reset failed or the chip is not ready
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t ch9120_config_and_reset(ch9120_handle_t *handle)
+{
+    return ch9120_exec(handle, CH9120_COMMAND_CONFIG_AND_RESET, NULL, NULL); /* run config reset */
+}
+
+/**
+ * @brief     exit
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 exit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t ch9120_exit(ch9120_handle_t *handle)
+{
+    return ch9120_exec(handle, CH9120_COMMAND_EXIT, NULL, NULL);      /* exit */
+}
+
+/**
+ * @brief      get the required apply mode
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *mode pointer to an apply mode buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the chip only runs a written parameter after a config and reset,
+ *             so any change needs CH9120_APPLY_PERSIST_AND_RESET
+ */
+uint8_t ch9120_get_apply_required(ch9120_handle_t *handle, ch9120_apply_t *mode)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    if (((handle->pending & CH9120_PENDING_RESET) != 0) ||
+        (handle->param_dirty != 0))                                   /* check reset */
+    {
+        *mode = CH9120_APPLY_PERSIST_AND_RESET;                       /* save and reset */
+    }
+    else
+    {
+        *mode = CH9120_APPLY_NONE;                                    /* nothing */
+    }
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     apply the changed parameters
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] mode apply mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mode is invalid
+ * @note      CH9120_APPLY_AUTO only resets the chip when a parameter changed from the cached chip value,
+ *            ch9120_clear_eeprom_record must run after another tool wrote the chip eeprom,
+ *            the config and reset writes the eeprom itself so no extra save is sent before it,
+ *            the boot is probed so the link is back as soon as the chip answers
+ */
+uint8_t ch9120_apply(ch9120_handle_t *handle, ch9120_apply_t mode)
+{
+    if (handle == NULL)                                               /* check handle */
+    {
+        return 2;                                                     /* return error */
+    }
+    if (handle->inited != 1)                                          /* check handle initialization */
+    {
+        return 3;                                                     /* return error */
+    }
+    
+    if (mode == CH9120_APPLY_AUTO)                                    /* check auto */
+    {
+        (void)ch9120_get_apply_required(handle, &mode);               /* get required mode */
+    }
+    if (mode == CH9120_APPLY_NONE)                                    /* check none */
+    {
+        return 0;                                                     /* success return 0 */
+    }
+    if (mode != CH9120_APPLY_PERSIST_AND_RESET)                       /* check mode */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: mode is invalid.\n");     /* mode is invalid */
+        
+        return 4;                                                     /* return error */
+    }
+    
+    if (a_ch9120_exec(handle, CH9120_COMMAND_CONFIG_AND_RESET,
+                      NULL, NULL) != 0)                               /* config and reset */
+    {
+        return 1;                                                     /* return error */
+    }
+    
+    return 0;                                                         /* success return 0 */
+}
+
+/**
+ * @brief     set mode
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] mode chip mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 set mode failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_mode(ch9120_handle_t *handle, ch9120_mode_t mode)
+{
+    uint8_t param;
+    
+    param = (uint8_t)mode;                                            /* set param */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_MODE, &param, NULL); /* write mode */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get mode
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *mode pointer to a mode buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get mode failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 mode is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_mode(ch9120_handle_t *handle, ch9120_mode_t *mode)
+{
+    uint8_t res;
+    uint8_t param;
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_MODE, NULL,
+                      (mode != NULL) ? &param : NULL);                /* get mode */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *mode = (ch9120_mode_t)(param);                                   /* get param */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set ip address
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *ip pointer to an ip buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 set ip failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_ip(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_SET_IP, ip, NULL);      /* write ip */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get ip address
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *ip pointer to an ip buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get ip failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 ip is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_ip(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_IP, NULL, ip);      /* read ip */
+}
+#endif
+
+/**
+ * @brief     set subnet mask
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *mask pointer to a mask buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 set subnet mask failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 5 mask is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_SET_SUBNET_MASK, mask, NULL); /* write subnet mask */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get subnet mask
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *mask pointer to a mask buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get subnet mask failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 mask is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_SUBNET_MASK, NULL, mask); /* read subnet mask */
+}
+#endif
+
+/**
+ * @brief     set gateway
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *ip pointer to an ip buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 set gateway failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_gateway(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_SET_GATEWAY, ip, NULL); /* write gateway */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get gateway
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *ip pointer to an ip buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get gateway failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 ip is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_gateway(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_GATEWAY, NULL, ip); /* read gateway */
+}
+#endif
+
+/**
+ * @brief     set source port
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] num source port
+ * @return    status code
+ *            - 0 success
+ *            - 1 set source port failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_source_port(ch9120_handle_t *handle, uint16_t num)
+{
+    uint8_t buf[2];
+    
+    buf[0] = (num >> 0) & 0xFF;                                       /* set num[0] */
+    buf[1] = (num >> 8) & 0xFF;                                       /* set num[8] */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_SOURCE_PORT, buf, NULL); /* write port */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get source port
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *num pointer to a source port buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get source port failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 num is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_source_port(ch9120_handle_t *handle, uint16_t *num)
+{
+    uint8_t res;
+    uint8_t buf[2];
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_SOURCE_PORT, NULL,
+                      (num != NULL) ? buf : NULL);                    /* get port */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *num = (uint16_t)((uint16_t)buf[1] << 8 | buf[0]);                /* get port */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set dest ip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *ip pointer to an ip buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 set dest ip failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_dest_ip(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_SET_DEST_IP, ip, NULL); /* write dest ip */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get dest ip
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *ip pointer to an ip buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get dest ip failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 ip is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_dest_ip(ch9120_handle_t *handle, uint8_t ip[4])
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_DEST_IP, NULL, ip); /* get dest ip */
+}
+#endif
+
+/**
+ * @brief     set dest port
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] num dest port
+ * @return    status code
+ *            - 0 success
+ *            - 1 set dest port failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_dest_port(ch9120_handle_t *handle, uint16_t num)
+{
+    uint8_t buf[2];
+    
+    buf[0] = (num >> 0) & 0xFF;                                       /* set num[0] */
+    buf[1] = (num >> 8) & 0xFF;                                       /* set num[8] */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_DEST_PORT, buf, NULL); /* write dest port */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get dest port
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *num pointer to a dest port buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get dest port failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 num is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_dest_port(ch9120_handle_t *handle, uint16_t *num)
+{
+    uint8_t res;
+    uint8_t buf[2];
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_DEST_PORT, NULL,
+                      (num != NULL) ? buf : NULL);                    /* get dest port */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *num = (uint16_t)((uint16_t)buf[1] << 8 | buf[0]);                /* get dest port */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set uart baud
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] baud chip baud
+ * @return    status code
+ *            - 0 success
+ *            - 1 set uart baud failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_uart_baud(ch9120_handle_t *handle, uint32_t baud)
+{
+    uint8_t buf[4];
+    
+    buf[0] = (baud >> 0) & 0xFF;                                      /* set baud[0] */
+    buf[1] = (baud >> 8) & 0xFF;                                      /* set baud[8] */
+    buf[2] = (baud >> 16) & 0xFF;                                     /* set baud[16] */
+    buf[3] = (baud >> 24) & 0xFF;                                     /* set baud[24] */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_UART_BAUD, buf, NULL); /* write baud */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get uart baud
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *baud pointer to a baud buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get uart baud failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 baud is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_uart_baud(ch9120_handle_t *handle, uint32_t *baud)
+{
+    uint8_t res;
+    uint8_t buf[4];
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_UART_BAUD, NULL,
+                      (baud != NULL) ? buf : NULL);                   /* get baud */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *baud = (uint32_t)(((uint32_t)buf[0] << 0) | ((uint32_t)buf[1] << 8) |
+            ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));     /* get baud */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set uart config
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] data_bit uart data bit
+ * @param[in] parity uart parity
+ * @param[in] stop_bit uart stop bit
+ * @return    status code
+ *            - 0 success
+ *            - 1 set uart config failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_uart_config(ch9120_handle_t *handle, uint8_t data_bit, ch9120_parity_t parity, uint8_t stop_bit)
+{
+    uint8_t buf[3];
+    
+    buf[0] = stop_bit;                                                /* set stop bit */
+    buf[1] = parity;                                                  /* set parity */
+    buf[2] = data_bit;                                                /* set data bit */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_UART_CONFIG, buf, NULL); /* write uart config */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get uart config
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *data_bit pointer to an uart data bit buffer
+ * @param[out] *parity pointer to an uart parity buffer
+ * @param[out] *stop_bit pointer to an uart stop bit buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get uart config failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 data_bit, parity or stop_bit is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_uart_config(ch9120_handle_t *handle, uint8_t *data_bit, ch9120_parity_t *parity, uint8_t *stop_bit)
+{
+    uint8_t res;
+    uint8_t buf[3];
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_UART_CONFIG, NULL,
+                      ((data_bit != NULL) && (parity != NULL) && (stop_bit != NULL)) ? buf : NULL); /* get uart config */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *stop_bit = buf[0];                                               /* get stop bit */
+    *parity = (ch9120_parity_t)buf[1];                                /* get parity */
+    *data_bit = buf[2];                                               /* get data bit */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     set uart timeout
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] timeout uart timeout
+ * @return    status code
+ *            - 0 success
+ *            - 1 set uart timeout failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_uart_timeout(ch9120_handle_t *handle, uint8_t timeout)
+{
+    uint8_t buf[4];
+    
+    buf[0] = timeout;                                                 /* set timeout */
+    buf[1] = 0x00;                                                    /* set 0x00 */
+    buf[2] = 0x00;                                                    /* set 0x00 */
+    buf[3] = 0x00;                                                    /* set 0x00 */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_UART_TIMEOUT, buf, NULL); /* write uart timeout */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get uart timeout
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *timeout pointer to an uart timeout buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get uart timeout failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 timeout is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_uart_timeout(ch9120_handle_t *handle, uint8_t *timeout)
+{
+    return ch9120_exec(handle, CH9120_COMMAND_GET_UART_TIMEOUT, NULL, timeout); /* get uart timeout */
+}
+#endif
+
+/**
+ * @brief      convert the uart timeout to the register raw data
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  ms timeout
+ * @param[out] *reg pointer to a register raw buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t ch9120_uart_timeout_convert_to_register(ch9120_handle_t *handle, uint16_t ms, uint8_t *reg)
+{
+    if (handle == NULL)              /* check handle */
+    {
+        return 2;                    /* return error */
+    }
+    if (handle->inited != 1)         /* check handle initialization */
+    {
+        return 3;                    /* return error */
+    }
+    
+    *reg = (uint8_t)(ms / 5);        /* convert real data to register data */
+    
+    return 0;                        /* success return 0 */
+}
+
+/**
+ * @brief      convert the register raw data to the offset
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  reg register raw data
+ * @param[out] *ms pointer to a ms buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t ch9120_uart_timeout_convert_to_data(ch9120_handle_t *handle, uint8_t reg, uint16_t *ms)
+{
+    if (handle == NULL)             /* check handle */
+    {
+        return 2;                   /* return error */
+    }
+    if (handle->inited != 1)        /* check handle initialization */
+    {
+        return 3;                   /* return error */
+    }
+    
+    *ms = reg * 5;                  /* convert raw data to real data */
+    
+    return 0;                       /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable random source port number
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set source port random failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_source_port_random(ch9120_handle_t *handle, ch9120_bool_t enable)
+{
+    uint8_t param;
+    
+    param = (uint8_t)enable;                                          /* set param */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_SOURCE_PORT_RANDOM, &param, NULL); /* write source port random */
+}
+
+/**
+ * @brief     set uart buffer length
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] len buffer length
+ * @return    status code
+ *            - 0 success
+ *            - 1 set uart buffer length failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_uart_buffer_length(ch9120_handle_t *handle, uint32_t len)
+{
+    uint8_t buf[4];
+    
+    buf[0] = (len >> 0) & 0xFF;                                       /* set len[0] */
+    buf[1] = (len >> 8) & 0xFF;                                       /* set len[8] */
+    buf[2] = (len >> 16) & 0xFF;                                      /* set len[16] */
+    buf[3] = (len >> 24) & 0xFF;                                      /* set len[24] */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_UART_BUFFER_LENGTH, buf, NULL); /* write uart buffer */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get uart buffer length
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *len pointer to a buffer length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get uart buffer length failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 len is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_uart_buffer_length(ch9120_handle_t *handle, uint32_t *len)
+{
+    uint8_t res;
+    uint8_t buf[4];
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_UART_BUFFER_LENGTH, NULL,
+                      (len != NULL) ? buf : NULL);                    /* read buffer length */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *len = (uint32_t)(((uint32_t)buf[0] << 0) | ((uint32_t)buf[1] << 8) |
+            ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));     /* get buffer length */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     enable or disable uart auto flush
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set uart flush failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable)
+{
+    uint8_t param;
+    
+    param = (uint8_t)enable;                                          /* set param */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_UART_FLUSH, &param, NULL); /* write flush */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get uart auto flush status
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get uart flush failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 enable is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_uart_flush(ch9120_handle_t *handle, ch9120_bool_t *enable)
+{
+    uint8_t res;
+    uint8_t param;
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_UART_FLUSH, NULL,
+                      (enable != NULL) ? &param : NULL);              /* get uart flush */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *enable = (ch9120_bool_t)(param);                                 /* get param */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+/**
+ * @brief     enable or disable disconnect with no rj45
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set disconnect with no rj45 failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t enable)
+{
+    uint8_t param;
+    
+    param = (uint8_t)enable;                                          /* set param */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_DISCONNECT_WITH_NO_RJ45, &param, NULL); /* write disconnect */
+}
+
+#if (CH9120_ENABLE_GETTERS == 1)
+/**
+ * @brief      get disconnect with no rj45 status
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get disconnect with no rj45 failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 5 enable is NULL
+ * @note       none
+ */
+uint8_t ch9120_get_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t *enable)
+{
+    uint8_t res;
+    uint8_t param;
+    
+    res = ch9120_exec(handle, CH9120_COMMAND_GET_DISCONNECT_WITH_NO_RJ45, NULL,
+                      (enable != NULL) ? &param : NULL);              /* get disconnect */
+    if (res != 0)                                                     /* check result */
+    {
+        return res;                                                   /* return error */
+    }
+    *enable = (ch9120_bool_t)(param);                                 /* get param */
+    
+    return 0;                                                         /* success return 0 */
+}
+#endif
+
+#if (CH9120_ENABLE_DHCP == 1)
+/**
+ * @brief     enable or disable dhcp
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set dhcp failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
+ */
+uint8_t ch9120_set_dhcp(ch9120_handle_t *handle, ch9120_bool_t enable)
+{
+    uint8_t param;
+    
+    param = (uint8_t)enable;                                          /* set param */
+    
+    return ch9120_exec(handle, CH9120_COMMAND_SET_DHCP, &param, NULL); /* dhcp */
+}
+#endif
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 uart initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 reset gpio init failed
+ *            - 5 cfg gpio init failed
+ *            - 6 reset failed
+ *            - 7 chip is not ready
+ *            - 8 mutex init failed
+ * @note      not locked, run it before other threads use the handle,
+ *            the chip is ready once two get version probes answer the same version,
+ *            the cached parameters of the eeprom record are read back from the chip
+ */
+uint8_t ch9120_init(ch9120_handle_t *handle)
+{
+    if (handle == NULL)                                                /* check handle */
+    {
+        return 2;                                                      /* return error */
+    }
+    if (handle->debug_print == NULL)                                   /* check debug_print */
+    {
+        return 3;                                                      /* return error */
+    }
+    if (handle->uart_init == NULL)                                     /* check uart_init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_init is null.\n");    /* uart_init is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->uart_deinit == NULL)                                   /* check uart_deinit */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_deinit is null.\n");  /* uart_deinit is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->uart_read == NULL)                                     /* check uart_read */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_read is null.\n");    /* uart_read is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->uart_write == NULL)                                    /* check uart_write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_write is null.\n");   /* uart_write is null */
+        
+        return 3;                                                      /* return error */
+    } 
+    if (handle->uart_flush == NULL)                                    /* check uart_flush */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_flush is null.\n");   /* uart_flush is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->delay_ms == NULL)                                      /* check delay_ms */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: delay_ms is null.\n");     /* delay_ms is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->reset_gpio_init == NULL)                               /* check reset_gpio_init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: reset_gpio_init is null.\n");     /* reset_gpio_init is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->reset_gpio_deinit == NULL)                             /* check reset_gpio_deinit */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: reset_gpio_deinit is null.\n");   /* reset_gpio_deinit is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->reset_gpio_write == NULL)                              /* check reset_gpio_write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: reset_gpio_write is null.\n");    /* reset_gpio_write is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->cfg_gpio_init == NULL)                                 /* check cfg_gpio_init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg_gpio_init is null.\n");       /* cfg_gpio_init is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->cfg_gpio_deinit == NULL)                               /* check cfg_gpio_deinit */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg_gpio_deinit is null.\n");     /* cfg_gpio_deinit is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (handle->cfg_gpio_write == NULL)                                /* check cfg_gpio_write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg_gpio_write is null.\n");      /* cfg_gpio_write is null */
+        
+        return 3;                                                      /* return error */
+    }
+    if (((handle->mutex_lock != NULL) || (handle->mutex_unlock != NULL)) &&
+        ((handle->mutex_lock == NULL) || (handle->mutex_unlock == NULL) ||
+         (handle->mutex_init == NULL) || (handle->mutex_deinit == NULL)))     /* check the mutex functions */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: mutex function is null.\n");      /* mutex function is null */
+        
+        return 3;                                                      /* return error */
+    }
+    
+    if (handle->uart_init() != 0)                                      /* uart init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart init failed.\n");     /* uart init failed */
+        
+        return 1;                                                      /* return error */
+    }
+    if (handle->reset_gpio_init() != 0)                                /* reset gpio init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: reset gpio init failed.\n");      /* reset gpio init failed */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        
+        return 4;                                                      /* return error */
+    }
+    if (handle->cfg_gpio_init() != 0)                                  /* cfg gpio init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio init failed.\n"); /* cfg gpio init failed */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        
+        return 5;                                                      /* return error */
+    }
+    if (handle->reset_gpio_write(0) != 0)                              /* set low */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio write failed.\n");       /* cfg gpio write failed */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
+        
+        return 6;                                                      /* return error */
+    }
+    handle->delay_ms(10);                                              /* delay 10ms */
+    if (handle->reset_gpio_write(1) != 0)                              /* set high */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio write failed.\n");       /* cfg gpio write failed */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
+        
+        return 6;                                                      /* return error */
+    }
+    handle->mutex_ctx = NULL;                                          /* no mutex context */
+    if ((handle->mutex_lock != NULL) && (handle->mutex_init(&handle->mutex_ctx) != 0))   /* mutex init */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: mutex init failed.\n");    /* mutex init failed */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
+        
+        return 8;                                                      /* return error */
+    }
+    handle->pending = 0;                                               /* clear pending */
+#if (CH9120_ENABLE_ASYNC == 1)
+    handle->async_state = CH9120_ASYNC_IDLE;                           /* no async command */
+#endif
+#if (CH9120_ENABLE_LOCK_STATS == 1)
+    memset(handle->lock_stats, 0, sizeof(handle->lock_stats));         /* clear the lock stats */
+#endif
+    a_ch9120_record_load(handle);                                      /* load the eeprom record */
+#if (CH9120_ENABLE_MONITOR == 1)
+    handle->monitor_enable = 0;                                        /* disable the monitor */
+#endif
+    handle->io_last_us = 0;                                            /* no data yet */
+    handle->peek_len = 0;                                              /* nothing lent */
+    if (a_ch9120_wait_ready(handle, 500) != 0)                         /* wait ready */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: chip is not ready.\n");    /* chip is not ready */
+        (void)handle->uart_deinit();                                   /* uart deinit */
+        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
+        a_ch9120_mutex_deinit(handle);                                 /* mutex deinit */
+        
+        return 7;                                                      /* return error */
+    }
+    a_ch9120_record_verify(handle);                                    /* check the record */
+    handle->inited = 1;                                                /* flag finish initialization */
+    
+    return 0;                                                          /* success return 0 */
 }
 
 /**
- * @brief      get ip address
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *ip pointer to an ip buffer
- * @return     status code
- *             - 0 success
- *             - 1 get ip failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     close the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 uart deinit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 reset failed
+ *            - 5 reset gpio deinit failed
+ *            - 6 cfg gpio deinit failed
+ * @note      the coalesced data is sent first, not locked, run it after other threads stop using the handle
  */
-uint8_t ch9120_get_ip(ch9120_handle_t *handle, uint8_t ip[4])
+uint8_t ch9120_deinit(ch9120_handle_t *handle)
 {
-    uint8_t cmd;
-    
     if (handle == NULL)                                               /* check handle */
     {
         return 2;                                                     /* return error */
@@ -573,30 +3478,54 @@ uint8_t ch9120_get_ip(ch9120_handle_t *handle, uint8_t ip[4])
         return 3;                                                     /* return error */
     }
     
-    cmd = CH9120_CMD_GET_IP;                                          /* get ip */
-    if (a_ch9120_write_read(handle, &cmd, 1, ip, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* read ip */
+#if (CH9120_ENABLE_COALESCE == 1)
+    (void)a_ch9120_tx_flush(handle);                                  /* send the last batch */
+#endif
+    if (a_ch9120_exec_run(handle, CH9120_COMMAND_RESET, NULL, NULL) != 0)    /* reset without the boot wait */
+    {
+        return 4;                                                     /* return error */
+    }
+    handle->delay_ms(10);                                             /* delay 10ms */
+    if (handle->uart_deinit() != 0)                                   /* uart deinit */
     {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart deinit failed.\n");  /* uart deinit failed */
+        
         return 1;                                                     /* return error */
     }
+    if (handle->reset_gpio_deinit() != 0)                             /* reset gpio deinit */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: reset gpio deinit failed.\n");   /* reset gpio deinit failed */
+        
+        return 5;                                                     /* return error */
+    }
+    if (handle->cfg_gpio_deinit() != 0)                               /* cfg gpio deinit */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio deinit failed.\n");     /* cfg gpio deinit failed */
+        
+        return 6;                                                     /* return error */
+    }
+    a_ch9120_mutex_deinit(handle);                                    /* mutex deinit */
     
     return 0;                                                         /* success return 0 */
 }
 
 /**
- * @brief     set subnet mask
+ * @brief     write data
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *mask pointer to a mask buffer
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
  * @return    status code
  *            - 0 success
- *            - 1 set subnet mask failed
+ *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      the data is batched when the write coalescer is set
  */
-uint8_t ch9120_set_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4])
+uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
 {
-    uint8_t cmd[5];
+#if (CH9120_ENABLE_COALESCE == 1)
+    uint16_t limit;
+#endif
     
     if (handle == NULL)                                              /* check handle */
     {
@@ -607,69 +3536,63 @@ uint8_t ch9120_set_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4])
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_NETMASK ;                                /* set sub mask  */
-    cmd[1] = mask[0];                                                /* set mask[0] */
-    cmd[2] = mask[1];                                                /* set mask[1] */
-    cmd[3] = mask[2];                                                /* set mask[2] */
-    cmd[4] = mask[3];                                                /* set mask[3] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write subnet mask */
+#if (CH9120_ENABLE_COALESCE == 1)
+    if (handle->tx_buf == NULL)                                      /* check coalescer */
     {
-        return 1;                                                    /* return error */
+        return a_ch9120_write_data(handle, buf, len);                /* write data */
     }
-    
-    return 0;                                                        /* success return 0 */
-}
-
-/**
- * @brief      get subnet mask
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *mask pointer to a mask buffer
- * @return     status code
- *             - 0 success
- *             - 1 get subnet mask failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
- */
-uint8_t ch9120_get_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4])
-{
-    uint8_t cmd;
-    
-    if (handle == NULL)                                             /* check handle */
+    limit = a_ch9120_tx_limit(handle);                               /* get limit */
+    if ((uint32_t)handle->tx_len + len > limit)                      /* check room */
     {
-        return 2;                                                   /* return error */
+        if (a_ch9120_tx_flush(handle) != 0)                          /* flush batch */
+        {
+            return 1;                                                /* return error */
+        }
     }
-    if (handle->inited != 1)                                        /* check handle initialization */
+    if (len >= limit)                                                /* check large write */
     {
-        return 3;                                                   /* return error */
+        return a_ch9120_write_data(handle, buf, len);                /* write data */
     }
-    
-    cmd = CH9120_CMD_GET_NETMASK ;                                  /* get mask */
-    if (a_ch9120_write_read(handle, &cmd, 1, mask, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)      /* read subnet mask */
+    if ((handle->tx_len == 0) && (handle->timestamp_us != NULL))     /* check first byte */
     {
-        return 1;                                                   /* return error */
+        handle->tx_first_us = handle->timestamp_us();                /* batch start */
+    }
+    memcpy(&handle->tx_buf[handle->tx_len], buf, len);               /* copy data */
+    handle->tx_len += len;                                           /* add length */
+    if (handle->tx_cork != 0)                                        /* check cork */
+    {
+        return 0;                                                    /* hold the batch */
+    }
+    if (handle->tx_len >= limit)                                     /* check full */
+    {
+        return a_ch9120_tx_flush(handle);                            /* flush batch */
     }
     
-    return 0;                                                       /* success return 0 */
+    return ch9120_write_handler(handle);                             /* check latency */
+#else
+    return a_ch9120_write_data(handle, buf, len);                    /* write data */
+#endif
 }
 
+#if (CH9120_ENABLE_COALESCE == 1)
 /**
- * @brief     set gateway
+ * @brief     set the write coalescer
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *ip pointer to an ip buffer
+ * @param[in] *buf pointer to a coalesce buffer, NULL takes a pool block when a pool is set
+ *                 and disables the coalescer otherwise
+ * @param[in] size coalesce buffer size, 0 disables the coalescer
+ * @param[in] latency_ms max time a byte is held, 0 means no limit
  * @return    status code
  *            - 0 success
- *            - 1 set gateway failed
+ *            - 1 flush failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 no pool block fits
+ * @note      a batch is sent as one uart burst when it reaches the buffer size or the
+ *            cached uart buffer length, the latency budget needs timestamp_us
  */
-uint8_t ch9120_set_gateway(ch9120_handle_t *handle, uint8_t ip[4])
+uint8_t ch9120_set_write_coalesce(ch9120_handle_t *handle, uint8_t *buf, uint16_t size, uint16_t latency_ms)
 {
-    uint8_t cmd[5];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -679,69 +3602,45 @@ uint8_t ch9120_set_gateway(ch9120_handle_t *handle, uint8_t ip[4])
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_GATEWAY ;                                /* set gateway  */
-    cmd[1] = ip[0];                                                  /* set ip[0] */
-    cmd[2] = ip[1];                                                  /* set ip[1] */
-    cmd[3] = ip[2];                                                  /* set ip[2] */
-    cmd[4] = ip[3];                                                  /* set ip[3] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write ip */
+    if (a_ch9120_tx_flush(handle) != 0)                              /* flush the old batch */
     {
         return 1;                                                    /* return error */
     }
-    
-    return 0;                                                        /* success return 0 */
-}
-
-/**
- * @brief      get gateway
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *ip pointer to an ip buffer
- * @return     status code
- *             - 0 success
- *             - 1 get gateway failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
- */
-uint8_t ch9120_get_gateway(ch9120_handle_t *handle, uint8_t ip[4])
-{
-    uint8_t cmd;
-    
-    if (handle == NULL)                                             /* check handle */
-    {
-        return 2;                                                   /* return error */
-    }
-    if (handle->inited != 1)                                        /* check handle initialization */
+#if (CH9120_ENABLE_POOL == 1)
+    if (a_ch9120_pool_take(handle, CH9120_POOL_OWN_TX, handle->tx_buf, 
+                           &buf, size) != 0)                         /* take a pool block */
     {
-        return 3;                                                   /* return error */
+        handle->tx_buf = NULL;                                       /* disable */
+        handle->tx_size = 0;                                         /* disable */
+        
+        return 4;                                                    /* return error */
     }
-    
-    cmd = CH9120_CMD_GET_GATEWAY;                                   /* get gateway */
-    if (a_ch9120_write_read(handle, &cmd, 1, ip, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)      /* read gateway */
+#endif
+    if (size == 0)                                                   /* check size */
     {
-        return 1;                                                   /* return error */
+        buf = NULL;                                                  /* disable */
     }
+    handle->tx_buf = buf;                                            /* set buffer */
+    handle->tx_size = (buf != NULL) ? size : 0;                      /* set size */
+    handle->tx_latency_ms = latency_ms;                              /* set latency */
+    handle->tx_cork = 0;                                             /* uncork */
     
-    return 0;                                                       /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     set source port
+ * @brief     enable or disable the write cork
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] num source port
+ * @param[in] enable bool value
  * @return    status code
  *            - 0 success
- *            - 1 set source port failed
+ *            - 1 flush failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      a corked batch is only sent when the buffer is full, uncork sends it
  */
-uint8_t ch9120_set_source_port(ch9120_handle_t *handle, uint16_t num)
+uint8_t ch9120_set_write_cork(ch9120_handle_t *handle, ch9120_bool_t enable)
 {
-    uint8_t cmd[3];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -751,70 +3650,51 @@ uint8_t ch9120_set_source_port(ch9120_handle_t *handle, uint16_t num)
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_PORT;                                    /* set port */
-    cmd[1] = (num >> 0) & 0xFF;                                      /* set port msb */
-    cmd[2] = (num >> 8) & 0xFF;                                      /* set port lsb */
-    if (a_ch9120_write_check(handle, cmd, 3,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write port */
+    handle->tx_cork = (uint8_t)enable;                               /* set cork */
+    if (enable == CH9120_BOOL_FALSE)                                 /* check uncork */
     {
-        return 1;                                                    /* return error */
+        return a_ch9120_tx_flush(handle);                            /* flush batch */
     }
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get source port
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *num pointer to a source port buffer
- * @return     status code
- *             - 0 success
- *             - 1 get source port failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
- */
-uint8_t ch9120_get_source_port(ch9120_handle_t *handle, uint16_t *num)
-{
-    uint8_t cmd;
-    uint8_t buf[2];
-    
-    if (handle == NULL)                                               /* check handle */
-    {
-        return 2;                                                     /* return error */
-    }
-    if (handle->inited != 1)                                          /* check handle initialization */
+ * @brief     flush the coalesced data
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      flush before changing the dest to keep the data on the old session
+ */
+uint8_t ch9120_write_flush(ch9120_handle_t *handle)
+{
+    if (handle == NULL)                                              /* check handle */
     {
-        return 3;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    
-
-    cmd = CH9120_CMD_GET_PORT;                                        /* get port */
-    if (a_ch9120_write_read(handle, &cmd, 1, buf, 2,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get port */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 1;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
-    *num= (uint16_t)((uint16_t)buf[1] << 8 | buf[0]);                 /* get port */
     
-    return 0;                                                         /* success return 0 */
+    return a_ch9120_tx_flush(handle);                                /* flush batch */
 }
 
 /**
- * @brief     set dest ip
+ * @brief     write coalescer handler
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *ip pointer to an ip buffer
  * @return    status code
  *            - 0 success
- *            - 1 set dest ip failed
+ *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      call it from the main loop, it flushes a batch once its latency budget is over
  */
-uint8_t ch9120_set_dest_ip(ch9120_handle_t *handle, uint8_t ip[4])
+uint8_t ch9120_write_handler(ch9120_handle_t *handle)
 {
-    uint8_t cmd[5];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -824,69 +3704,107 @@ uint8_t ch9120_set_dest_ip(ch9120_handle_t *handle, uint8_t ip[4])
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_DST_IP;                                  /* set dest ip */
-    cmd[1] = ip[0];                                                  /* set ip[0] */
-    cmd[2] = ip[1];                                                  /* set ip[1] */
-    cmd[3] = ip[2];                                                  /* set ip[0] */
-    cmd[4] = ip[3];                                                  /* set ip[1] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write dest ip */
+    if ((handle->tx_len == 0) || (handle->tx_cork != 0) ||
+        (handle->tx_latency_ms == 0) || (handle->timestamp_us == NULL))   /* check budget */
     {
-        return 1;                                                    /* return error */
+        return 0;                                                    /* success return 0 */
+    }
+    if ((handle->timestamp_us() - handle->tx_first_us) < 
+        (uint64_t)handle->tx_latency_ms * 1000)                      /* check due */
+    {
+        return 0;                                                    /* not due */
     }
     
-    return 0;                                                        /* success return 0 */
+    return a_ch9120_tx_flush(handle);                                /* flush batch */
 }
 
 /**
- * @brief      get dest ip
+ * @brief      get the coalesced data length
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *ip pointer to an ip buffer
+ * @param[out] *len pointer to a length buffer
  * @return     status code
  *             - 0 success
- *             - 1 get dest ip failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t ch9120_get_dest_ip(ch9120_handle_t *handle, uint8_t ip[4])
+uint8_t ch9120_get_write_pending(ch9120_handle_t *handle, uint16_t *len)
 {
-    uint8_t cmd;
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_DST_IP;                                      /* get dest ip */
-    if (a_ch9120_write_read(handle, &cmd, 1, ip, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get dest ip */
+    *len = handle->tx_len;                                           /* get length */
+    
+    return 0;                                                        /* success return 0 */
+}
+#endif
+
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+/**
+ * @brief     start the uart auto tune
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *sample pointer to a sample buffer, NULL stops the training
+ * @param[in] num sample number
+ * @param[in] window_ms max training time, 0 means until the buffer is full
+ * @param[in] latency_ms max time from the first byte of a packet to its send
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ * @note      every uart burst of the data path is sampled until the buffer is full or
+ *            the window is over, then ch9120_autotune_handler applies the result
+ */
+uint8_t ch9120_set_autotune(ch9120_handle_t *handle, ch9120_autotune_sample_t *sample, uint16_t num,
+                            uint32_t window_ms, uint16_t latency_ms)
+{
+    if (handle == NULL)                                              /* check handle */
     {
-        return 1;                                                     /* return error */
+        return 2;                                                    /* return error */
+    }
+    if (handle->inited != 1)                                         /* check handle initialization */
+    {
+        return 3;                                                    /* return error */
+    }
+    if ((sample != NULL) && (handle->timestamp_us == NULL))          /* check timestamp_us */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: timestamp_us is null.\n");      /* timestamp_us is null */
+        
+        return 4;                                                    /* return error */
     }
     
+    handle->tune_sample = (num != 0) ? sample : NULL;                /* set buffer */
+    handle->tune_num = num;                                          /* set number */
+    handle->tune_count = 0;                                          /* clear count */
+    handle->tune_window_ms = window_ms;                              /* set window */
+    handle->tune_latency_ms = latency_ms;                            /* set latency */
     
-    return 0;                                                         /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     set dest port
+ * @brief     uart auto tune handler
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] num dest port
  * @return    status code
  *            - 0 success
- *            - 1 set dest port failed
+ *            - 1 apply failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      call it from the main loop, after the training it picks the uart timeout and
+ *            the uart buffer length with the fewest packets within the latency target
+ *            and saves them to the eeprom
  */
-uint8_t ch9120_set_dest_port(ch9120_handle_t *handle, uint16_t num)
+uint8_t ch9120_autotune_handler(ch9120_handle_t *handle)
 {
-    uint8_t cmd[3];
+    uint8_t reg;
+    uint16_t timeout_ms;
+    uint32_t len;
     
     if (handle == NULL)                                              /* check handle */
     {
@@ -897,69 +3815,90 @@ uint8_t ch9120_set_dest_port(ch9120_handle_t *handle, uint16_t num)
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_DST_PORT;                                /* set dest port */
-    cmd[1] = (num >> 0) & 0xFF;                                      /* set port msb */
-    cmd[2] = (num >> 8) & 0xFF;                                      /* set port lsb */
-    if (a_ch9120_write_check(handle, cmd, 3,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write dest port */
+    if ((handle->tune_sample == NULL) || (handle->tune_count == 0))  /* check training */
+    {
+        return 0;                                                    /* success return 0 */
+    }
+    if ((handle->tune_count < handle->tune_num) &&
+        ((handle->tune_window_ms == 0) || 
+        ((handle->timestamp_us() - handle->tune_start_us) < 
+         (uint64_t)handle->tune_window_ms * 1000)))                  /* check the end */
+    {
+        return 0;                                                    /* still training */
+    }
+    
+    a_ch9120_tune_pick(handle, &timeout_ms, &len);                   /* pick the settings */
+    handle->tune_sample = NULL;                                      /* stop training */
+    reg = (uint8_t)(timeout_ms / 5);                                 /* convert to register */
+    if (ch9120_set_uart_timeout(handle, reg) != 0)                   /* set uart timeout */
+    {
+        return 1;                                                    /* return error */
+    }
+    if (ch9120_set_uart_buffer_length(handle, len) != 0)             /* set uart buffer length */
     {
         return 1;                                                    /* return error */
     }
+    if (ch9120_apply(handle, CH9120_APPLY_AUTO) != 0)                /* save only if changed */
+    {
+        return 1;                                                    /* return error */
+    }
+    handle->tune_timeout_ms = timeout_ms;                            /* save timeout */
+    handle->tune_len = len;                                          /* save length */
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get dest port
+ * @brief      get the uart auto tune result
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *num pointer to a dest port buffer
+ * @param[out] *timeout_ms pointer to a uart timeout buffer
+ * @param[out] *len pointer to a uart buffer length buffer
  * @return     status code
  *             - 0 success
- *             - 1 get dest port failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 4 no result
  * @note       none
  */
-uint8_t ch9120_get_dest_port(ch9120_handle_t *handle, uint16_t *num)
+uint8_t ch9120_get_autotune(ch9120_handle_t *handle, uint16_t *timeout_ms, uint32_t *len)
 {
-    uint8_t cmd;
-    uint8_t buf[2];
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
-    
-    cmd = CH9120_CMD_GET_DST_PORT;                                    /* get dest port */
-    if (a_ch9120_write_read(handle, &cmd, 1, buf, 2,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get dest port */
+    if (handle->tune_len == 0)                                       /* check result */
     {
-        return 1;                                                     /* return error */
+        return 4;                                                    /* return error */
     }
-    *num= (uint16_t)((uint16_t)buf[1] << 8 | buf[0]);                 /* get port */
     
-    return 0;                                                         /* success return 0 */
+    *timeout_ms = handle->tune_timeout_ms;                           /* get timeout */
+    *len = handle->tune_len;                                         /* get length */
+    
+    return 0;                                                        /* success return 0 */
 }
+#endif
 
+#if (CH9120_ENABLE_FRAME == 1)
 /**
- * @brief     set uart baud
+ * @brief     set the message framing
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] baud chip baud
+ * @param[in] type frame type
+ * @param[in] *buf pointer to a decode buffer, NULL takes a pool block when a pool is set
+ *                 and only sends frames otherwise
+ * @param[in] size decode buffer size, the longest encoded frame
  * @return    status code
  *            - 0 success
- *            - 1 set uart baud failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 no pool block fits
+ * @note      the decode buffer holds the partial frame and the bytes read after it
  */
-uint8_t ch9120_set_uart_baud(ch9120_handle_t *handle, uint32_t baud)
+uint8_t ch9120_set_frame(ch9120_handle_t *handle, ch9120_frame_t type, uint8_t *buf, uint16_t size)
 {
-    uint8_t cmd[5];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -969,74 +3908,40 @@ uint8_t ch9120_set_uart_baud(ch9120_handle_t *handle, uint32_t baud)
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_BAUD;                                    /* set baud */
-    cmd[1] = (baud >> 0) & 0xFF;                                     /* set baud[0] */
-    cmd[2] = (baud >> 8) & 0xFF;                                     /* set baud[8] */
-    cmd[3] = (baud >> 16) & 0xFF;                                    /* set baud[16] */
-    cmd[4] = (baud >> 24) & 0xFF;                                    /* set baud[24] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write dest port */
+#if (CH9120_ENABLE_POOL == 1)
+    if (a_ch9120_pool_take(handle, CH9120_POOL_OWN_FRAME, handle->frame_buf, 
+                           &buf, size) != 0)                         /* take a pool block */
     {
-        return 1;                                                    /* return error */
+        handle->frame_buf = NULL;                                    /* only send */
+        handle->frame_size = 0;                                      /* only send */
+        
+        return 4;                                                    /* return error */
     }
+#endif
+    handle->frame_type = (uint8_t)type;                              /* set type */
+    handle->frame_buf = (size != 0) ? buf : NULL;                    /* set buffer */
+    handle->frame_size = (buf != NULL) ? size : 0;                   /* set size */
+    handle->frame_pos = 0;                                           /* no raw bytes */
+    handle->frame_raw = 0;                                           /* no raw bytes */
+    handle->frame_errors = 0;                                        /* clear errors */
+    a_ch9120_frame_reset(handle);                                    /* reset decoder */
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get uart baud
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *baud pointer to a baud buffer
- * @return     status code
- *             - 0 success
- *             - 1 get uart baud failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
- */
-uint8_t ch9120_get_uart_baud(ch9120_handle_t *handle, uint32_t *baud)
-{
-    uint8_t cmd;
-    uint8_t buf[4];
-    
-    if (handle == NULL)                                                      /* check handle */
-    {
-        return 2;                                                            /* return error */
-    }
-    if (handle->inited != 1)                                                 /* check handle initialization */
-    {
-        return 3;                                                            /* return error */
-    }
-    
-    cmd = CH9120_CMD_GET_BAUD;                                               /* get baud */
-    if (a_ch9120_write_read(handle, &cmd, 1, buf, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)               /* get dest port */
-    {
-        return 1;                                                            /* return error */
-    }
-    *baud = (uint32_t)(((uint32_t)buf[0] << 0) | ((uint32_t)buf[1] << 8) |
-            ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));            /* get baud */
-    
-    return 0;                                                                /* success return 0 */
-}
-
-/**
- * @brief     set uart config
+ * @brief     set the frame crc
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] data_bit uart data bit
- * @param[in] parity uart parity
- * @param[in] stop_bit uart stop bit
+ * @param[in] crc frame crc type
  * @return    status code
  *            - 0 success
- *            - 1 set uart config failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      the crc of the data is sent little endian after it, inside the frame,
+ *            received frames with a wrong crc are dropped and counted as broken
  */
-uint8_t ch9120_set_uart_config(ch9120_handle_t *handle, uint8_t data_bit, ch9120_parity_t parity, uint8_t stop_bit)
+uint8_t ch9120_set_frame_crc(ch9120_handle_t *handle, ch9120_frame_crc_t crc)
 {
-    uint8_t cmd[4];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1046,74 +3951,54 @@ uint8_t ch9120_set_uart_config(ch9120_handle_t *handle, uint8_t data_bit, ch9120
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_CONFIG;                                  /* set config */
-    cmd[1] = stop_bit;                                               /* set stop bit */
-    cmd[2] = parity;                                                 /* set parity */
-    cmd[3] = data_bit;                                               /* set data bit */
-    if (a_ch9120_write_check(handle, cmd, 4,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write dest port */
-    {
-        return 1;                                                    /* return error */
-    }
+    handle->frame_crc = (uint8_t)crc;                                /* set crc */
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get uart config
+ * @brief      get the frame crc
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *data_bit pointer to an uart data bit buffer
- * @param[out] *parity pointer to an uart parity buffer
- * @param[out] *stop_bit pointer to an uart stop bit buffer
+ * @param[out] *crc pointer to a frame crc type buffer
  * @return     status code
  *             - 0 success
- *             - 1 get uart config failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t ch9120_get_uart_config(ch9120_handle_t *handle, uint8_t *data_bit, ch9120_parity_t *parity, uint8_t *stop_bit)
+uint8_t ch9120_get_frame_crc(ch9120_handle_t *handle, ch9120_frame_crc_t *crc)
 {
-    uint8_t cmd;
-    uint8_t buf[3];
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_CONFIG;                                      /* get config */
-    if (a_ch9120_write_read(handle, &cmd, 1, buf, 3,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get dest port */
-    {
-        return 1;                                                     /* return error */
-    }
-    *stop_bit = buf[0];                                               /* get stop bit */
-    *parity = (ch9120_parity_t)buf[1];                                /* get parity */
-    *data_bit = buf[2];                                               /* get data bit */
+    *crc = (ch9120_frame_crc_t)(handle->frame_crc);                  /* get crc */
     
-    return 0;                                                         /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     set uart timeout
+ * @brief     set the frame compression
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] timeout uart timeout
+ * @param[in] enable bool value
+ * @param[in] *buf pointer to a compress buffer, NULL takes a pool block when a pool is set
+ *                 and only receives otherwise
+ * @param[in] size compress buffer size, the longest frame data plus 1
  * @return    status code
  *            - 0 success
- *            - 1 set uart timeout failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 no pool block fits
+ * @note      both ends of the session must enable it, every payload then starts with a codec
+ *            byte and is only sent compressed when it gets smaller
  */
-uint8_t ch9120_set_uart_timeout(ch9120_handle_t *handle, uint8_t timeout)
+uint8_t ch9120_set_frame_compress(ch9120_handle_t *handle, ch9120_bool_t enable, uint8_t *buf, uint16_t size)
 {
-    uint8_t cmd[5];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1123,123 +4008,306 @@ uint8_t ch9120_set_uart_timeout(ch9120_handle_t *handle, uint8_t timeout)
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_TIMEOUT;                                 /* set timeout */
-    cmd[1] = timeout;                                                /* set timeout */
-    cmd[2] = 0x00;                                                   /* set 0x00 */
-    cmd[3] = 0x00;                                                   /* set 0x00 */
-    cmd[4] = 0x00;                                                   /* set 0x00 */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write uart timeout */
+#if (CH9120_ENABLE_POOL == 1)
+    if (a_ch9120_pool_take(handle, CH9120_POOL_OWN_ZIP, handle->zip_buf, 
+                           &buf, size) != 0)                         /* take a pool block */
     {
-        return 1;                                                    /* return error */
+        handle->zip_buf = NULL;                                      /* only receive */
+        handle->zip_size = 0;                                        /* only receive */
+        
+        return 4;                                                    /* return error */
     }
+#endif
+    handle->frame_zip = (uint8_t)enable;                             /* set compression */
+    handle->zip_buf = (size != 0) ? buf : NULL;                      /* set buffer */
+    handle->zip_size = (buf != NULL) ? size : 0;                     /* set size */
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get uart timeout
+ * @brief      get the frame compression
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *timeout pointer to an uart timeout buffer
+ * @param[out] *enable pointer to a bool value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get uart timeout failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t ch9120_get_uart_timeout(ch9120_handle_t *handle, uint8_t *timeout)
+uint8_t ch9120_get_frame_compress(ch9120_handle_t *handle, ch9120_bool_t *enable)
 {
-    uint8_t cmd;
-    
-    if (handle == NULL)                                           /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                 /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                      /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                 /* return error */
+        return 3;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_TIMEOUT;                                 /* get timeout */
-    if (a_ch9120_write_read(handle, &cmd, 1, timeout, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)    /* get uart timeout */
-    {
-        return 1;                                                 /* return error */
-    }
+    *enable = (ch9120_bool_t)(handle->frame_zip);                    /* get compression */
     
-    return 0;                                                     /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      convert the uart timeout to the register raw data
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[in]  ms timeout
- * @param[out] *reg pointer to a register raw buffer
- * @return     status code
- *             - 0 success
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     send a frame
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 compress buffer is too small
+ * @note      the frame is encoded in small chunks through ch9120_write
  */
-uint8_t ch9120_uart_timeout_convert_to_register(ch9120_handle_t *handle, uint16_t ms, uint8_t *reg)
+uint8_t ch9120_send_frame(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
 {
-    if (handle == NULL)              /* check handle */
+    uint8_t b;
+    uint8_t res;
+    uint8_t trailer[4];
+    uint16_t n;
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t crc;
+    uint32_t total;
+    uint8_t out[CH9120_FRAME_CHUNK];
+    
+    if (handle == NULL)                                              /* check handle */
+    {
+        return 2;                                                    /* return error */
+    }
+    if (handle->inited != 1)                                         /* check handle initialization */
+    {
+        return 3;                                                    /* return error */
+    }
+    
+    if (handle->frame_zip != 0)                                      /* check compression */
+    {
+        if ((handle->zip_buf == NULL) || ((uint32_t)len + 1 > handle->zip_size))   /* check buffer */
+        {
+            CH9120_DEBUG_PRINT(handle, "ch9120: compress buffer is too small.\n");  /* compress buffer is too small */
+            
+            return 4;                                                /* return error */
+        }
+        n = a_ch9120_zip(buf, len, &handle->zip_buf[1], handle->zip_size - 1);   /* compress */
+        if (n != 0)                                                  /* check result */
+        {
+            handle->zip_buf[0] = CH9120_ZIP_LZ;                      /* compressed */
+            len = n + 1;                                             /* codec and data */
+        }
+        else
+        {
+            handle->zip_buf[0] = CH9120_ZIP_RAW;                     /* stored */
+            memcpy(&handle->zip_buf[1], buf, len);                   /* copy data */
+            len = len + 1;                                           /* codec and data */
+        }
+        buf = handle->zip_buf;                                       /* send the payload */
+    }
+    crc = a_ch9120_frame_crc(handle, buf, len);                      /* get crc */
+    trailer[0] = (uint8_t)(crc >> 0);                                /* set trailer */
+    trailer[1] = (uint8_t)(crc >> 8);                                /* set trailer */
+    trailer[2] = (uint8_t)(crc >> 16);                               /* set trailer */
+    trailer[3] = (uint8_t)(crc >> 24);                               /* set trailer */
+    total = (uint32_t)len + a_ch9120_frame_crc_len(handle);          /* data and trailer */
+    res = 0;                                                         /* init 0 */
+    n = 0;                                                           /* init 0 */
+    if (handle->frame_type == CH9120_FRAME_COBS)                     /* cobs */
+    {
+        i = 0;                                                       /* init 0 */
+        while (res == 0)                                             /* every block */
+        {
+            k = 0;                                                   /* init 0 */
+            while ((i + k < total) && (k < 254) &&
+                   (a_ch9120_frame_at(buf, len, trailer, i + k) != 0x00))  /* find the block */
+            {
+                k++;                                                 /* k++ */
+            }
+            res = a_ch9120_frame_put(handle, out, &n, (uint8_t)(k + 1)); /* block code */
+            for (j = 0; (j < k) && (res == 0); j++)                  /* block data */
+            {
+                res = a_ch9120_frame_put(handle, out, &n, 
+                                         a_ch9120_frame_at(buf, len, trailer, i + j));  /* put data */
+            }
+            i += k;                                                  /* next block */
+            if (i >= total)                                          /* check the end */
+            {
+                break;                                               /* break */
+            }
+            if (k < 254)                                             /* ended by a zero */
+            {
+                i++;                                                 /* skip the zero */
+                if ((i >= total) && (res == 0))                      /* trailing zero */
+                {
+                    res = a_ch9120_frame_put(handle, out, &n, 0x01); /* empty block */
+                    
+                    break;                                           /* break */
+                }
+            }
+        }
+        if (res == 0)                                                /* check result */
+        {
+            res = a_ch9120_frame_put(handle, out, &n, 0x00);         /* frame end */
+        }
+    }
+    else                                                             /* slip */
+    {
+        res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_END);  /* flush line noise */
+        for (i = 0; (i < total) && (res == 0); i++)                  /* every byte */
+        {
+            b = a_ch9120_frame_at(buf, len, trailer, i);             /* get byte */
+            if (b == CH9120_SLIP_END)                                /* frame end */
+            {
+                res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_ESC);        /* escape */
+                if (res == 0)                                        /* check result */
+                {
+                    res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_ESC_END);/* escaped end */
+                }
+            }
+            else if (b == CH9120_SLIP_ESC)                           /* escape */
+            {
+                res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_ESC);        /* escape */
+                if (res == 0)                                        /* check result */
+                {
+                    res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_ESC_ESC);/* escaped escape */
+                }
+            }
+            else
+            {
+                res = a_ch9120_frame_put(handle, out, &n, b);        /* put data */
+            }
+        }
+        if (res == 0)                                                /* check result */
+        {
+            res = a_ch9120_frame_put(handle, out, &n, CH9120_SLIP_END);   /* frame end */
+        }
+    }
+    if ((res == 0) && (n != 0))                                      /* check the rest */
     {
-        return 2;                    /* return error */
+        res = ch9120_write(handle, out, n);                          /* write the rest */
     }
-    if (handle->inited != 1)         /* check handle initialization */
+    if (res != 0)                                                    /* check result */
     {
-        return 3;                    /* return error */
+        CH9120_DEBUG_PRINT(handle, "ch9120: send frame failed.\n");  /* send frame failed */
+        
+        return 1;                                                    /* return error */
     }
     
-    *reg = (uint8_t)(ms / 5);        /* convert real data to register data */
-    
-    return 0;                        /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      convert the register raw data to the offset
- * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[in]  reg register raw data
- * @param[out] *ms pointer to a ms buffer
- * @return     status code
- *             - 0 success
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief         receive a frame
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ *                - 4 no decode buffer
+ *                - 5 buffer is too small
+ * @note          len is 0 until a whole frame has arrived, the bytes read so far are decoded
+ *                and kept, a frame longer than the decode buffer is dropped,
+ *                after 5 the frame is kept for the next call
  */
-uint8_t ch9120_uart_timeout_convert_to_data(ch9120_handle_t *handle, uint8_t reg, uint16_t *ms)
+uint8_t ch9120_recv_frame(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len)
 {
-    if (handle == NULL)             /* check handle */
+    uint8_t res;
+    uint16_t l;
+    
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                   /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)        /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                   /* return error */
+        return 3;                                                    /* return error */
+    }
+    if (handle->frame_buf == NULL)                                   /* check buffer */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: no decode buffer.\n");   /* no decode buffer */
+        
+        return 4;                                                    /* return error */
     }
     
-    *ms = reg * 5;                  /* convert raw data to real data */
-    
-    return 0;                       /* success return 0 */
+    while (1)                                                        /* until no data */
+    {
+        while (handle->frame_pos < handle->frame_raw)                /* decode the raw bytes */
+        {
+            if ((a_ch9120_frame_decode(handle, handle->frame_buf[handle->frame_pos]) != 0) &&
+                (a_ch9120_frame_check(handle) != 0))                 /* check frame end */
+            {
+                l = handle->frame_len - a_ch9120_frame_crc_len(handle);  /* data length */
+                res = a_ch9120_frame_output(handle, l, buf, len);    /* output the frame */
+                if (res == 5)                                        /* check buffer */
+                {
+                    CH9120_DEBUG_PRINT(handle, "ch9120: buffer is too small.\n");   /* buffer is too small */
+                    
+                    return 5;                                        /* return error */
+                }
+                handle->frame_pos++;                                 /* consume the end */
+                if (res != 0)                                        /* check payload */
+                {
+                    CH9120_DEBUG_PRINT(handle, "ch9120: frame payload is broken.\n");   /* frame payload is broken */
+                    handle->frame_errors++;                          /* broken frame */
+                    a_ch9120_frame_reset(handle);                    /* drop the frame */
+                    
+                    continue;                                        /* next frame */
+                }
+                handle->frame_raw -= handle->frame_pos;              /* raw bytes left */
+                memmove(handle->frame_buf, &handle->frame_buf[handle->frame_pos],
+                        handle->frame_raw);                          /* keep the next frame */
+                handle->frame_pos = 0;                               /* restart */
+                a_ch9120_frame_reset(handle);                        /* reset decoder */
+                
+                return 0;                                            /* success return 0 */
+            }
+            handle->frame_pos++;                                     /* next raw byte */
+        }
+        handle->frame_raw = handle->frame_len;                       /* raw bytes follow the decoded ones */
+        handle->frame_pos = handle->frame_len;                       /* raw bytes follow the decoded ones */
+        if (handle->frame_raw >= handle->frame_size)                 /* check full */
+        {
+            CH9120_DEBUG_PRINT(handle, "ch9120: frame is too long.\n");     /* frame is too long */
+            handle->frame_errors++;                                  /* broken frame */
+            a_ch9120_frame_reset(handle);                            /* reset decoder */
+            handle->frame_drop = 1;                                  /* drop the rest */
+            handle->frame_raw = 0;                                   /* no raw bytes */
+            handle->frame_pos = 0;                                   /* no raw bytes */
+        }
+        l = handle->frame_size - handle->frame_raw;                  /* free space */
+        if (ch9120_read(handle, &handle->frame_buf[handle->frame_raw], &l) != 0)   /* read data */
+        {
+            return 1;                                                /* return error */
+        }
+        if (l == 0)                                                  /* check data */
+        {
+            *len = 0;                                                /* no frame */
+            
+            return 0;                                                /* success return 0 */
+        }
+        handle->frame_raw += l;                                      /* add raw bytes */
+    }
 }
 
 /**
- * @brief     enable or disable random source port number
- * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] enable bool value
- * @return    status code
- *            - 0 success
- *            - 1 set source port random failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief      get the broken frame count
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *count pointer to a count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       truncated, badly escaped, too long, crc failed and undecodable frames are counted
  */
-uint8_t ch9120_set_source_port_random(ch9120_handle_t *handle, ch9120_bool_t enable)
+uint8_t ch9120_get_frame_errors(ch9120_handle_t *handle, uint32_t *count)
 {
-    uint8_t cmd[2];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1249,31 +4317,31 @@ uint8_t ch9120_set_source_port_random(ch9120_handle_t *handle, ch9120_bool_t ena
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_RANDOM_PORT;                                 /* set random */
-    cmd[1] = enable;                                                 /* set bool */
-    if (a_ch9120_write_check(handle, cmd, 2,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write source port random */
-    {
-        return 1;                                                    /* return error */
-    }
+    *count = handle->frame_errors;                                   /* get count */
     
     return 0;                                                        /* success return 0 */
 }
+#endif
 
+#if (CH9120_ENABLE_POOL == 1)
 /**
- * @brief     set uart buffer length
+ * @brief     set the block pool
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] len buffer length
+ * @param[in] *buf pointer to the pool memory, 2 byte aligned, NULL removes the pool
+ * @param[in] block_size block size, even and at least 2
+ * @param[in] block_num block number, less than 65535
  * @return    status code
  *            - 0 success
- *            - 1 set uart buffer length failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 block size or number is invalid
+ *            - 5 pool is in use
+ * @note      the memory holds block_size * block_num bytes, alloc and free are O(1),
+ *            the coalescer and the framing take a block when they are set with a NULL buffer
  */
-uint8_t ch9120_set_uart_buffer_length(ch9120_handle_t *handle, uint32_t len)
+uint8_t ch9120_set_pool(ch9120_handle_t *handle, uint8_t *buf, uint16_t block_size, uint16_t block_num)
 {
-    uint8_t cmd[5];
+    uint16_t i;
     
     if (handle == NULL)                                              /* check handle */
     {
@@ -1283,73 +4351,93 @@ uint8_t ch9120_set_uart_buffer_length(ch9120_handle_t *handle, uint32_t len)
     {
         return 3;                                                    /* return error */
     }
+    if (handle->pool_used != 0)                                      /* check used */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: pool is in use.\n");     /* pool is in use */
+        
+        return 5;                                                    /* return error */
+    }
+    if ((buf != NULL) && ((block_size < 2) || ((block_size % 2) != 0) || 
+        (block_num == 0) || (block_num >= CH9120_POOL_EMPTY) ||
+        (((uintptr_t)buf % 2) != 0)))                                /* check block */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: block is invalid.\n");   /* block is invalid */
+        
+        return 4;                                                    /* return error */
+    }
     
-    cmd[0] = CH9120_CMD_SET_LEN;                                     /* set uart buffer */
-    cmd[1] = (len >> 0) & 0xFF;                                      /* set len[0] */
-    cmd[2] = (len >> 8) & 0xFF;                                      /* set len[8] */
-    cmd[3] = (len >> 16) & 0xFF;                                     /* set len[16] */
-    cmd[4] = (len >> 24) & 0xFF;                                     /* set len[24] */
-    if (a_ch9120_write_check(handle, cmd, 5,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write uart buffer */
+    handle->pool_buf = buf;                                          /* set memory */
+    handle->pool_block = (buf != NULL) ? block_size : 0;             /* set block size */
+    handle->pool_num = (buf != NULL) ? block_num : 0;                /* set block number */
+    handle->pool_head = CH9120_POOL_EMPTY;                           /* empty */
+    handle->pool_used = 0;                                           /* no block used */
+    handle->pool_peak = 0;                                           /* clear peak */
+    handle->pool_allocs = 0;                                         /* clear allocs */
+    handle->pool_fails = 0;                                          /* clear fails */
+    for (i = handle->pool_num; i != 0; i--)                          /* link the blocks */
     {
-        return 1;                                                    /* return error */
+        *(uint16_t *)&buf[(uint32_t)(i - 1) * block_size] = 
+                     (uint16_t)(handle->pool_head & 0xFFFF);         /* link the head */
+        handle->pool_head = (uint32_t)(i - 1);                       /* set head */
     }
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get uart buffer length
+ * @brief      alloc a pool block
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *len pointer to a buffer length buffer
+ * @param[out] **block pointer to a block pointer
  * @return     status code
  *             - 0 success
- *             - 1 get uart buffer length failed
+ *             - 1 pool is empty
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ * @note       it may run from any thread when CH9120_POOL_LOCK_FREE is 1
  */
-uint8_t ch9120_get_uart_buffer_length(ch9120_handle_t *handle, uint32_t *len)
+uint8_t ch9120_pool_alloc(ch9120_handle_t *handle, uint8_t **block)
 {
-    uint8_t cmd;
-    uint8_t buf[4];
-    
-    if (handle == NULL)                                                          /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                                /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                                     /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                                /* return error */
+        return 3;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_LEN;                                                    /* get uart buffer length */
-    if (a_ch9120_write_read(handle, &cmd, 1, buf, 4,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)                   /* read buffer length */
+    if (handle->pool_num == 0)                                       /* check pool */
     {
-        return 1;                                                                /* return error */
+        *block = NULL;                                               /* no block */
+        
+        return 1;                                                    /* return error */
+    }
+    *block = a_ch9120_pool_pop(handle);                              /* pop a block */
+    if (*block == NULL)                                              /* check block */
+    {
+        return 1;                                                    /* return error */
     }
-    *len = (uint32_t)(((uint32_t)buf[0] << 0) | ((uint32_t)buf[1] << 8) |
-            ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24));                /* get length */
     
-    return 0;                                                                    /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     enable or disable uart auto flush
+ * @brief     free a pool block
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] enable bool value
+ * @param[in] *block pointer to a block
  * @return    status code
  *            - 0 success
- *            - 1 set uart flush failed
+ *            - 1 block is invalid
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      it may run from any thread when CH9120_POOL_LOCK_FREE is 1,
+ *            the block must be one that ch9120_pool_alloc returned, a pointer out of the pool,
+ *            into the middle of a block or a free with no block allocated is refused,
+ *            other double frees corrupt the free list unless CH9120_POOL_DEBUG is 1,
+ *            which walks the free list on every free and needs CH9120_POOL_LOCK_FREE 0
  */
-uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable)
+uint8_t ch9120_pool_free(ch9120_handle_t *handle, uint8_t *block)
 {
-    uint8_t cmd[2];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1359,11 +4447,10 @@ uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable)
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_FLUSH;                                   /* set flush */
-    cmd[1] = enable;                                                 /* set bool */
-    if (a_ch9120_write_check(handle, cmd, 2,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write flush */
+    if (a_ch9120_pool_push(handle, block) != 0)                      /* push the block */
     {
+        CH9120_DEBUG_PRINT(handle, "ch9120: block is invalid.\n");   /* block is invalid */
+        
         return 1;                                                    /* return error */
     }
     
@@ -1371,55 +4458,60 @@ uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable)
 }
 
 /**
- * @brief      get uart auto flush status
+ * @brief      get the pool stats
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *stats pointer to a pool stats structure
  * @return     status code
  *             - 0 success
- *             - 1 get uart flush failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t ch9120_get_uart_flush(ch9120_handle_t *handle, ch9120_bool_t *enable)
+uint8_t ch9120_get_pool_stats(ch9120_handle_t *handle, ch9120_pool_stats_t *stats)
 {
-    uint8_t cmd;
-    uint8_t param;
-    
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_FLUSH;                                       /* get uart flush */
-    if (a_ch9120_write_read(handle, &cmd, 1, &param, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get uart flush */
-    {
-        return 1;                                                     /* return error */
-    }
-    *enable = (ch9120_bool_t)(param);                                 /* set bool */
+    stats->block_size = handle->pool_block;                          /* get block size */
+    stats->block_num = handle->pool_num;                             /* get block number */
+#if (CH9120_POOL_LOCK_FREE == 1)
+    stats->used = __atomic_load_n(&handle->pool_used, __ATOMIC_RELAXED);         /* get used */
+    stats->peak = __atomic_load_n(&handle->pool_peak, __ATOMIC_RELAXED);         /* get peak */
+    stats->allocs = __atomic_load_n(&handle->pool_allocs, __ATOMIC_RELAXED);     /* get allocs */
+    stats->fails = __atomic_load_n(&handle->pool_fails, __ATOMIC_RELAXED);       /* get fails */
+#else
+    stats->used = handle->pool_used;                                 /* get used */
+    stats->peak = handle->pool_peak;                                 /* get peak */
+    stats->allocs = handle->pool_allocs;                             /* get allocs */
+    stats->fails = handle->pool_fails;                               /* get fails */
+#endif
     
-    return 0;                                                         /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
+#endif
 
 /**
- * @brief     enable or disable disconnect with no rj45
- * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] enable bool value
- * @return    status code
- *            - 0 success
- *            - 1 set disconnect with no rj45 failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief         read data
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ * @note          none
  */
-uint8_t ch9120_set_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t enable)
+uint8_t ch9120_read(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len)
 {
-    uint8_t cmd[2];
+    uint16_t l;
+    ch9120_trace_t trace;
     
     if (handle == NULL)                                              /* check handle */
     {
@@ -1430,68 +4522,125 @@ uint8_t ch9120_set_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_
         return 3;                                                    /* return error */
     }
     
-    cmd[0] = CH9120_CMD_SET_DISCONNECT;                              /* set disconnect */
-    cmd[1] = enable;                                                 /* set bool */
-    if (a_ch9120_write_check(handle, cmd, 2,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* write disconnect */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    if (a_ch9120_async_busy(handle) != 0)                            /* check async command */
+    {
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
+        return 1;                                                    /* return error */
+    }
+    a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_READ,
+                         0, 0, *len);                                /* trace begin */
+    if (handle->cfg_gpio_write(1) != 0)                              /* cfg gpio write */
     {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio write failed.\n");     /* cfg gpio write failed */
+        a_ch9120_trace_end(handle, &trace, 0, 1);                    /* trace end */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
         return 1;                                                    /* return error */
     }
+    l = handle->uart_read(buf, *len);                                /* uart read */
+    *len = l;                                                        /* set data */
+    if ((l != 0) && (handle->timestamp_us != NULL))                  /* check timestamp_us */
+    {
+        handle->io_last_us = handle->timestamp_us();                 /* mark the data path busy */
+    }
+    a_ch9120_trace_end(handle, &trace, l, 0);                        /* trace end */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get disconnect with no rj45 status
+ * @brief      peek the received data in place
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[out] *enable pointer to a bool value buffer
+ * @param[out] *view pointer to a view structure
  * @return     status code
  *             - 0 success
- *             - 1 get disconnect with no rj45 failed
+ *             - 1 read peek failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ *             - 4 uart_peek or uart_consume is not linked
+ * @note       the view points into the interface receive buffer and stays valid until ch9120_read_consume,
+ *             only the reading thread may use it
  */
-uint8_t ch9120_get_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t *enable)
+uint8_t ch9120_read_peek(ch9120_handle_t *handle, ch9120_view_t *view)
 {
-    uint8_t cmd;
-    uint8_t param;
+    uint16_t l;
+    ch9120_trace_t trace;
     
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
+    }
+    if ((handle->uart_peek == NULL) || (handle->uart_consume == NULL))    /* check the hooks */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_peek or uart_consume is null.\n");    /* hooks are null */
+        
+        return 4;                                                    /* return error */
     }
     
-    cmd = CH9120_CMD_GET_DISCONNECT;                                  /* get disconnect */
-    if (a_ch9120_write_read(handle, &cmd, 1, &param, 1,
-                            CH9120_UART_PRE_DELAY, 1000) != 0)        /* get disconnect */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    if (a_ch9120_async_busy(handle) != 0)                            /* check async command */
     {
-        return 1;                                                     /* return error */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
+        return 1;                                                    /* return error */
+    }
+    a_ch9120_trace_begin(handle, &trace, CH9120_TRACE_TYPE_READ,
+                         0, 0, 0);                                   /* trace begin */
+    if (handle->cfg_gpio_write(1) != 0)                              /* cfg gpio write */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: cfg gpio write failed.\n");     /* cfg gpio write failed */
+        a_ch9120_trace_end(handle, &trace, 0, 1);                    /* trace end */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
+        return 1;                                                    /* return error */
+    }
+    view->buf[0] = NULL;                                             /* init segment 0 */
+    view->buf[1] = NULL;                                             /* init segment 1 */
+    view->len[0] = 0;                                                /* init length 0 */
+    view->len[1] = 0;                                                /* init length 1 */
+    if (handle->uart_peek(view) != 0)                                /* uart peek */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart peek failed.\n");   /* uart peek failed */
+        handle->peek_len = 0;                                        /* nothing lent */
+        a_ch9120_trace_end(handle, &trace, 0, 1);                    /* trace end */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
+        return 1;                                                    /* return error */
+    }
+    l = view->len[0] + view->len[1];                                 /* total length */
+    handle->peek_len = l;                                            /* save the lent length */
+    if ((l != 0) && (handle->timestamp_us != NULL))                  /* check timestamp_us */
+    {
+        handle->io_last_us = handle->timestamp_us();                 /* mark the data path busy */
     }
-    *enable = (ch9120_bool_t)(param);                                 /* set bool */
+    a_ch9120_trace_end(handle, &trace, l, 0);                        /* trace end */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
     
-    return 0;                                                         /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     enable or disable dhcp
+ * @brief     release the peeked data
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] enable bool value
+ * @param[in] len consumed length
  * @return    status code
  *            - 0 success
- *            - 1 set dhcp failed
+ *            - 1 read consume failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 uart_peek or uart_consume is not linked
+ *            - 5 len is over the peeked length
+ * @note      the rest of the peeked data stays in the receive buffer
  */
-uint8_t ch9120_set_dhcp(ch9120_handle_t *handle, ch9120_bool_t enable)
+uint8_t ch9120_read_consume(ch9120_handle_t *handle, uint16_t len)
 {
-    uint8_t cmd[2];
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1500,229 +4649,400 @@ uint8_t ch9120_set_dhcp(ch9120_handle_t *handle, ch9120_bool_t enable)
     {
         return 3;                                                    /* return error */
     }
+    if ((handle->uart_peek == NULL) || (handle->uart_consume == NULL))    /* check the hooks */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart_peek or uart_consume is null.\n");    /* hooks are null */
+        
+        return 4;                                                    /* return error */
+    }
     
-    cmd[0] = CH9120_CMD_DHCP;                                        /* set dhcp */
-    cmd[1] = enable;                                                 /* set bool */
-    if (a_ch9120_write_check(handle, cmd, 2,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)      /* dhcp */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    if (len > handle->peek_len)                                      /* check length */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: len is over the peeked length.\n");    /* len is over the peeked length */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
+        return 5;                                                    /* return error */
+    }
+    if (handle->uart_consume(len) != 0)                              /* uart consume */
     {
+        CH9120_DEBUG_PRINT(handle, "ch9120: uart consume failed.\n");       /* uart consume failed */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        
         return 1;                                                    /* return error */
     }
+    handle->peek_len = 0;                                            /* the view is released */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
     
     return 0;                                                        /* success return 0 */
 }
 
+#if (CH9120_ENABLE_SET_COMMAND == 1)
 /**
- * @brief     initialize the chip
- * @param[in] *handle pointer to a ch9120 handle structure
- * @return    status code
- *            - 0 success
- *            - 1 uart initialization failed
- *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 reset gpio init failed
- *            - 5 cfg gpio init failed
- *            - 6 reset failed
- * @note      none
+ * @brief      set command
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  *param pointer to a param buffer
+ * @param[in]  len param length
+ * @param[out] *out pointer to an out buffer
+ * @param[in]  out_len output length
+ * @param[in]  pre_delay delay in ms
+ * @param[in]  timeout timeout in ms
+ * @return     status code
+ *             - 0 success
+ *             - 1 set command failed
+ *             - 2 handle is NULL
+ *             - 3 linked functions is NULL
+ * @note       none
  */
-uint8_t ch9120_init(ch9120_handle_t *handle)
+uint8_t ch9120_set_command(ch9120_handle_t *handle,
+                           uint8_t *param, uint16_t len,
+                           uint8_t *out, uint16_t out_len,
+                           uint16_t pre_delay, uint16_t timeout)
 {
-    if (handle == NULL)                                                /* check handle */
-    {
-        return 2;                                                      /* return error */
-    }
-    if (handle->debug_print == NULL)                                   /* check debug_print */
+    if (handle == NULL)                                      /* check handle */
     {
-        return 3;                                                      /* return error */
+        return 2;                                            /* return error */
     }
-    if (handle->uart_init == NULL)                                     /* check uart_init */
+    if (handle->inited != 1)                                 /* check handle initialization */
     {
-        handle->debug_print("ch9120: uart_init is null.\n");           /* uart_init is null */
-        
-        return 3;                                                      /* return error */
+        return 3;                                            /* return error */
     }
-    if (handle->uart_deinit == NULL)                                   /* check uart_deinit */
+    
+    if (a_ch9120_write_read(handle, param, len,
+                            out, out_len,
+                            pre_delay, timeout) != 0)        /* set command */
     {
-        handle->debug_print("ch9120: uart_deinit is null.\n");         /* uart_deinit is null */
-        
-        return 3;                                                      /* return error */
+        return 1;                                            /* return error */
     }
-    if (handle->uart_read == NULL)                                     /* check uart_read */
+    
+    return 0;                                                /* success return 0 */
+}
+#endif
+
+/**
+ * @brief      run a command from the command table
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 exec failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 id is invalid
+ *             - 5 in or out is NULL
+ * @note       in and out hold the payload and the response in the wire order,
+ *             multi-byte values are little endian, ch9120_async_exec and the command
+ *             wrappers return the same codes, 6 and 7 only come from ch9120_async_exec
+ */
+uint8_t ch9120_exec(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out)
+{
+    if (handle == NULL)                                              /* check handle */
     {
-        handle->debug_print("ch9120: uart_read is null.\n");           /* uart_read is null */
-        
-        return 3;                                                      /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->uart_write == NULL)                                    /* check uart_write */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        handle->debug_print("ch9120: uart_write is null.\n");          /* uart_write is null */
-        
-        return 3;                                                      /* return error */
-    } 
-    if (handle->uart_flush == NULL)                                    /* check uart_flush */
+        return 3;                                                    /* return error */
+    }
+    if (id >= CH9120_COMMAND_NUM)                                    /* check id */
     {
-        handle->debug_print("ch9120: uart_flush is null.\n");          /* uart_flush is null */
+        CH9120_DEBUG_PRINT(handle, "ch9120: id is invalid.\n");      /* id is invalid */
         
-        return 3;                                                      /* return error */
+        return 4;                                                    /* return error */
     }
-    if (handle->delay_ms == NULL)                                      /* check delay_ms */
+    if (((in == NULL) && (gs_exec_table[id].in_len != 0)) ||
+        ((out == NULL) && (gs_exec_table[id].out_len != 0)))         /* check buffer */
     {
-        handle->debug_print("ch9120: delay_ms is null.\n");            /* delay_ms is null */
+        CH9120_DEBUG_PRINT(handle, "ch9120: in or out is NULL.\n");  /* in or out is NULL */
         
-        return 3;                                                      /* return error */
+        return 5;                                                    /* return error */
     }
-    if (handle->reset_gpio_init == NULL)                               /* check reset_gpio_init */
+    
+    return a_ch9120_exec(handle, id, in, out);                       /* run the command */
+}
+
+#if (CH9120_ENABLE_ASYNC == 1)
+/**
+ * @brief     finish the async command
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] status async status
+ * @param[in] code trace status code
+ * @note      the caller runs the async_callback after the locks are released
+ */
+static void a_ch9120_async_finish(ch9120_handle_t *handle, ch9120_async_status_t status, uint8_t code)
+{
+    handle->cfg_gpio_write(1);                                       /* set high */
+    a_ch9120_trace_end(handle, &handle->async_trace, 
+                       handle->async_point, code);                   /* trace end */
+    handle->async_state = CH9120_ASYNC_IDLE;                         /* set idle */
+    handle->async_status = (uint8_t)status;                          /* set status */
+}
+
+/**
+ * @brief     poll the async command without locks
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] now_ms current time in ms
+ * @return    1 if the command completed, else 0
+ * @note      none
+ */
+static uint8_t a_ch9120_poll_unlocked(ch9120_handle_t *handle, uint32_t now_ms)
+{
+    uint8_t res;
+    uint16_t l;
+    uint8_t *param;
+    
+    if (handle->async_state == CH9120_ASYNC_IDLE)                    /* check state */
     {
-        handle->debug_print("ch9120: reset_gpio_init is null.\n");     /* reset_gpio_init is null */
-        
-        return 3;                                                      /* return error */
+        return 0;                                                    /* nothing to do */
     }
-    if (handle->reset_gpio_deinit == NULL)                             /* check reset_gpio_deinit */
+    if (handle->async_state == CH9120_ASYNC_WRITTEN)                 /* first poll */
     {
-        handle->debug_print("ch9120: reset_gpio_deinit is null.\n");   /* reset_gpio_deinit is null */
-        
-        return 3;                                                      /* return error */
+        handle->async_ready_ms = now_ms + handle->async_pre_delay;   /* set read start */
+        handle->async_deadline_ms = handle->async_ready_ms + 
+                                    handle->async_timeout;           /* set deadline */
+        handle->async_state = CH9120_ASYNC_READING;                  /* wait for the answer */
     }
-    if (handle->reset_gpio_write == NULL)                              /* check reset_gpio_write */
+    if ((int32_t)(now_ms - handle->async_ready_ms) < 0)              /* check pre delay */
     {
-        handle->debug_print("ch9120: reset_gpio_write is null.\n");    /* reset_gpio_write is null */
-        
-        return 3;                                                      /* return error */
+        return 0;                                                    /* pending */
     }
-    if (handle->cfg_gpio_init == NULL)                                 /* check cfg_gpio_init */
+    
+    param = handle->async_param;                                     /* get param */
+    if (handle->async_out_len == 0)                                  /* write check */
     {
-        handle->debug_print("ch9120: cfg_gpio_init is null.\n");       /* cfg_gpio_init is null */
-        
-        return 3;                                                      /* return error */
+        if (handle->uart_read(&res, 1) == 1)                         /* read data */
+        {
+            handle->async_point = 1;                                 /* set received */
+            if (res == 0xAA)                                         /* check 0xAA */
+            {
+                a_ch9120_track(handle, param, handle->async_len, 1); /* track the command */
+                a_ch9120_async_finish(handle, CH9120_ASYNC_STATUS_OK, 0);       /* ok */
+            }
+            else
+            {
+                CH9120_DEBUG_PRINT(handle, "ch9120: error.\n");      /* error */
+                a_ch9120_async_finish(handle, CH9120_ASYNC_STATUS_ERROR, 3);    /* error */
+            }
+            
+            return 1;                                                /* done */
+        }
     }
-    if (handle->cfg_gpio_deinit == NULL)                               /* check cfg_gpio_deinit */
+    else
     {
-        handle->debug_print("ch9120: cfg_gpio_deinit is null.\n");     /* cfg_gpio_deinit is null */
-        
-        return 3;                                                      /* return error */
+        l = handle->uart_read(&handle->async_out[handle->async_point], 
+                              handle->async_out_len - handle->async_point);     /* read data */
+        handle->async_point += l;                                    /* point += l */
+        if (handle->async_point >= handle->async_out_len)            /* check length */
+        {
+            if ((handle->async_len == 1) && 
+                (param[0] >= CH9120_CMD_GET_MODE))                   /* check getter */
+            {
+                a_ch9120_readback(handle, param[0], handle->async_out, 
+                                  handle->async_out_len);            /* cache readback */
+            }
+            else
+            {
+                a_ch9120_track(handle, param, handle->async_len, 0); /* raw command */
+            }
+            a_ch9120_async_finish(handle, CH9120_ASYNC_STATUS_OK, 0);           /* ok */
+            
+            return 1;                                                /* done */
+        }
     }
-    if (handle->cfg_gpio_write == NULL)                                /* check cfg_gpio_write */
+    if ((int32_t)(now_ms - handle->async_deadline_ms) >= 0)          /* check deadline */
     {
-        handle->debug_print("ch9120: cfg_gpio_write is null.\n");      /* cfg_gpio_write is null */
+        CH9120_DEBUG_PRINT(handle, "ch9120: timeout.\n");            /* timeout */
+        a_ch9120_async_finish(handle, CH9120_ASYNC_STATUS_TIMEOUT, 
+                              (handle->async_out_len == 0) ? 4 : 3); /* timeout */
         
-        return 3;                                                      /* return error */
+        return 1;                                                    /* done */
     }
     
-    if (handle->uart_init() != 0)                                      /* uart init */
+    return 0;                                                        /* pending */
+}
+
+/**
+ * @brief      start an async command
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  *param pointer to a param buffer
+ * @param[in]  len param length
+ * @param[out] *out pointer to an out buffer, NULL expects the 0xAA answer
+ * @param[in]  out_len output length, 0 expects the 0xAA answer
+ * @param[in]  pre_delay delay in ms
+ * @param[in]  timeout timeout in ms
+ * @param[out] *token pointer to a token buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 write failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 command is busy
+ *             - 5 len is invalid
+ * @note       only the command is written, ch9120_poll waits for the answer,
+ *             other commands and the data path are refused until it completes
+ */
+uint8_t ch9120_async_command(ch9120_handle_t *handle,
+                             uint8_t *param, uint16_t len,
+                             uint8_t *out, uint16_t out_len,
+                             uint16_t pre_delay, uint16_t timeout,
+                             uint16_t *token)
+{
+    if (handle == NULL)                                              /* check handle */
     {
-        handle->debug_print("ch9120: uart init failed.\n");            /* uart init failed */
-        
-        return 1;                                                      /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->reset_gpio_init() != 0)                                /* reset gpio init */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        handle->debug_print("ch9120: reset gpio init failed.\n");      /* reset gpio init failed */
-        (void)handle->uart_deinit();                                   /* uart deinit */
-        
-        return 4;                                                      /* return error */
+        return 3;                                                    /* return error */
     }
-    if (handle->cfg_gpio_init() != 0)                                  /* cfg gpio init */
+    if ((out == NULL) && (out_len != 0))                             /* check length */
     {
-        handle->debug_print("ch9120: cfg gpio init failed.\n");        /* cfg gpio init failed */
-        (void)handle->uart_deinit();                                   /* uart deinit */
-        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
+        CH9120_DEBUG_PRINT(handle, "ch9120: len is invalid.\n");     /* len is invalid */
         
-        return 5;                                                      /* return error */
+        return 5;                                                    /* return error */
     }
-    if (handle->reset_gpio_write(0) != 0)                              /* set low */
+    
+    a_ch9120_lock(handle, CH9120_LOCK_CFG);                          /* lock cfg */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    if (handle->async_state != CH9120_ASYNC_IDLE)                    /* check state */
     {
-        handle->debug_print("ch9120: cfg gpio write failed.\n");       /* cfg gpio write failed */
-        (void)handle->uart_deinit();                                   /* uart deinit */
-        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
-        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
+        CH9120_DEBUG_PRINT(handle, "ch9120: command is busy.\n");    /* command is busy */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        a_ch9120_unlock(handle, CH9120_LOCK_CFG);                    /* unlock cfg */
         
-        return 6;                                                      /* return error */
+        return 4;                                                    /* return error */
+    }
+    handle->async_token++;                                           /* next token */
+    if (handle->async_token == 0)                                    /* check wrap */
+    {
+        handle->async_token = 1;                                     /* 0 is never a token */
+    }
+    handle->async_len = len;                                         /* set length */
+    handle->async_out = out;                                         /* set out */
+    handle->async_out_len = out_len;                                 /* set out length */
+    handle->async_pre_delay = pre_delay;                             /* set pre delay */
+    handle->async_timeout = timeout;                                 /* set timeout */
+    handle->async_point = 0;                                         /* init 0 */
+    a_ch9120_trace_begin(handle, &handle->async_trace, 
+                         (out_len == 0) ? CH9120_TRACE_TYPE_WRITE_CHECK : CH9120_TRACE_TYPE_WRITE_READ,
+                         (len != 0) ? param[0] : 0, 2 + len, 
+                         (out_len == 0) ? 1 : out_len);              /* trace begin */
+    memcpy(handle->async_param, param, 
+           (len < sizeof(handle->async_param)) ? len : sizeof(handle->async_param));    /* keep the head for tracking */
+    handle->cfg_gpio_write(0);                                       /* set low */
+    handle->uart_flush();                                            /* uart flush */
+    if (a_ch9120_write_command(handle, param, len) != 0)             /* write command */
+    {
+        CH9120_DEBUG_PRINT(handle, "ch9120: write failed.\n");       /* write failed */
+        handle->cfg_gpio_write(1);                                   /* set high */
+        a_ch9120_trace_end(handle, &handle->async_trace, 0, 1);      /* trace end */
+        handle->async_status = (uint8_t)CH9120_ASYNC_STATUS_ERROR;   /* set error */
+        a_ch9120_unlock(handle, CH9120_LOCK_IO);                     /* unlock io */
+        a_ch9120_unlock(handle, CH9120_LOCK_CFG);                    /* unlock cfg */
+        
+        return 1;                                                    /* return error */
     }
-    handle->delay_ms(10);                                              /* delay 10ms */
-    if (handle->reset_gpio_write(1) != 0)                              /* set high */
+    handle->async_status = (uint8_t)CH9120_ASYNC_STATUS_BUSY;        /* set busy */
+    handle->async_state = CH9120_ASYNC_WRITTEN;                      /* wait for the first poll */
+    if (token != NULL)                                               /* check token */
     {
-        handle->debug_print("ch9120: cfg gpio write failed.\n");       /* cfg gpio write failed */
-        (void)handle->uart_deinit();                                   /* uart deinit */
-        (void)handle->reset_gpio_deinit();                             /* reset gpio deinit */
-        (void)handle->cfg_gpio_deinit();                               /* cfg gpio deinit */
-        
-        return 6;                                                      /* return error */
+        *token = handle->async_token;                                /* set token */
     }
-    handle->delay_ms(500);                                             /* delay 500ms */
-    handle->inited = 1;                                                /* flag finish initialization */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
+    a_ch9120_unlock(handle, CH9120_LOCK_CFG);                        /* unlock cfg */
     
-    return 0;                                                          /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief     close the chip
- * @param[in] *handle pointer to a ch9120 handle structure
- * @return    status code
- *            - 0 success
- *            - 1 uart deinit failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- *            - 4 reset failed
- *            - 5 reset gpio deinit failed
- *            - 6 cfg gpio deinit failed
- * @note      none
+ * @brief      start an async command from the command table
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
+ * @param[out] *token pointer to a token buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 write failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 id is invalid
+ *             - 5 in or out is NULL
+ *             - 6 id reboots the chip
+ *             - 7 command is busy
+ * @note       in and out are in the wire order like ch9120_exec, reset and config and reset
+ *             wait until the chip boots and only run with ch9120_exec,
+ *             the codes are the ones of ch9120_exec
  */
-uint8_t ch9120_deinit(ch9120_handle_t *handle)
+uint8_t ch9120_async_exec(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out, uint16_t *token)
 {
-    uint8_t cmd;
+    uint8_t res;
+    uint8_t cmd[5];
+    const ch9120_exec_desc_t *desc;
     
-    if (handle == NULL)                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                          /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                                     /* return error */
+        return 3;                                                    /* return error */
     }
-    
-    cmd = CH9120_CMD_RESET;                                           /* set reset */
-    if (a_ch9120_write_check(handle, &cmd, 1,
-                             CH9120_UART_PRE_DELAY, 1000) != 0)       /* reset */
+    if (id >= CH9120_COMMAND_NUM)                                    /* check id */
     {
-        return 4;                                                     /* return error */
+        CH9120_DEBUG_PRINT(handle, "ch9120: id is invalid.\n");      /* id is invalid */
+        
+        return 4;                                                    /* return error */
     }
-    handle->delay_ms(10);                                             /* delay 10ms */
-    if (handle->uart_deinit() != 0)                                   /* uart deinit */
+    desc = &gs_exec_table[id];                                       /* get the descriptor */
+    if (((in == NULL) && (desc->in_len != 0)) ||
+        ((out == NULL) && (desc->out_len != 0)))                     /* check buffer */
     {
-        handle->debug_print("ch9120: uart deinit failed.\n");         /* uart deinit failed */
+        CH9120_DEBUG_PRINT(handle, "ch9120: in or out is NULL.\n");  /* in or out is NULL */
         
-        return 1;                                                     /* return error */
+        return 5;                                                    /* return error */
     }
-    if (handle->reset_gpio_deinit() != 0)                             /* reset gpio deinit */
+    if ((desc->flag & CH9120_EXEC_FLAG_BOOT) != 0)                   /* check boot */
     {
-        handle->debug_print("ch9120: reset gpio deinit failed.\n");   /* reset gpio deinit failed */
+        CH9120_DEBUG_PRINT(handle, "ch9120: id reboots the chip.\n"); /* id reboots the chip */
         
-        return 5;                                                     /* return error */
+        return 6;                                                    /* return error */
     }
-    if (handle->cfg_gpio_deinit() != 0)                               /* cfg gpio deinit */
+    
+    cmd[0] = desc->cmd;                                              /* set command */
+    if (desc->in_len != 0)                                           /* check payload */
     {
-        handle->debug_print("ch9120: cfg gpio deinit failed.\n");     /* cfg gpio deinit failed */
-        
-        return 6;                                                     /* return error */
+        memcpy(&cmd[1], in, desc->in_len);                           /* set payload */
     }
     
-    return 0;                                                         /* success return 0 */
+    res = ch9120_async_command(handle, cmd, 1 + desc->in_len, out, desc->out_len,
+                               CH9120_UART_PRE_DELAY, CH9120_EXEC_TIMEOUT, token);    /* start the command */
+    if (res == 4)                                                    /* check busy */
+    {
+        return 7;                                                    /* command is busy */
+    }
+    
+    return res;                                                      /* return the result */
 }
 
 /**
- * @brief     write data
+ * @brief     poll the async command
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len data length
+ * @param[in] now_ms current time in ms
  * @return    status code
  *            - 0 success
- *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      call it from the main loop, it never delays, the async_callback runs on completion
  */
-uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
+uint8_t ch9120_poll(ch9120_handle_t *handle, uint32_t now_ms)
 {
+    uint8_t done;
+    uint16_t token;
+    ch9120_async_status_t status;
+    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1732,38 +5052,35 @@ uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len)
         return 3;                                                    /* return error */
     }
     
-    if (handle->cfg_gpio_write(1) != 0)                              /* cfg gpio write */
+    a_ch9120_lock(handle, CH9120_LOCK_CFG);                          /* lock cfg */
+    a_ch9120_lock(handle, CH9120_LOCK_IO);                           /* lock io */
+    done = a_ch9120_poll_unlocked(handle, now_ms);                   /* poll */
+    token = handle->async_token;                                     /* get token */
+    status = (ch9120_async_status_t)(handle->async_status);          /* get status */
+    a_ch9120_unlock(handle, CH9120_LOCK_IO);                         /* unlock io */
+    a_ch9120_unlock(handle, CH9120_LOCK_CFG);                        /* unlock cfg */
+    if ((done != 0) && (handle->async_callback != NULL))             /* check async_callback */
     {
-        handle->debug_print("ch9120: cfg gpio write failed.\n");     /* cfg gpio write failed */
-        
-        return 1;                                                    /* return error */
-    }
-    if (handle->uart_write(buf, len) != 0)                           /* uart write */
-    {
-        handle->debug_print("ch9120:uart write failed.\n");          /* uart write failed */
-        
-        return 1;                                                    /* return error */
+        handle->async_callback(token, status);                       /* run the callback */
     }
     
     return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief         read data
- * @param[in]     *handle pointer to a ch9120 handle structure
- * @param[out]    *buf pointer to a data buffer
- * @param[in,out] *len pointer to a length buffer
- * @return        status code
- *                - 0 success
- *                - 1 read failed
- *                - 2 handle is NULL
- *                - 3 handle is not initialized
- * @note          none
+ * @brief      get the async command status
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  token command token
+ * @param[out] *status pointer to an async status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 token is unknown
+ * @note       only the last command is kept
  */
-uint8_t ch9120_read(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len)
+uint8_t ch9120_async_get_status(ch9120_handle_t *handle, uint16_t token, ch9120_async_status_t *status)
 {
-    uint16_t l;
-    
     if (handle == NULL)                                              /* check handle */
     {
         return 2;                                                    /* return error */
@@ -1772,59 +5089,59 @@ uint8_t ch9120_read(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len)
     {
         return 3;                                                    /* return error */
     }
-    
-    if (handle->cfg_gpio_write(1) != 0)                              /* cfg gpio write */
+    if ((token == 0) || (token != handle->async_token))              /* check token */
     {
-        handle->debug_print("ch9120: cfg gpio write failed.\n");     /* cfg gpio write failed */
-        
-        return 1;                                                    /* return error */
+        return 4;                                                    /* return error */
     }
-    l = handle->uart_read(buf, *len);                                /* uart read */
-    *len = l;                                                        /* set data */
+    
+    *status = (ch9120_async_status_t)(handle->async_status);         /* get status */
     
     return 0;                                                        /* success return 0 */
 }
+#endif
 
+#if (CH9120_ENABLE_LOCK_STATS == 1)
 /**
- * @brief      set command
+ * @brief      get the lock stats
  * @param[in]  *handle pointer to a ch9120 handle structure
- * @param[in]  *param pointer to a param buffer
- * @param[in]  len param length
- * @param[out] *out pointer to an out buffer
- * @param[in]  out_len output length
- * @param[in]  pre_delay delay in ms
- * @param[in]  timeout timeout in ms
+ * @param[in]  lock lock
+ * @param[out] *stats pointer to a lock stats structure
  * @return     status code
  *             - 0 success
- *             - 1 set command failed
  *             - 2 handle is NULL
- *             - 3 linked functions is NULL
- * @note       none
+ *             - 3 handle is not initialized
+ * @note       the copy is taken under the lock and is not counted
  */
-uint8_t ch9120_set_command(ch9120_handle_t *handle,
-                           uint8_t *param, uint16_t len,
-                           uint8_t *out, uint16_t out_len,
-                           uint16_t pre_delay, uint16_t timeout)
+uint8_t ch9120_get_lock_stats(ch9120_handle_t *handle, ch9120_lock_t lock, ch9120_lock_stats_t *stats)
 {
-    if (handle == NULL)                                      /* check handle */
+    uint8_t id;
+    
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                            /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                 /* check handle initialization */
+    if (handle->inited != 1)                                         /* check handle initialization */
     {
-        return 3;                                            /* return error */
+        return 3;                                                    /* return error */
     }
     
-    if (a_ch9120_write_read(handle, param, len,
-                            out, out_len,
-                            pre_delay, timeout) != 0)        /* set command */
+    id = (lock == CH9120_LOCK_CFG) ? CH9120_LOCK_CFG : CH9120_LOCK_IO;   /* get id */
+    if ((handle->mutex_lock != NULL) && (handle->mutex_unlock != NULL))  /* check the hooks */
     {
-        return 1;                                            /* return error */
+        (void)handle->mutex_lock(handle->mutex_ctx, id, 1);          /* lock */
+        *stats = handle->lock_stats[id];                             /* copy stats */
+        handle->mutex_unlock(handle->mutex_ctx, id);                 /* unlock */
+    }
+    else
+    {
+        *stats = handle->lock_stats[id];                             /* copy stats */
     }
     
-    return 0;                                                /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
+#endif
 
+#if (CH9120_ENABLE_INFO == 1)
 /**
  * @brief      get chip's information
  * @param[out] *info pointer to a ch9120 info structure
@@ -1853,3 +5170,4 @@ uint8_t ch9120_info(ch9120_info_t *info)
     
     return 0;                                                      /* success return 0 */
 }
+#endif
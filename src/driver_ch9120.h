@@ -63,6 +63,97 @@ extern "C"{
     #define CH9120_UART_PRE_DELAY    50        /**< 50ms */
 #endif
 
+/**
+ * @brief ch9120 boot probe definition
+ */
+#ifndef CH9120_BOOT_MIN_DELAY
+    #define CH9120_BOOT_MIN_DELAY        10        /**< 10ms */
+#endif
+#ifndef CH9120_BOOT_PROBE_TIMEOUT
+    #define CH9120_BOOT_PROBE_TIMEOUT    10        /**< 10ms */
+#endif
+
+/**
+ * @brief ch9120 link monitor definition
+ */
+#ifndef CH9120_MONITOR_FAST_MS
+    #define CH9120_MONITOR_FAST_MS         200         /**< 200ms after a change */
+#endif
+#ifndef CH9120_MONITOR_SLOW_MS
+    #define CH9120_MONITOR_SLOW_MS         5000        /**< 5000ms while stable */
+#endif
+#ifndef CH9120_MONITOR_IDLE_MS
+    #define CH9120_MONITOR_IDLE_MS         20          /**< 20ms data idle gap */
+#endif
+#ifndef CH9120_MONITOR_MAX_DEFER_MS
+    #define CH9120_MONITOR_MAX_DEFER_MS    1000        /**< 1000ms max wait for a gap */
+#endif
+
+/**
+ * @brief ch9120 uart auto tune definition
+ */
+#ifndef CH9120_AUTOTUNE_MAX_LEN
+    #define CH9120_AUTOTUNE_MAX_LEN        1024        /**< largest tuned uart buffer length */
+#endif
+#ifndef CH9120_AUTOTUNE_MIN_LEN
+    #define CH9120_AUTOTUNE_MIN_LEN        64          /**< smallest tuned uart buffer length */
+#endif
+
+/**
+ * @brief ch9120 pool definition
+ */
+#ifndef CH9120_POOL_LOCK_FREE
+    #define CH9120_POOL_LOCK_FREE          0           /**< 1 keeps the free list with the gcc atomic builtins */
+#endif
+#ifndef CH9120_POOL_DEBUG
+    #define CH9120_POOL_DEBUG              0           /**< 1 walks the free list on every free to catch a double free */
+#endif
+#if (CH9120_POOL_LOCK_FREE == 1) && (CH9120_POOL_DEBUG == 1)
+    #error "CH9120_POOL_DEBUG walks the free list without a lock, it can not run with CH9120_POOL_LOCK_FREE"
+#endif
+
+/**
+ * @brief ch9120 feature definition
+ * @note  set one to 0 to compile the feature out, the tests in test need all of them,
+ *        the client example needs CH9120_ENABLE_MONITOR
+ */
+#ifndef CH9120_ENABLE_GETTERS
+    #define CH9120_ENABLE_GETTERS          1           /**< 1 keeps the parameter read back functions */
+#endif
+#ifndef CH9120_ENABLE_DEBUG_PRINT
+    #define CH9120_ENABLE_DEBUG_PRINT      1           /**< 1 keeps the debug strings */
+#endif
+#ifndef CH9120_ENABLE_DHCP
+    #define CH9120_ENABLE_DHCP             1           /**< 1 keeps ch9120_set_dhcp */
+#endif
+#ifndef CH9120_ENABLE_INFO
+    #define CH9120_ENABLE_INFO             1           /**< 1 keeps ch9120_info */
+#endif
+#ifndef CH9120_ENABLE_SET_COMMAND
+    #define CH9120_ENABLE_SET_COMMAND      1           /**< 1 keeps ch9120_set_command */
+#endif
+#ifndef CH9120_ENABLE_MONITOR
+    #define CH9120_ENABLE_MONITOR          1           /**< 1 keeps the link monitor */
+#endif
+#ifndef CH9120_ENABLE_COALESCE
+    #define CH9120_ENABLE_COALESCE         1           /**< 1 keeps the write coalescer */
+#endif
+#ifndef CH9120_ENABLE_AUTOTUNE
+    #define CH9120_ENABLE_AUTOTUNE         1           /**< 1 keeps the uart auto tune */
+#endif
+#ifndef CH9120_ENABLE_FRAME
+    #define CH9120_ENABLE_FRAME            1           /**< 1 keeps the frame codec and its compression */
+#endif
+#ifndef CH9120_ENABLE_POOL
+    #define CH9120_ENABLE_POOL             1           /**< 1 keeps the block pool */
+#endif
+#ifndef CH9120_ENABLE_ASYNC
+    #define CH9120_ENABLE_ASYNC            1           /**< 1 keeps the async commands */
+#endif
+#ifndef CH9120_ENABLE_LOCK_STATS
+    #define CH9120_ENABLE_LOCK_STATS       1           /**< 1 keeps the lock stats */
+#endif
+
 /**
  * @brief ch9120 bool enumeration definition
  */
@@ -104,16 +195,214 @@ typedef enum
     CH9120_PARITY_NONE  = 0x04,        /**< none */
 } ch9120_parity_t;
 
+/**
+ * @brief ch9120 apply enumeration definition
+ * @note  the chip has no runtime or save only apply, a parameter only runs after a config and reset
+ */
+typedef enum
+{
+    CH9120_APPLY_NONE              = 0x00,        /**< nothing to apply */
+    CH9120_APPLY_PERSIST_AND_RESET = 0x01,        /**< save to eeprom and reset */
+    CH9120_APPLY_AUTO              = 0xFF,        /**< reset only if a parameter changed */
+} ch9120_apply_t;
+
+/**
+ * @brief ch9120 frame enumeration definition
+ */
+typedef enum
+{
+    CH9120_FRAME_SLIP = 0x00,        /**< slip, 0xC0 delimiter */
+    CH9120_FRAME_COBS = 0x01,        /**< cobs, 0x00 delimiter */
+} ch9120_frame_t;
+
+/**
+ * @brief ch9120 frame crc enumeration definition
+ */
+typedef enum
+{
+    CH9120_FRAME_CRC_NONE = 0x00,        /**< no trailer */
+    CH9120_FRAME_CRC_16   = 0x01,        /**< crc-16/ccitt-false trailer */
+    CH9120_FRAME_CRC_32   = 0x02,        /**< crc-32 trailer */
+} ch9120_frame_crc_t;
+
+/**
+ * @brief ch9120 async status enumeration definition
+ */
+typedef enum
+{
+    CH9120_ASYNC_STATUS_BUSY    = 0x00,        /**< command is running */
+    CH9120_ASYNC_STATUS_OK      = 0x01,        /**< command is done */
+    CH9120_ASYNC_STATUS_ERROR   = 0x02,        /**< write failed or the chip answered an error */
+    CH9120_ASYNC_STATUS_TIMEOUT = 0x03,        /**< no answer */
+} ch9120_async_status_t;
+
+/**
+ * @brief ch9120 lock enumeration definition
+ */
+typedef enum
+{
+    CH9120_LOCK_CFG = 0x00,        /**< configuration transaction, taken before CH9120_LOCK_IO */
+    CH9120_LOCK_IO  = 0x01,        /**< uart data path */
+} ch9120_lock_t;
+
+/**
+ * @brief ch9120 command enumeration definition
+ */
+typedef enum
+{
+    CH9120_COMMAND_GET_VERSION                 = 0x00,        /**< out 1 byte */
+    CH9120_COMMAND_RESET                       = 0x01,        /**< waits until the chip boots */
+    CH9120_COMMAND_GET_STATUS                  = 0x02,        /**< out 1 byte */
+    CH9120_COMMAND_SAVE_TO_EEPROM              = 0x03,        /**< no payload */
+    CH9120_COMMAND_CONFIG_AND_RESET            = 0x04,        /**< waits until the chip boots */
+    CH9120_COMMAND_EXIT                        = 0x05,        /**< no payload */
+    CH9120_COMMAND_SET_MODE                    = 0x06,        /**< in 1 byte */
+    CH9120_COMMAND_GET_MODE                    = 0x07,        /**< out 1 byte */
+    CH9120_COMMAND_SET_IP                      = 0x08,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_IP                      = 0x09,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_SUBNET_MASK             = 0x0A,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_SUBNET_MASK             = 0x0B,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_GATEWAY                 = 0x0C,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_GATEWAY                 = 0x0D,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_SOURCE_PORT             = 0x0E,        /**< in 2 bytes */
+    CH9120_COMMAND_GET_SOURCE_PORT             = 0x0F,        /**< out 2 bytes */
+    CH9120_COMMAND_SET_DEST_IP                 = 0x10,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_DEST_IP                 = 0x11,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_DEST_PORT               = 0x12,        /**< in 2 bytes */
+    CH9120_COMMAND_GET_DEST_PORT               = 0x13,        /**< out 2 bytes */
+    CH9120_COMMAND_SET_SOURCE_PORT_RANDOM      = 0x14,        /**< in 1 byte */
+    CH9120_COMMAND_SET_UART_BAUD               = 0x15,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_UART_BAUD               = 0x16,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_UART_CONFIG             = 0x17,        /**< in 3 bytes, stop bit, parity and data bit */
+    CH9120_COMMAND_GET_UART_CONFIG             = 0x18,        /**< out 3 bytes, stop bit, parity and data bit */
+    CH9120_COMMAND_SET_UART_TIMEOUT            = 0x19,        /**< in 4 bytes, the timeout and 3 zero bytes */
+    CH9120_COMMAND_GET_UART_TIMEOUT            = 0x1A,        /**< out 1 byte */
+    CH9120_COMMAND_SET_UART_BUFFER_LENGTH      = 0x1B,        /**< in 4 bytes */
+    CH9120_COMMAND_GET_UART_BUFFER_LENGTH      = 0x1C,        /**< out 4 bytes */
+    CH9120_COMMAND_SET_UART_FLUSH              = 0x1D,        /**< in 1 byte */
+    CH9120_COMMAND_GET_UART_FLUSH              = 0x1E,        /**< out 1 byte */
+    CH9120_COMMAND_SET_DISCONNECT_WITH_NO_RJ45 = 0x1F,        /**< in 1 byte */
+    CH9120_COMMAND_GET_DISCONNECT_WITH_NO_RJ45 = 0x20,        /**< out 1 byte */
+    CH9120_COMMAND_SET_DHCP                    = 0x21,        /**< in 1 byte */
+    CH9120_COMMAND_NUM                         = 0x22,        /**< command number */
+} ch9120_command_t;
+
+/**
+ * @brief ch9120 trace type enumeration definition
+ */
+typedef enum
+{
+    CH9120_TRACE_TYPE_WRITE_CHECK = 0x00,        /**< command with ack */
+    CH9120_TRACE_TYPE_WRITE_READ  = 0x01,        /**< command with response */
+    CH9120_TRACE_TYPE_READ        = 0x02,        /**< data read */
+    CH9120_TRACE_TYPE_WRITE       = 0x03,        /**< data write */
+} ch9120_trace_type_t;
+
+/**
+ * @brief ch9120 trace structure definition
+ */
+typedef struct ch9120_trace_s
+{
+    ch9120_trace_type_t type;        /**< trace type */
+    uint8_t cmd;                     /**< command id, 0 for data transfer */
+    uint8_t status;                  /**< status code, only valid in the end hook */
+    uint16_t tx_len;                 /**< transmitted bytes */
+    uint16_t rx_len;                 /**< expected bytes in the begin hook, received bytes in the end hook */
+    uint64_t timestamp_us;           /**< monotonic timestamp in us */
+} ch9120_trace_t;
+
+/**
+ * @brief ch9120 cached parameter number definition
+ */
+#define CH9120_PARAM_NUM    15        /**< 15 parameters */
+
+/**
+ * @brief ch9120 eeprom record structure definition
+ */
+typedef struct ch9120_record_s
+{
+    uint32_t magic;                           /**< record magic */
+    uint32_t eeprom_writes;                   /**< eeprom write count */
+    uint16_t valid;                           /**< saved parameter valid mask */
+    uint8_t param[CH9120_PARAM_NUM][4];       /**< saved parameters */
+} ch9120_record_t;
+
+/**
+ * @brief ch9120 auto tune sample structure definition
+ */
+typedef struct ch9120_autotune_sample_s
+{
+    uint32_t idle_us;        /**< uart idle time before the write */
+    uint32_t busy_us;        /**< uart transfer time of the write */
+    uint16_t len;            /**< write length */
+} ch9120_autotune_sample_t;
+
+/**
+ * @brief ch9120 lock stats structure definition
+ */
+typedef struct ch9120_lock_stats_s
+{
+    uint32_t acquired;           /**< lock count */
+    uint32_t contended;          /**< locks that had to wait */
+    uint32_t max_wait_us;        /**< longest wait */
+    uint64_t wait_us;            /**< total wait */
+} ch9120_lock_stats_t;
+
+/**
+ * @brief ch9120 pool stats structure definition
+ */
+typedef struct ch9120_pool_stats_s
+{
+    uint16_t block_size;        /**< block size */
+    uint16_t block_num;         /**< block number */
+    uint16_t used;              /**< allocated blocks */
+    uint16_t peak;              /**< most blocks allocated at once */
+    uint32_t allocs;            /**< successful allocs */
+    uint32_t fails;             /**< allocs from an empty pool */
+} ch9120_pool_stats_t;
+
+/**
+ * @brief ch9120 view structure definition
+ */
+typedef struct ch9120_view_s
+{
+    uint8_t *buf[2];        /**< data segments, the second one is used when the ring wraps */
+    uint16_t len[2];        /**< segment lengths */
+} ch9120_view_t;
+
 /**
  * @brief ch9120 handle structure definition
+ * @note  the data path fields come first so they share the first cache lines
  */
 typedef struct ch9120_handle_s
 {
+    uint16_t (*uart_read)(uint8_t *buf, uint16_t len);        /**< point to an uart_read function address */
+    uint8_t (*uart_write)(uint8_t *buf, uint16_t len);        /**< point to an uart_write function address */
+    uint8_t (*uart_peek)(ch9120_view_t *view);                /**< point to an uart_peek function address */
+    uint8_t (*uart_consume)(uint16_t len);                    /**< point to an uart_consume function address */
+    uint8_t (*mutex_lock)(void *ctx, uint8_t id, uint8_t wait);    /**< point to a mutex_lock function address */
+    void (*mutex_unlock)(void *ctx, uint8_t id);              /**< point to a mutex_unlock function address */
+    void *mutex_ctx;                                          /**< per handle mutex context */
+    uint64_t (*timestamp_us)(void);                           /**< point to a timestamp_us function address */
+    void (*trace_begin)(const ch9120_trace_t *trace);         /**< point to a trace_begin function address */
+    void (*trace_end)(const ch9120_trace_t *trace);           /**< point to a trace_end function address */
+    uint64_t io_last_us;                                      /**< last data transfer time */
+#if (CH9120_ENABLE_COALESCE == 1)
+    uint8_t *tx_buf;                                          /**< write coalesce buffer */
+    uint64_t tx_first_us;                                     /**< first coalesced byte time */
+    uint16_t tx_size;                                         /**< write coalesce buffer size */
+    uint16_t tx_len;                                          /**< coalesced bytes */
+    uint16_t tx_latency_ms;                                   /**< write coalesce latency budget */
+    uint8_t tx_cork;                                          /**< write cork flag */
+#endif
+    uint16_t peek_len;                                        /**< length lent by the last peek */
+#if (CH9120_ENABLE_ASYNC == 1)
+    uint8_t async_state;                                      /**< async command state */
+#endif
+    uint8_t inited;                                           /**< inited flag */
     uint8_t (*uart_init)(void);                               /**< point to an uart_init function address */
     uint8_t (*uart_deinit)(void);                             /**< point to an uart_deinit function address */
-    uint16_t (*uart_read)(uint8_t *buf, uint16_t len);        /**< point to an uart_read function address */
     uint8_t (*uart_flush)(void);                              /**< point to an uart_flush function address */
-    uint8_t (*uart_write)(uint8_t *buf, uint16_t len);        /**< point to an uart_write function address */
     uint8_t (*reset_gpio_init)(void);                         /**< point to a reset_gpio_init function address */
     uint8_t (*reset_gpio_deinit)(void);                       /**< point to a reset_gpio_deinit function address */
     uint8_t (*reset_gpio_write)(uint8_t data);                /**< point to a reset_gpio_write function address */
@@ -122,8 +411,85 @@ typedef struct ch9120_handle_s
     uint8_t (*cfg_gpio_write)(uint8_t data);                  /**< point to a cfg_gpio_write function address */
     void (*delay_ms)(uint32_t ms);                            /**< point to a delay_ms function address */
     void (*debug_print)(const char *const fmt, ...);          /**< point to a debug_print function address */
-    uint8_t inited;                                           /**< inited flag */
-    uint8_t buf[128];                                         /**< inner buffer */
+    uint8_t (*storage_read)(uint8_t *buf, uint16_t len);      /**< point to a storage_read function address */
+    uint8_t (*storage_write)(uint8_t *buf, uint16_t len);     /**< point to a storage_write function address */
+    uint32_t (*crc32)(uint8_t *buf, uint16_t len);            /**< point to a crc32 function address */
+#if (CH9120_ENABLE_MONITOR == 1)
+    void (*receive_callback)(uint8_t type);                   /**< point to a receive_callback function address */
+#endif
+#if (CH9120_ENABLE_ASYNC == 1)
+    void (*async_callback)(uint16_t token, ch9120_async_status_t status);    /**< point to an async_callback function address */
+#endif
+    uint8_t (*mutex_init)(void **ctx);                        /**< point to a mutex_init function address */
+    void (*mutex_deinit)(void *ctx);                          /**< point to a mutex_deinit function address */
+    uint8_t param[CH9120_PARAM_NUM][4];                       /**< cached parameters */
+    uint32_t boot_ms;                                         /**< last measured boot time */
+    uint32_t eeprom_writes;                                   /**< eeprom write count */
+    uint16_t param_valid;                                     /**< cached parameter valid mask */
+    uint16_t param_dirty;                                     /**< unsaved parameter mask */
+    uint8_t pending;                                          /**< pending apply flags */
+#if (CH9120_ENABLE_MONITOR == 1)
+    uint64_t monitor_next_us;                                 /**< next link poll time */
+    uint32_t monitor_interval_ms;                             /**< link poll interval */
+    uint8_t monitor_enable;                                   /**< link monitor flag */
+    uint8_t link;                                             /**< last link status */
+#endif
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+    ch9120_autotune_sample_t *tune_sample;                    /**< auto tune sample buffer */
+    uint16_t tune_num;                                        /**< auto tune sample number */
+    uint16_t tune_count;                                      /**< auto tune sampled writes */
+    uint16_t tune_latency_ms;                                 /**< auto tune latency target */
+    uint32_t tune_window_ms;                                  /**< auto tune training window */
+    uint64_t tune_start_us;                                   /**< auto tune training start time */
+    uint64_t tune_last_us;                                    /**< auto tune last write end time */
+    uint16_t tune_timeout_ms;                                 /**< tuned uart timeout */
+    uint32_t tune_len;                                        /**< tuned uart buffer length */
+#endif
+#if (CH9120_ENABLE_FRAME == 1)
+    uint8_t *frame_buf;                                       /**< frame decode buffer */
+    uint16_t frame_size;                                      /**< frame decode buffer size */
+    uint16_t frame_len;                                       /**< decoded frame bytes */
+    uint16_t frame_pos;                                       /**< next raw byte to decode */
+    uint16_t frame_raw;                                       /**< end of the raw bytes */
+    uint8_t frame_type;                                       /**< frame type */
+    uint8_t frame_code;                                       /**< cobs block code */
+    uint8_t frame_left;                                       /**< cobs block bytes left */
+    uint8_t frame_esc;                                        /**< slip escape flag */
+    uint8_t frame_drop;                                       /**< drop until the next delimiter */
+    uint8_t frame_crc;                                        /**< frame crc type */
+    uint8_t frame_zip;                                        /**< frame compression flag */
+    uint8_t *zip_buf;                                         /**< compress buffer */
+    uint16_t zip_size;                                        /**< compress buffer size */
+    uint32_t frame_errors;                                    /**< broken frames */
+#endif
+#if (CH9120_ENABLE_POOL == 1)
+    uint8_t *pool_buf;                                        /**< pool memory */
+    uint16_t pool_block;                                      /**< pool block size */
+    uint16_t pool_num;                                        /**< pool block number */
+    uint32_t pool_head;                                       /**< free list head index and tag */
+    uint16_t pool_used;                                       /**< allocated blocks */
+    uint16_t pool_peak;                                       /**< most blocks allocated at once */
+    uint32_t pool_allocs;                                     /**< successful allocs */
+    uint32_t pool_fails;                                      /**< allocs from an empty pool */
+    uint8_t pool_owned;                                       /**< buffers taken from the pool by the driver */
+#endif
+#if (CH9120_ENABLE_ASYNC == 1)
+    uint8_t async_status;                                     /**< async command status */
+    uint16_t async_token;                                     /**< async command token */
+    uint16_t async_len;                                       /**< async command param length */
+    uint16_t async_pre_delay;                                 /**< async command pre delay */
+    uint16_t async_timeout;                                   /**< async command timeout */
+    uint8_t *async_out;                                       /**< async command output buffer */
+    uint16_t async_out_len;                                   /**< async command output length */
+    uint16_t async_point;                                     /**< async command received length */
+    uint32_t async_ready_ms;                                  /**< async command read start time */
+    uint32_t async_deadline_ms;                               /**< async command deadline */
+    ch9120_trace_t async_trace;                               /**< async command trace */
+    uint8_t async_param[5];                                   /**< async command and value kept for tracking */
+#endif
+#if (CH9120_ENABLE_LOCK_STATS == 1)
+    ch9120_lock_stats_t lock_stats[2];                        /**< lock stats */
+#endif
 } ch9120_handle_t;
 
 /**
@@ -201,6 +567,22 @@ typedef struct ch9120_info_s
  */
 #define DRIVER_CH9120_LINK_UART_FLUSH(HANDLE, FUC)          (HANDLE)->uart_flush = FUC
 
+/**
+ * @brief     link uart_peek function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to an uart_peek function address
+ * @note      optional, fills the view with the received data in place without removing it
+ */
+#define DRIVER_CH9120_LINK_UART_PEEK(HANDLE, FUC)           (HANDLE)->uart_peek = FUC
+
+/**
+ * @brief     link uart_consume function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to an uart_consume function address
+ * @note      optional, removes data returned by uart_peek
+ */
+#define DRIVER_CH9120_LINK_UART_CONSUME(HANDLE, FUC)        (HANDLE)->uart_consume = FUC
+
 /**
  * @brief     link reset_gpio_init function
  * @param[in] HANDLE pointer to a ch9120 handle structure
@@ -255,69 +637,438 @@ typedef struct ch9120_info_s
  * @param[in] FUC pointer to a delay_ms function address
  * @note      none
  */
-#define DRIVER_CH9120_LINK_DELAY_MS(HANDLE, FUC)            (HANDLE)->delay_ms = FUC
+#define DRIVER_CH9120_LINK_DELAY_MS(HANDLE, FUC)            (HANDLE)->delay_ms = FUC
+
+/**
+ * @brief     link debug_print function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a debug_print function address
+ * @note      none
+ */
+#define DRIVER_CH9120_LINK_DEBUG_PRINT(HANDLE, FUC)         (HANDLE)->debug_print = FUC
+
+/**
+ * @brief     link timestamp_us function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a timestamp_us function address
+ * @note      optional, timestamps are 0 if it is not linked
+ */
+#define DRIVER_CH9120_LINK_TIMESTAMP_US(HANDLE, FUC)        (HANDLE)->timestamp_us = FUC
+
+/**
+ * @brief     link trace_begin function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a trace_begin function address
+ * @note      optional, called before every command or data transfer
+ */
+#define DRIVER_CH9120_LINK_TRACE_BEGIN(HANDLE, FUC)         (HANDLE)->trace_begin = FUC
+
+/**
+ * @brief     link trace_end function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a trace_end function address
+ * @note      optional, called after every command or data transfer
+ */
+#define DRIVER_CH9120_LINK_TRACE_END(HANDLE, FUC)           (HANDLE)->trace_end = FUC
+
+/**
+ * @brief     link storage_read function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a storage_read function address
+ * @note      optional, loads the eeprom record at init
+ */
+#define DRIVER_CH9120_LINK_STORAGE_READ(HANDLE, FUC)        (HANDLE)->storage_read = FUC
+
+/**
+ * @brief     link storage_write function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a storage_write function address
+ * @note      optional, stores the eeprom record after every eeprom write
+ */
+#define DRIVER_CH9120_LINK_STORAGE_WRITE(HANDLE, FUC)       (HANDLE)->storage_write = FUC
+
+/**
+ * @brief     link crc32 function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a crc32 function address
+ * @note      optional, a faster crc-32 for the frame trailer, the driver table is used if NULL
+ */
+#define DRIVER_CH9120_LINK_CRC32(HANDLE, FUC)               (HANDLE)->crc32 = FUC
+
+#if (CH9120_ENABLE_MONITOR == 1)
+/**
+ * @brief     link receive_callback function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a receive_callback function address
+ * @note      optional, receives the ch9120_status_t link events of the monitor
+ */
+#define DRIVER_CH9120_LINK_RECEIVE_CALLBACK(HANDLE, FUC)    (HANDLE)->receive_callback = FUC
+#endif
+
+#if (CH9120_ENABLE_ASYNC == 1)
+/**
+ * @brief     link async_callback function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to an async_callback function address
+ * @note      optional, runs from ch9120_poll when an async command completes
+ */
+#define DRIVER_CH9120_LINK_ASYNC_CALLBACK(HANDLE, FUC)      (HANDLE)->async_callback = FUC
+#endif
+
+/**
+ * @brief     link mutex_init function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a mutex_init function address
+ * @note      needed with mutex_lock, creates the cfg and io locks of one handle
+ *            and returns their context, which is kept in the handle
+ */
+#define DRIVER_CH9120_LINK_MUTEX_INIT(HANDLE, FUC)          (HANDLE)->mutex_init = FUC
+
+/**
+ * @brief     link mutex_deinit function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a mutex_deinit function address
+ * @note      needed with mutex_lock
+ */
+#define DRIVER_CH9120_LINK_MUTEX_DEINIT(HANDLE, FUC)        (HANDLE)->mutex_deinit = FUC
+
+/**
+ * @brief     link mutex_lock function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a mutex_lock function address
+ * @note      optional, returns 0 when locked and 1 when wait is 0 and the lock is busy,
+ *            the handle is only thread safe when the four mutex functions are linked
+ */
+#define DRIVER_CH9120_LINK_MUTEX_LOCK(HANDLE, FUC)          (HANDLE)->mutex_lock = FUC
+
+/**
+ * @brief     link mutex_unlock function
+ * @param[in] HANDLE pointer to a ch9120 handle structure
+ * @param[in] FUC pointer to a mutex_unlock function address
+ * @note      optional
+ */
+#define DRIVER_CH9120_LINK_MUTEX_UNLOCK(HANDLE, FUC)        (HANDLE)->mutex_unlock = FUC
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup ch9120_base_driver ch9120 base driver function
+ * @brief    ch9120 base driver modules
+ * @ingroup  ch9120_driver
+ * @{
+ */
+
+#if (CH9120_ENABLE_INFO == 1)
+/**
+ * @brief      get chip's information
+ * @param[out] *info pointer to a ch9120 info structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ * @note       none
+ */
+uint8_t ch9120_info(ch9120_info_t *info);
+#endif
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 uart initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 reset gpio init failed
+ *            - 5 cfg gpio init failed
+ *            - 6 reset failed
+ *            - 7 chip is not ready
+ *            - 8 mutex init failed
+ * @note      not locked, run it before other threads use the handle,
+ *            the chip is ready once two get version probes answer the same version,
+ *            the cached parameters of the eeprom record are read back from the chip
+ */
+uint8_t ch9120_init(ch9120_handle_t *handle);
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 uart deinit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 reset failed
+ *            - 5 reset gpio deinit failed
+ *            - 6 cfg gpio deinit failed
+ * @note      the coalesced data is sent first, not locked, run it after other threads stop using the handle
+ */
+uint8_t ch9120_deinit(ch9120_handle_t *handle);
+
+/**
+ * @brief         read data
+ * @param[in]     *handle pointer to a ch9120 handle structure
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ *                - 2 handle is NULL
+ *                - 3 handle is not initialized
+ * @note          none
+ */
+uint8_t ch9120_read(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len);
+
+/**
+ * @brief      peek the received data in place
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *view pointer to a view structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read peek failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 uart_peek or uart_consume is not linked
+ * @note       the view points into the interface receive buffer and stays valid until ch9120_read_consume,
+ *             only the reading thread may use it
+ */
+uint8_t ch9120_read_peek(ch9120_handle_t *handle, ch9120_view_t *view);
+
+/**
+ * @brief     release the peeked data
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] len consumed length
+ * @return    status code
+ *            - 0 success
+ *            - 1 read consume failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 uart_peek or uart_consume is not linked
+ *            - 5 len is over the peeked length
+ * @note      the rest of the peeked data stays in the receive buffer
+ */
+uint8_t ch9120_read_consume(ch9120_handle_t *handle, uint16_t len);
+
+/**
+ * @brief     write data
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the data is batched when the write coalescer is set
+ */
+uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len);
+
+#if (CH9120_ENABLE_COALESCE == 1)
+/**
+ * @brief     set the write coalescer
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a coalesce buffer, NULL takes a pool block when a pool is set
+ *                 and disables the coalescer otherwise
+ * @param[in] size coalesce buffer size, 0 disables the coalescer
+ * @param[in] latency_ms max time a byte is held, 0 means no limit
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no pool block fits
+ * @note      a batch is sent as one uart burst when it reaches the buffer size or the
+ *            cached uart buffer length, the latency budget needs timestamp_us
+ */
+uint8_t ch9120_set_write_coalesce(ch9120_handle_t *handle, uint8_t *buf, uint16_t size, uint16_t latency_ms);
+
+/**
+ * @brief     enable or disable the write cork
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      a corked batch is only sent when the buffer is full, uncork sends it
+ */
+uint8_t ch9120_set_write_cork(ch9120_handle_t *handle, ch9120_bool_t enable);
+
+/**
+ * @brief     flush the coalesced data
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      flush before changing the dest to keep the data on the old session
+ */
+uint8_t ch9120_write_flush(ch9120_handle_t *handle);
+
+/**
+ * @brief     write coalescer handler
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, it flushes a batch once its latency budget is over
+ */
+uint8_t ch9120_write_handler(ch9120_handle_t *handle);
+
+/**
+ * @brief      get the coalesced data length
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *len pointer to a length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t ch9120_get_write_pending(ch9120_handle_t *handle, uint16_t *len);
+#endif
+
+#if (CH9120_ENABLE_AUTOTUNE == 1)
+/**
+ * @brief     start the uart auto tune
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *sample pointer to a sample buffer, NULL stops the training
+ * @param[in] num sample number
+ * @param[in] window_ms max training time, 0 means until the buffer is full
+ * @param[in] latency_ms max time from the first byte of a packet to its send
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ * @note      every uart burst of the data path is sampled until the buffer is full or
+ *            the window is over, then ch9120_autotune_handler applies the result
+ */
+uint8_t ch9120_set_autotune(ch9120_handle_t *handle, ch9120_autotune_sample_t *sample, uint16_t num,
+                            uint32_t window_ms, uint16_t latency_ms);
+
+/**
+ * @brief     uart auto tune handler
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, after the training it picks the uart timeout and
+ *            the uart buffer length with the fewest packets within the latency target
+ *            and saves them to the eeprom
+ */
+uint8_t ch9120_autotune_handler(ch9120_handle_t *handle);
 
 /**
- * @brief     link debug_print function
- * @param[in] HANDLE pointer to a ch9120 handle structure
- * @param[in] FUC pointer to a debug_print function address
- * @note      none
+ * @brief      get the uart auto tune result
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *timeout_ms pointer to a uart timeout buffer
+ * @param[out] *len pointer to a uart buffer length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 no result
+ * @note       none
  */
-#define DRIVER_CH9120_LINK_DEBUG_PRINT(HANDLE, FUC)         (HANDLE)->debug_print = FUC
+uint8_t ch9120_get_autotune(ch9120_handle_t *handle, uint16_t *timeout_ms, uint32_t *len);
+#endif
 
+#if (CH9120_ENABLE_FRAME == 1)
 /**
- * @}
+ * @brief     set the message framing
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] type frame type
+ * @param[in] *buf pointer to a decode buffer, NULL takes a pool block when a pool is set
+ *                 and only sends frames otherwise
+ * @param[in] size decode buffer size, the longest encoded frame
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no pool block fits
+ * @note      the decode buffer holds the partial frame and the bytes read after it
  */
+uint8_t ch9120_set_frame(ch9120_handle_t *handle, ch9120_frame_t type, uint8_t *buf, uint16_t size);
 
 /**
- * @defgroup ch9120_base_driver ch9120 base driver function
- * @brief    ch9120 base driver modules
- * @ingroup  ch9120_driver
- * @{
+ * @brief     set the frame crc
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] crc frame crc type
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the crc of the data is sent little endian after it, inside the frame,
+ *            received frames with a wrong crc are dropped and counted as broken
  */
+uint8_t ch9120_set_frame_crc(ch9120_handle_t *handle, ch9120_frame_crc_t crc);
 
 /**
- * @brief      get chip's information
- * @param[out] *info pointer to a ch9120 info structure
+ * @brief      get the frame crc
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *crc pointer to a frame crc type buffer
  * @return     status code
  *             - 0 success
  *             - 2 handle is NULL
+ *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t ch9120_info(ch9120_info_t *info);
+uint8_t ch9120_get_frame_crc(ch9120_handle_t *handle, ch9120_frame_crc_t *crc);
 
 /**
- * @brief     initialize the chip
+ * @brief     set the frame compression
  * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @param[in] *buf pointer to a compress buffer, NULL takes a pool block when a pool is set
+ *                 and only receives otherwise
+ * @param[in] size compress buffer size, the longest frame data plus 1
  * @return    status code
  *            - 0 success
- *            - 1 uart initialization failed
  *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 reset gpio init failed
- *            - 5 cfg gpio init failed
- *            - 6 reset failed
- * @note      none
+ *            - 3 handle is not initialized
+ *            - 4 no pool block fits
+ * @note      both ends of the session must enable it, every payload then starts with a codec
+ *            byte and is only sent compressed when it gets smaller
  */
-uint8_t ch9120_init(ch9120_handle_t *handle);
+uint8_t ch9120_set_frame_compress(ch9120_handle_t *handle, ch9120_bool_t enable, uint8_t *buf, uint16_t size);
 
 /**
- * @brief     close the chip
+ * @brief      get the frame compression
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *enable pointer to a bool value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t ch9120_get_frame_compress(ch9120_handle_t *handle, ch9120_bool_t *enable);
+
+/**
+ * @brief     send a frame
  * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
  * @return    status code
  *            - 0 success
- *            - 1 uart deinit failed
+ *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- *            - 4 reset failed
- *            - 5 reset gpio deinit failed
- *            - 6 cfg gpio deinit failed
- * @note      none
+ *            - 4 compress buffer is too small
+ * @note      the frame is encoded in small chunks through ch9120_write
  */
-uint8_t ch9120_deinit(ch9120_handle_t *handle);
+uint8_t ch9120_send_frame(ch9120_handle_t *handle, uint8_t *buf, uint16_t len);
 
 /**
- * @brief         read data
+ * @brief         receive a frame
  * @param[in]     *handle pointer to a ch9120 handle structure
  * @param[out]    *buf pointer to a data buffer
  * @param[in,out] *len pointer to a length buffer
@@ -326,23 +1077,87 @@ uint8_t ch9120_deinit(ch9120_handle_t *handle);
  *                - 1 read failed
  *                - 2 handle is NULL
  *                - 3 handle is not initialized
- * @note          none
+ *                - 4 no decode buffer
+ *                - 5 buffer is too small
+ * @note          len is 0 until a whole frame has arrived, the bytes read so far are decoded
+ *                and kept, a frame longer than the decode buffer is dropped,
+ *                after 5 the frame is kept for the next call
  */
-uint8_t ch9120_read(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len);
+uint8_t ch9120_recv_frame(ch9120_handle_t *handle, uint8_t *buf, uint16_t *len);
 
 /**
- * @brief     write data
+ * @brief      get the broken frame count
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *count pointer to a count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       truncated, badly escaped, too long, crc failed and undecodable frames are counted
+ */
+uint8_t ch9120_get_frame_errors(ch9120_handle_t *handle, uint32_t *count);
+#endif
+
+#if (CH9120_ENABLE_POOL == 1)
+/**
+ * @brief     set the block pool
  * @param[in] *handle pointer to a ch9120 handle structure
- * @param[in] *buf pointer to a data buffer
- * @param[in] len data length
+ * @param[in] *buf pointer to the pool memory, 2 byte aligned, NULL removes the pool
+ * @param[in] block_size block size, even and at least 2
+ * @param[in] block_num block number, less than 65535
  * @return    status code
  *            - 0 success
- *            - 1 write failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 block size or number is invalid
+ *            - 5 pool is in use
+ * @note      the memory holds block_size * block_num bytes, alloc and free are O(1),
+ *            the coalescer and the framing take a block when they are set with a NULL buffer
  */
-uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len);
+uint8_t ch9120_set_pool(ch9120_handle_t *handle, uint8_t *buf, uint16_t block_size, uint16_t block_num);
+
+/**
+ * @brief      alloc a pool block
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] **block pointer to a block pointer
+ * @return     status code
+ *             - 0 success
+ *             - 1 pool is empty
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       it may run from any thread when CH9120_POOL_LOCK_FREE is 1
+ */
+uint8_t ch9120_pool_alloc(ch9120_handle_t *handle, uint8_t **block);
+
+/**
+ * @brief     free a pool block
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] *block pointer to a block
+ * @return    status code
+ *            - 0 success
+ *            - 1 block is invalid
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      it may run from any thread when CH9120_POOL_LOCK_FREE is 1,
+ *            the block must be one that ch9120_pool_alloc returned, a pointer out of the pool,
+ *            into the middle of a block or a free with no block allocated is refused,
+ *            other double frees corrupt the free list unless CH9120_POOL_DEBUG is 1,
+ *            which walks the free list on every free and needs CH9120_POOL_LOCK_FREE 0
+ */
+uint8_t ch9120_pool_free(ch9120_handle_t *handle, uint8_t *block);
+
+/**
+ * @brief      get the pool stats
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *stats pointer to a pool stats structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t ch9120_get_pool_stats(ch9120_handle_t *handle, ch9120_pool_stats_t *stats);
+#endif
 
 /**
  * @brief      get version
@@ -353,6 +1168,7 @@ uint8_t ch9120_write(ch9120_handle_t *handle, uint8_t *buf, uint16_t len);
  *             - 1 get version failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 version is NULL
  * @note       none
  */
 uint8_t ch9120_get_version(ch9120_handle_t *handle, uint8_t *version);
@@ -362,13 +1178,25 @@ uint8_t ch9120_get_version(ch9120_handle_t *handle, uint8_t *version);
  * @param[in] *handle pointer to a ch9120 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 reset failed
+ *            - 1 reset failed or the chip is not ready
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      it returns as soon as the chip answers again
  */
 uint8_t ch9120_reset(ch9120_handle_t *handle);
 
+/**
+ * @brief      get the boot time
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *ms pointer to a ms buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       measured by the last init, reset or config and reset
+ */
+uint8_t ch9120_get_boot_time(ch9120_handle_t *handle, uint32_t *ms);
+
 /**
  * @brief      get status
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -378,10 +1206,41 @@ uint8_t ch9120_reset(ch9120_handle_t *handle);
  *             - 1 get status failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 status is NULL
  * @note       none
  */
 uint8_t ch9120_get_status(ch9120_handle_t *handle, ch9120_status_t *status);
 
+#if (CH9120_ENABLE_MONITOR == 1)
+/**
+ * @brief     enable or disable the link monitor
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the first poll reports the current link
+ */
+uint8_t ch9120_set_monitor(ch9120_handle_t *handle, ch9120_bool_t enable);
+
+/**
+ * @brief     link monitor handler
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 get status failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 timestamp_us is null
+ * @note      call it from the main loop, polls are placed into idle gaps of the data path and
+ *            a drop is seen within CH9120_MONITOR_SLOW_MS + CH9120_MONITOR_MAX_DEFER_MS,
+ *            a poll flushes the uart so it waits while received data is unread if uart_peek is linked,
+ *            without uart_peek read the data before calling it
+ */
+uint8_t ch9120_monitor_handler(ch9120_handle_t *handle);
+#endif
+
 /**
  * @brief     save to eeprom
  * @param[in] *handle pointer to a ch9120 handle structure
@@ -390,16 +1249,42 @@ uint8_t ch9120_get_status(ch9120_handle_t *handle, ch9120_status_t *status);
  *            - 1 save to eeprom failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      it is skipped when no parameter changed since the last save
  */
 uint8_t ch9120_save_to_eeprom(ch9120_handle_t *handle);
 
+/**
+ * @brief      get the eeprom write count
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *count pointer to a count buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the count survives a restart when the storage functions are linked
+ */
+uint8_t ch9120_get_eeprom_write_count(ch9120_handle_t *handle, uint32_t *count);
+
+/**
+ * @brief     clear the eeprom record
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 storage write failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      it clears the write count and the cached parameters, call it after the module is replaced
+ *            to restart the count, or after another tool wrote the chip eeprom while the handle is
+ *            initialized, else a setter that matches the stale cache is not applied
+ */
+uint8_t ch9120_clear_eeprom_record(ch9120_handle_t *handle);
+
 /**
  * @brief     config and reset the chip
  * @param[in] *handle pointer to a ch9120 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 config and reset failed
+ *            - 1 config and reset failed or the chip is not ready
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
@@ -418,6 +1303,36 @@ uint8_t ch9120_config_and_reset(ch9120_handle_t *handle);
  */
 uint8_t ch9120_exit(ch9120_handle_t *handle);
 
+/**
+ * @brief      get the required apply mode
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[out] *mode pointer to an apply mode buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the chip only runs a written parameter after a config and reset,
+ *             so any change needs CH9120_APPLY_PERSIST_AND_RESET
+ */
+uint8_t ch9120_get_apply_required(ch9120_handle_t *handle, ch9120_apply_t *mode);
+
+/**
+ * @brief     apply the changed parameters
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] mode apply mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 apply failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 mode is invalid
+ * @note      CH9120_APPLY_AUTO only resets the chip when a parameter changed from the cached chip value,
+ *            ch9120_clear_eeprom_record must run after another tool wrote the chip eeprom,
+ *            the config and reset writes the eeprom itself so no extra save is sent before it,
+ *            the boot is probed so the link is back as soon as the chip answers
+ */
+uint8_t ch9120_apply(ch9120_handle_t *handle, ch9120_apply_t mode);
+
 /**
  * @brief     set mode
  * @param[in] *handle pointer to a ch9120 handle structure
@@ -427,10 +1342,11 @@ uint8_t ch9120_exit(ch9120_handle_t *handle);
  *            - 1 set mode failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_mode(ch9120_handle_t *handle, ch9120_mode_t mode);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get mode
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -440,9 +1356,11 @@ uint8_t ch9120_set_mode(ch9120_handle_t *handle, ch9120_mode_t mode);
  *             - 1 get mode failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 mode is NULL
  * @note       none
  */
 uint8_t ch9120_get_mode(ch9120_handle_t *handle, ch9120_mode_t *mode);
+#endif
 
 /**
  * @brief     set ip address
@@ -453,10 +1371,12 @@ uint8_t ch9120_get_mode(ch9120_handle_t *handle, ch9120_mode_t *mode);
  *            - 1 set ip failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_ip(ch9120_handle_t *handle, uint8_t ip[4]);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get ip address
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -466,9 +1386,11 @@ uint8_t ch9120_set_ip(ch9120_handle_t *handle, uint8_t ip[4]);
  *             - 1 get ip failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 ip is NULL
  * @note       none
  */
 uint8_t ch9120_get_ip(ch9120_handle_t *handle, uint8_t ip[4]);
+#endif
 
 /**
  * @brief     set subnet mask
@@ -479,10 +1401,12 @@ uint8_t ch9120_get_ip(ch9120_handle_t *handle, uint8_t ip[4]);
  *            - 1 set subnet mask failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 5 mask is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4]);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get subnet mask
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -492,9 +1416,11 @@ uint8_t ch9120_set_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4]);
  *             - 1 get subnet mask failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 mask is NULL
  * @note       none
  */
 uint8_t ch9120_get_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4]);
+#endif
 
 /**
  * @brief     set gateway
@@ -505,10 +1431,12 @@ uint8_t ch9120_get_subnet_mask(ch9120_handle_t *handle, uint8_t mask[4]);
  *            - 1 set gateway failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_gateway(ch9120_handle_t *handle, uint8_t ip[4]);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get gateway
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -518,9 +1446,11 @@ uint8_t ch9120_set_gateway(ch9120_handle_t *handle, uint8_t ip[4]);
  *             - 1 get gateway failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 ip is NULL
  * @note       none
  */
 uint8_t ch9120_get_gateway(ch9120_handle_t *handle, uint8_t ip[4]);
+#endif
 
 /**
  * @brief     set source port
@@ -531,10 +1461,11 @@ uint8_t ch9120_get_gateway(ch9120_handle_t *handle, uint8_t ip[4]);
  *            - 1 set source port failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_source_port(ch9120_handle_t *handle, uint16_t num);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get source port
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -544,9 +1475,11 @@ uint8_t ch9120_set_source_port(ch9120_handle_t *handle, uint16_t num);
  *             - 1 get source port failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 num is NULL
  * @note       none
  */
 uint8_t ch9120_get_source_port(ch9120_handle_t *handle, uint16_t *num);
+#endif
 
 /**
  * @brief     set dest ip
@@ -557,10 +1490,12 @@ uint8_t ch9120_get_source_port(ch9120_handle_t *handle, uint16_t *num);
  *            - 1 set dest ip failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 5 ip is NULL
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_dest_ip(ch9120_handle_t *handle, uint8_t ip[4]);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get dest ip
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -570,9 +1505,11 @@ uint8_t ch9120_set_dest_ip(ch9120_handle_t *handle, uint8_t ip[4]);
  *             - 1 get dest ip failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 ip is NULL
  * @note       none
  */
 uint8_t ch9120_get_dest_ip(ch9120_handle_t *handle, uint8_t ip[4]);
+#endif
 
 /**
  * @brief     set dest port
@@ -583,10 +1520,11 @@ uint8_t ch9120_get_dest_ip(ch9120_handle_t *handle, uint8_t ip[4]);
  *            - 1 set dest port failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_dest_port(ch9120_handle_t *handle, uint16_t num);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get dest port
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -596,9 +1534,11 @@ uint8_t ch9120_set_dest_port(ch9120_handle_t *handle, uint16_t num);
  *             - 1 get dest port failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 num is NULL
  * @note       none
  */
 uint8_t ch9120_get_dest_port(ch9120_handle_t *handle, uint16_t *num);
+#endif
 
 /**
  * @brief     set uart baud
@@ -609,10 +1549,11 @@ uint8_t ch9120_get_dest_port(ch9120_handle_t *handle, uint16_t *num);
  *            - 1 set uart baud failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_uart_baud(ch9120_handle_t *handle, uint32_t baud);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get uart baud
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -622,9 +1563,11 @@ uint8_t ch9120_set_uart_baud(ch9120_handle_t *handle, uint32_t baud);
  *             - 1 get uart baud failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 baud is NULL
  * @note       none
  */
 uint8_t ch9120_get_uart_baud(ch9120_handle_t *handle, uint32_t *baud);
+#endif
 
 /**
  * @brief     set uart config
@@ -637,10 +1580,11 @@ uint8_t ch9120_get_uart_baud(ch9120_handle_t *handle, uint32_t *baud);
  *            - 1 set uart config failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_uart_config(ch9120_handle_t *handle, uint8_t data_bit, ch9120_parity_t parity, uint8_t stop_bit);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get uart config
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -652,9 +1596,11 @@ uint8_t ch9120_set_uart_config(ch9120_handle_t *handle, uint8_t data_bit, ch9120
  *             - 1 get uart config failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 data_bit, parity or stop_bit is NULL
  * @note       none
  */
 uint8_t ch9120_get_uart_config(ch9120_handle_t *handle, uint8_t *data_bit, ch9120_parity_t *parity, uint8_t *stop_bit);
+#endif
 
 /**
  * @brief     set uart timeout
@@ -665,10 +1611,11 @@ uint8_t ch9120_get_uart_config(ch9120_handle_t *handle, uint8_t *data_bit, ch912
  *            - 1 set uart timeout failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_uart_timeout(ch9120_handle_t *handle, uint8_t timeout);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get uart timeout
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -678,9 +1625,11 @@ uint8_t ch9120_set_uart_timeout(ch9120_handle_t *handle, uint8_t timeout);
  *             - 1 get uart timeout failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 timeout is NULL
  * @note       none
  */
 uint8_t ch9120_get_uart_timeout(ch9120_handle_t *handle, uint8_t *timeout);
+#endif
 
 /**
  * @brief      convert the uart timeout to the register raw data
@@ -717,7 +1666,7 @@ uint8_t ch9120_uart_timeout_convert_to_data(ch9120_handle_t *handle, uint8_t reg
  *            - 1 set source port random failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_source_port_random(ch9120_handle_t *handle, ch9120_bool_t enable);
 
@@ -730,10 +1679,11 @@ uint8_t ch9120_set_source_port_random(ch9120_handle_t *handle, ch9120_bool_t ena
  *            - 1 set uart buffer length failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_uart_buffer_length(ch9120_handle_t *handle, uint32_t len);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get uart buffer length
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -743,9 +1693,11 @@ uint8_t ch9120_set_uart_buffer_length(ch9120_handle_t *handle, uint32_t len);
  *             - 1 get uart buffer length failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 len is NULL
  * @note       none
  */
 uint8_t ch9120_get_uart_buffer_length(ch9120_handle_t *handle, uint32_t *len);
+#endif
 
 /**
  * @brief     enable or disable uart auto flush
@@ -756,10 +1708,11 @@ uint8_t ch9120_get_uart_buffer_length(ch9120_handle_t *handle, uint32_t *len);
  *            - 1 set uart flush failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get uart auto flush status
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -769,9 +1722,11 @@ uint8_t ch9120_set_uart_flush(ch9120_handle_t *handle, ch9120_bool_t enable);
  *             - 1 get uart flush failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 enable is NULL
  * @note       none
  */
 uint8_t ch9120_get_uart_flush(ch9120_handle_t *handle, ch9120_bool_t *enable);
+#endif
 
 /**
  * @brief     enable or disable disconnect with no rj45
@@ -782,10 +1737,11 @@ uint8_t ch9120_get_uart_flush(ch9120_handle_t *handle, ch9120_bool_t *enable);
  *            - 1 set disconnect with no rj45 failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t enable);
 
+#if (CH9120_ENABLE_GETTERS == 1)
 /**
  * @brief      get disconnect with no rj45 status
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -795,10 +1751,13 @@ uint8_t ch9120_set_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_
  *             - 1 get disconnect with no rj45 failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
+ *             - 5 enable is NULL
  * @note       none
  */
 uint8_t ch9120_get_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_t *enable);
+#endif
 
+#if (CH9120_ENABLE_DHCP == 1)
 /**
  * @brief     enable or disable dhcp
  * @param[in] *handle pointer to a ch9120 handle structure
@@ -808,9 +1767,10 @@ uint8_t ch9120_get_disconnect_with_no_rj45(ch9120_handle_t *handle, ch9120_bool_
  *            - 1 set dhcp failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ * @note      an unchanged value is not marked for apply, see ch9120_clear_eeprom_record
  */
 uint8_t ch9120_set_dhcp(ch9120_handle_t *handle, ch9120_bool_t enable);
+#endif
 
 /**
  * @}
@@ -823,6 +1783,7 @@ uint8_t ch9120_set_dhcp(ch9120_handle_t *handle, ch9120_bool_t enable);
  * @{
  */
 
+#if (CH9120_ENABLE_SET_COMMAND == 1)
 /**
  * @brief      set command
  * @param[in]  *handle pointer to a ch9120 handle structure
@@ -843,6 +1804,118 @@ uint8_t ch9120_set_command(ch9120_handle_t *handle,
                            uint8_t *param, uint16_t len,
                            uint8_t *out, uint16_t out_len,
                            uint16_t pre_delay, uint16_t timeout);
+#endif
+
+/**
+ * @brief      run a command from the command table
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 exec failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 id is invalid
+ *             - 5 in or out is NULL
+ * @note       in and out hold the payload and the response in the wire order,
+ *             multi-byte values are little endian, ch9120_async_exec and the command
+ *             wrappers return the same codes, 6 and 7 only come from ch9120_async_exec
+ */
+uint8_t ch9120_exec(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out);
+
+#if (CH9120_ENABLE_ASYNC == 1)
+/**
+ * @brief      start an async command
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  *param pointer to a param buffer
+ * @param[in]  len param length
+ * @param[out] *out pointer to an out buffer, NULL expects the 0xAA answer
+ * @param[in]  out_len output length, 0 expects the 0xAA answer
+ * @param[in]  pre_delay delay in ms
+ * @param[in]  timeout timeout in ms
+ * @param[out] *token pointer to a token buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 write failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 command is busy
+ *             - 5 len is invalid
+ * @note       only the command is written, ch9120_poll waits for the answer,
+ *             other commands and the data path are refused until it completes
+ */
+uint8_t ch9120_async_command(ch9120_handle_t *handle,
+                             uint8_t *param, uint16_t len,
+                             uint8_t *out, uint16_t out_len,
+                             uint16_t pre_delay, uint16_t timeout,
+                             uint16_t *token);
+
+/**
+ * @brief      start an async command from the command table
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  id command id
+ * @param[in]  *in pointer to a payload buffer
+ * @param[out] *out pointer to a response buffer
+ * @param[out] *token pointer to a token buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 write failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 id is invalid
+ *             - 5 in or out is NULL
+ *             - 6 id reboots the chip
+ *             - 7 command is busy
+ * @note       in and out are in the wire order like ch9120_exec, reset and config and reset
+ *             wait until the chip boots and only run with ch9120_exec,
+ *             the codes are the ones of ch9120_exec
+ */
+uint8_t ch9120_async_exec(ch9120_handle_t *handle, ch9120_command_t id, uint8_t *in, uint8_t *out, uint16_t *token);
+
+/**
+ * @brief     poll the async command
+ * @param[in] *handle pointer to a ch9120 handle structure
+ * @param[in] now_ms current time in ms
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      call it from the main loop, it never delays, the async_callback runs on completion
+ */
+uint8_t ch9120_poll(ch9120_handle_t *handle, uint32_t now_ms);
+
+/**
+ * @brief      get the async command status
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  token command token
+ * @param[out] *status pointer to an async status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 token is unknown
+ * @note       only the last command is kept
+ */
+uint8_t ch9120_async_get_status(ch9120_handle_t *handle, uint16_t token, ch9120_async_status_t *status);
+#endif
+
+#if (CH9120_ENABLE_LOCK_STATS == 1)
+/**
+ * @brief      get the lock stats
+ * @param[in]  *handle pointer to a ch9120 handle structure
+ * @param[in]  lock lock
+ * @param[out] *stats pointer to a lock stats structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       configuration transactions take CH9120_LOCK_CFG and CH9120_LOCK_IO,
+ *             ch9120_read and the data write path only take CH9120_LOCK_IO
+ */
+uint8_t ch9120_get_lock_stats(ch9120_handle_t *handle, ch9120_lock_t lock, ch9120_lock_stats_t *stats);
+#endif
 
 /**
  * @}
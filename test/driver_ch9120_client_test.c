@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_client_test.c
+ * @brief     driver ch9120 client test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_client_test.h"
+#include <stdio.h>
+
+/**
+ * @brief     client test
+ * @param[in] *dest pointer to a dest list
+ * @param[in] num dest number
+ * @param[in] second test time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      a numbered record is sent every 100ms, stop the server or unplug
+ *            the rj45 cable while the test is running
+ */
+uint8_t ch9120_client_test(const ch9120_client_dest_t *dest, uint8_t num, uint32_t second)
+{
+    uint8_t res;
+    uint8_t connected;
+    uint32_t i;
+    uint32_t records;
+    char record[8];
+    ch9120_client_stats_t stats;
+    
+    /* start client test */
+    ch9120_interface_debug_print("ch9120: start client test.\n");
+    
+    /* client init */
+    res = ch9120_client_init(dest, num);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: client init failed.\n");
+        
+        return 1;
+    }
+    
+    /* write a record every 100ms and run the handler every 10ms */
+    connected = 0;
+    records = 0;
+    for (i = 0; i < second * 100; i++)
+    {
+        if ((i % 10) == 0)
+        {
+            (void)snprintf(record, 8, "%06d\n", (int)records);
+            res = ch9120_client_write((uint8_t *)record, 7);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: client write failed.\n");
+                (void)ch9120_client_deinit();
+                
+                return 1;
+            }
+            records++;
+        }
+        res = ch9120_client_handler();
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: client handler failed.\n");
+            (void)ch9120_client_deinit();
+            
+            return 1;
+        }
+        (void)ch9120_client_get_stats(&stats);
+        if (stats.connected != connected)
+        {
+            connected = stats.connected;
+            ch9120_interface_debug_print("ch9120: client %s dest %d.%d.%d.%d:%d at %d ms.\n",
+                                         (connected != 0) ? "connect" : "disconnect",
+                                         dest[stats.dest].ip[0], dest[stats.dest].ip[1],
+                                         dest[stats.dest].ip[2], dest[stats.dest].ip[3],
+                                         dest[stats.dest].port,
+                                         (uint32_t)(ch9120_interface_timestamp_us() / 1000));
+        }
+        ch9120_interface_delay_ms(10);
+    }
+    
+    /* output */
+    ch9120_interface_debug_print("ch9120: %d records, %d reconnects and %d failovers.\n",
+                                 records, stats.reconnects, stats.failovers);
+    ch9120_interface_debug_print("ch9120: %d bytes buffered and %d bytes dropped.\n",
+                                 stats.buffered, stats.dropped);
+    if ((stats.connected == 0) || (stats.buffered != 0) || (stats.dropped != 0))
+    {
+        ch9120_interface_debug_print("ch9120: backlog is not delivered.\n");
+        (void)ch9120_client_deinit();
+        
+        return 1;
+    }
+    
+    /* finish client test */
+    ch9120_interface_debug_print("ch9120: finish client test.\n");
+    (void)ch9120_client_deinit();
+    
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_fault_interface.c
+ * @brief     driver ch9120 fault interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_fault_interface.h"
+
+static ch9120_fault_t gs_fault;                                       /**< fault rates */
+static ch9120_fault_count_t gs_count;                                 /**< fault counters */
+static uint32_t gs_random = 1;                                        /**< random state */
+static uint8_t gs_stash[CH9120_FAULT_INTERFACE_STASH_LEN];            /**< stashed rx data */
+static uint16_t gs_stash_len;                                         /**< stashed rx length */
+static uint32_t gs_hold_ms;                                           /**< remaining delay of the stashed data */
+
+/**
+ * @brief  get a random number
+ * @return random number in [0, 1000)
+ * @note   xorshift32 so that a seed always replays the same faults
+ */
+static uint16_t a_fault_random(void)
+{
+    gs_random ^= gs_random << 13;
+    gs_random ^= gs_random >> 17;
+    gs_random ^= gs_random << 5;
+    
+    return (uint16_t)(gs_random % 1000);
+}
+
+/**
+ * @brief     check a fault
+ * @param[in] rate fault rate in 1/1000
+ * @return    1 if the fault happens
+ * @note      none
+ */
+static uint8_t a_fault_hit(uint16_t rate)
+{
+    if (rate == 0)
+    {
+        return 0;
+    }
+    if (rate >= 1000)
+    {
+        return 1;
+    }
+    
+    return (a_fault_random() < rate) ? 1 : 0;
+}
+
+/**
+ * @brief     fault interface set the fault rates
+ * @param[in] *fault pointer to a fault structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      it also clears the fault counters and the stashed rx data
+ */
+uint8_t ch9120_fault_interface_set(const ch9120_fault_t *fault)
+{
+    if (fault == NULL)
+    {
+        return 1;
+    }
+    
+    gs_fault = *fault;
+    gs_random = (fault->seed != 0) ? fault->seed : 1;
+    memset(&gs_count, 0, sizeof(ch9120_fault_count_t));
+    gs_stash_len = 0;
+    gs_hold_ms = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief      fault interface get the fault counters
+ * @param[out] *count pointer to a fault count structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ * @note       none
+ */
+uint8_t ch9120_fault_interface_get_count(ch9120_fault_count_t *count)
+{
+    if (count == NULL)
+    {
+        return 1;
+    }
+    
+    *count = gs_count;
+    
+    return 0;
+}
+
+/**
+ * @brief      fault interface uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       wraps ch9120_interface_uart_read
+ */
+uint16_t ch9120_fault_interface_uart_read(uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    uint16_t l;
+    uint16_t out;
+    
+    /* fill the stash from the lower link */
+    if (gs_stash_len < CH9120_FAULT_INTERFACE_STASH_LEN)
+    {
+        uint8_t tmp[CH9120_FAULT_INTERFACE_STASH_LEN];
+        uint8_t fresh;
+        
+        fresh = (gs_stash_len == 0) ? 1 : 0;
+        l = ch9120_interface_uart_read(tmp, CH9120_FAULT_INTERFACE_STASH_LEN - gs_stash_len);
+        for (i = 0; i < l; i++)
+        {
+            /* drop the byte */
+            if (a_fault_hit(gs_fault.drop_rate) != 0)
+            {
+                gs_count.dropped++;
+                
+                continue;
+            }
+            
+            /* corrupt the byte */
+            if (a_fault_hit(gs_fault.corrupt_rate) != 0)
+            {
+                tmp[i] = (uint8_t)(~tmp[i]);
+                gs_count.corrupted++;
+            }
+            gs_stash[gs_stash_len] = tmp[i];
+            gs_stash_len++;
+        }
+        
+        /* delay a new response */
+        if ((fresh != 0) && (gs_stash_len != 0) && (a_fault_hit(gs_fault.delay_rate) != 0))
+        {
+            gs_hold_ms = gs_fault.delay_ms;
+            gs_count.delayed++;
+        }
+    }
+    
+    /* the response is not released yet */
+    if ((gs_stash_len == 0) || (gs_hold_ms != 0) || (len == 0))
+    {
+        return 0;
+    }
+    
+    /* return only a part of the data */
+    out = (len < gs_stash_len) ? len : gs_stash_len;
+    if ((out > 1) && (a_fault_hit(gs_fault.partial_rate) != 0))
+    {
+        out = 1 + (uint16_t)(a_fault_random() % (out - 1));
+        gs_count.partial++;
+    }
+    memcpy(buf, gs_stash, out);
+    memmove(gs_stash, &gs_stash[out], gs_stash_len - out);
+    gs_stash_len -= out;
+    
+    return out;
+}
+
+/**
+ * @brief  fault interface uart flush
+ * @return status code
+ *         - 0 success
+ *         - 1 uart flush failed
+ * @note   wraps ch9120_interface_uart_flush
+ */
+uint8_t ch9120_fault_interface_uart_flush(void)
+{
+    gs_stash_len = 0;
+    gs_hold_ms = 0;
+    
+    return ch9120_interface_uart_flush();
+}
+
+/**
+ * @brief     fault interface uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      wraps ch9120_interface_uart_write
+ */
+uint8_t ch9120_fault_interface_uart_write(uint8_t *buf, uint16_t len)
+{
+    if (a_fault_hit(gs_fault.write_fail_rate) != 0)
+    {
+        gs_count.write_failed++;
+        
+        return 1;
+    }
+    
+    return ch9120_interface_uart_write(buf, len);
+}
+
+/**
+ * @brief     fault interface delay ms
+ * @param[in] ms time
+ * @note      wraps ch9120_interface_delay_ms
+ */
+void ch9120_fault_interface_delay_ms(uint32_t ms)
+{
+    /* count down the delayed response */
+    gs_hold_ms = (gs_hold_ms > ms) ? (gs_hold_ms - ms) : 0;
+    
+    ch9120_interface_delay_ms(ms);
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_fault_interface.h
+ * @brief     driver ch9120 fault interface header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef DRIVER_CH9120_FAULT_INTERFACE_H
+#define DRIVER_CH9120_FAULT_INTERFACE_H
+
+#include "driver_ch9120_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup ch9120_test_driver
+ * @{
+ */
+
+/**
+ * @brief ch9120 fault interface stash length definition
+ */
+#ifndef CH9120_FAULT_INTERFACE_STASH_LEN
+    #define CH9120_FAULT_INTERFACE_STASH_LEN    256        /**< 256 bytes */
+#endif
+
+/**
+ * @brief ch9120 fault structure definition
+ */
+typedef struct ch9120_fault_s
+{
+    uint16_t drop_rate;              /**< dropped rx byte rate in 1/1000 */
+    uint16_t corrupt_rate;           /**< corrupted rx byte rate in 1/1000 */
+    uint16_t delay_rate;             /**< delayed response rate in 1/1000 */
+    uint16_t delay_ms;               /**< delayed response time in ms */
+    uint16_t partial_rate;           /**< partial read rate in 1/1000 */
+    uint16_t write_fail_rate;        /**< write failure rate in 1/1000 */
+    uint32_t seed;                   /**< random seed */
+} ch9120_fault_t;
+
+/**
+ * @brief ch9120 fault count structure definition
+ */
+typedef struct ch9120_fault_count_s
+{
+    uint32_t dropped;                /**< dropped bytes */
+    uint32_t corrupted;              /**< corrupted bytes */
+    uint32_t delayed;                /**< delayed responses */
+    uint32_t partial;                /**< partial reads */
+    uint32_t write_failed;           /**< failed writes */
+} ch9120_fault_count_t;
+
+/**
+ * @brief     fault interface set the fault rates
+ * @param[in] *fault pointer to a fault structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set failed
+ * @note      it also clears the fault counters and the stashed rx data
+ */
+uint8_t ch9120_fault_interface_set(const ch9120_fault_t *fault);
+
+/**
+ * @brief      fault interface get the fault counters
+ * @param[out] *count pointer to a fault count structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ * @note       none
+ */
+uint8_t ch9120_fault_interface_get_count(ch9120_fault_count_t *count);
+
+/**
+ * @brief      fault interface uart read
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     length of the read data
+ * @note       wraps ch9120_interface_uart_read
+ */
+uint16_t ch9120_fault_interface_uart_read(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief  fault interface uart flush
+ * @return status code
+ *         - 0 success
+ *         - 1 uart flush failed
+ * @note   wraps ch9120_interface_uart_flush
+ */
+uint8_t ch9120_fault_interface_uart_flush(void);
+
+/**
+ * @brief     fault interface uart write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      wraps ch9120_interface_uart_write
+ */
+uint8_t ch9120_fault_interface_uart_write(uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     fault interface delay ms
+ * @param[in] ms time
+ * @note      wraps ch9120_interface_delay_ms
+ */
+void ch9120_fault_interface_delay_ms(uint32_t ms);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,548 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_fault_test.c
+ * @brief     driver ch9120 fault test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_fault_test.h"
+
+/**
+ * @brief fault test expect definition
+ */
+#define CH9120_FAULT_EXPECT_OK      (1 << 0)        /**< status 0 is allowed */
+#define CH9120_FAULT_EXPECT_FAIL    (1 << 1)        /**< status 1 is allowed */
+
+/**
+ * @brief fault test command structure definition
+ */
+typedef struct ch9120_fault_cmd_s
+{
+    const char *name;           /**< function name */
+    uint8_t check;              /**< 1 if the command is acknowledged with 0xAA */
+    uint16_t extra_ms;          /**< extra time after a successful command */
+} ch9120_fault_cmd_t;
+
+/**
+ * @brief fault test command table
+ */
+static const ch9120_fault_cmd_t gs_cmd[] =
+{
+    {"ch9120_get_version", 0, 0},
+    {"ch9120_get_status", 0, 0},
+    {"ch9120_get_mode", 0, 0},
+    {"ch9120_get_ip", 0, 0},
+    {"ch9120_get_subnet_mask", 0, 0},
+    {"ch9120_get_gateway", 0, 0},
+    {"ch9120_get_source_port", 0, 0},
+    {"ch9120_get_dest_ip", 0, 0},
+    {"ch9120_get_dest_port", 0, 0},
+    {"ch9120_get_uart_baud", 0, 0},
+    {"ch9120_get_uart_config", 0, 0},
+    {"ch9120_get_uart_timeout", 0, 0},
+    {"ch9120_get_uart_buffer_length", 0, 0},
+    {"ch9120_get_uart_flush", 0, 0},
+    {"ch9120_get_disconnect_with_no_rj45", 0, 0},
+    {"ch9120_set_mode", 1, 0},
+    {"ch9120_set_ip", 1, 0},
+    {"ch9120_set_subnet_mask", 1, 0},
+    {"ch9120_set_gateway", 1, 0},
+    {"ch9120_set_source_port", 1, 0},
+    {"ch9120_set_dest_ip", 1, 0},
+    {"ch9120_set_dest_port", 1, 0},
+    {"ch9120_set_uart_baud", 1, 0},
+    {"ch9120_set_uart_config", 1, 0},
+    {"ch9120_set_uart_timeout", 1, 0},
+    {"ch9120_set_source_port_random", 1, 0},
+    {"ch9120_set_uart_buffer_length", 1, 0},
+    {"ch9120_set_uart_flush", 1, 0},
+    {"ch9120_set_disconnect_with_no_rj45", 1, 0},
+    {"ch9120_set_dhcp", 1, 0},
+    {"ch9120_exit", 1, 0},
+    {"ch9120_reset", 1, 1000},
+};
+
+static ch9120_handle_t gs_handle;            /**< ch9120 handle */
+static ch9120_mode_t gs_mode;                /**< chip mode */
+static uint8_t gs_ip[4];                     /**< ip */
+static uint8_t gs_mask[4];                   /**< subnet mask */
+static uint8_t gs_gateway[4];                /**< gateway */
+static uint16_t gs_source_port;              /**< source port */
+static uint8_t gs_dest_ip[4];                /**< dest ip */
+static uint16_t gs_dest_port;                /**< dest port */
+static uint32_t gs_baud;                     /**< uart baud */
+static uint8_t gs_data_bit;                  /**< uart data bit */
+static ch9120_parity_t gs_parity;            /**< uart parity */
+static uint8_t gs_stop_bit;                  /**< uart stop bit */
+static uint8_t gs_timeout;                   /**< uart timeout */
+static uint32_t gs_len;                      /**< uart buffer length */
+static ch9120_bool_t gs_flush;               /**< uart flush */
+static ch9120_bool_t gs_rj45;                /**< disconnect with no rj45 */
+
+/**
+ * @brief  fault test snapshot the current config
+ * @return status code
+ *         - 0 success
+ *         - 1 snapshot failed
+ * @note   setters in the test write back the snapshot so the chip config is not changed
+ */
+static uint8_t a_fault_snapshot(void)
+{
+    if (ch9120_get_mode(&gs_handle, &gs_mode) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_ip(&gs_handle, gs_ip) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_subnet_mask(&gs_handle, gs_mask) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_gateway(&gs_handle, gs_gateway) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_source_port(&gs_handle, &gs_source_port) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_dest_ip(&gs_handle, gs_dest_ip) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_dest_port(&gs_handle, &gs_dest_port) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_uart_baud(&gs_handle, &gs_baud) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_uart_config(&gs_handle, &gs_data_bit, &gs_parity, &gs_stop_bit) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_uart_timeout(&gs_handle, &gs_timeout) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_uart_buffer_length(&gs_handle, &gs_len) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_uart_flush(&gs_handle, &gs_flush) != 0)
+    {
+        return 1;
+    }
+    if (ch9120_get_disconnect_with_no_rj45(&gs_handle, &gs_rj45) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     fault test call a command
+ * @param[in] index command index
+ * @return    status code of the command
+ * @note      none
+ */
+static uint8_t a_fault_call(uint8_t index)
+{
+    uint8_t version;
+    uint8_t buf[4];
+    uint8_t data_bit;
+    uint8_t stop_bit;
+    uint16_t num;
+    uint32_t value;
+    ch9120_status_t status;
+    ch9120_mode_t mode;
+    ch9120_parity_t parity;
+    ch9120_bool_t enable;
+    
+    switch (index)
+    {
+        case 0 : return ch9120_get_version(&gs_handle, &version);
+        case 1 : return ch9120_get_status(&gs_handle, &status);
+        case 2 : return ch9120_get_mode(&gs_handle, &mode);
+        case 3 : return ch9120_get_ip(&gs_handle, buf);
+        case 4 : return ch9120_get_subnet_mask(&gs_handle, buf);
+        case 5 : return ch9120_get_gateway(&gs_handle, buf);
+        case 6 : return ch9120_get_source_port(&gs_handle, &num);
+        case 7 : return ch9120_get_dest_ip(&gs_handle, buf);
+        case 8 : return ch9120_get_dest_port(&gs_handle, &num);
+        case 9 : return ch9120_get_uart_baud(&gs_handle, &value);
+        case 10 : return ch9120_get_uart_config(&gs_handle, &data_bit, &parity, &stop_bit);
+        case 11 : return ch9120_get_uart_timeout(&gs_handle, buf);
+        case 12 : return ch9120_get_uart_buffer_length(&gs_handle, &value);
+        case 13 : return ch9120_get_uart_flush(&gs_handle, &enable);
+        case 14 : return ch9120_get_disconnect_with_no_rj45(&gs_handle, &enable);
+        case 15 : return ch9120_set_mode(&gs_handle, gs_mode);
+        case 16 : return ch9120_set_ip(&gs_handle, gs_ip);
+        case 17 : return ch9120_set_subnet_mask(&gs_handle, gs_mask);
+        case 18 : return ch9120_set_gateway(&gs_handle, gs_gateway);
+        case 19 : return ch9120_set_source_port(&gs_handle, gs_source_port);
+        case 20 : return ch9120_set_dest_ip(&gs_handle, gs_dest_ip);
+        case 21 : return ch9120_set_dest_port(&gs_handle, gs_dest_port);
+        case 22 : return ch9120_set_uart_baud(&gs_handle, gs_baud);
+        case 23 : return ch9120_set_uart_config(&gs_handle, gs_data_bit, gs_parity, gs_stop_bit);
+        case 24 : return ch9120_set_uart_timeout(&gs_handle, gs_timeout);
+        case 25 : return ch9120_set_source_port_random(&gs_handle, CH9120_BOOL_FALSE);
+        case 26 : return ch9120_set_uart_buffer_length(&gs_handle, gs_len);
+        case 27 : return ch9120_set_uart_flush(&gs_handle, gs_flush);
+        case 28 : return ch9120_set_disconnect_with_no_rj45(&gs_handle, gs_rj45);
+        case 29 : return ch9120_set_dhcp(&gs_handle, CH9120_BOOL_FALSE);
+        case 30 : return ch9120_exit(&gs_handle);
+        case 31 : return ch9120_reset(&gs_handle);
+        default : return 0xFF;
+    }
+}
+
+/**
+ * @brief     fault test run all commands with a fault
+ * @param[in] *name pointer to a mode name
+ * @param[in] *fault pointer to a fault structure
+ * @param[in] check_expect allowed status of the acknowledged commands
+ * @param[in] read_expect allowed status of the read back commands
+ * @param[in] rounds run times
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      each command must return an allowed status within its timeout bound
+ */
+static uint8_t a_fault_run(const char *name, const ch9120_fault_t *fault,
+                           uint8_t check_expect, uint8_t read_expect, uint8_t rounds)
+{
+    uint8_t i;
+    uint8_t r;
+    uint8_t res;
+    uint8_t expect;
+    uint8_t version;
+    uint32_t ms;
+    uint32_t bound;
+    uint64_t start;
+    ch9120_fault_t none;
+    ch9120_fault_count_t count;
+    
+    ch9120_interface_debug_print("ch9120: %s fault test.\n", name);
+    
+    /* set fault */
+    (void)ch9120_fault_interface_set(fault);
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < sizeof(gs_cmd) / sizeof(gs_cmd[0]); i++)
+        {
+            start = ch9120_interface_timestamp_us();
+            res = a_fault_call(i);
+            ms = (uint32_t)((ch9120_interface_timestamp_us() - start) / 1000);
+            expect = (gs_cmd[i].check != 0) ? check_expect : read_expect;
+            if ((res > 1) || (((1 << res) & expect) == 0))
+            {
+                ch9120_interface_debug_print("ch9120: %s returned %d.\n", gs_cmd[i].name, res);
+                
+                return 1;
+            }
+            
+            /* command pre delay + timeout */
+            bound = CH9120_UART_PRE_DELAY + 1000 + CH9120_FAULT_TEST_SLACK_MS;
+            if (res == 0)
+            {
+                bound += gs_cmd[i].extra_ms;
+            }
+            if (ms > bound)
+            {
+                ch9120_interface_debug_print("ch9120: %s took %dms, bound is %dms.\n", gs_cmd[i].name, ms, bound);
+                
+                return 1;
+            }
+        }
+    }
+    (void)ch9120_fault_interface_get_count(&count);
+    ch9120_interface_debug_print("ch9120: dropped %d, corrupted %d, delayed %d, partial %d, write failed %d.\n",
+                                 count.dropped, count.corrupted, count.delayed, count.partial, count.write_failed);
+    
+    /* clear fault and wait for the chip */
+    memset(&none, 0, sizeof(ch9120_fault_t));
+    (void)ch9120_fault_interface_set(&none);
+    ch9120_interface_delay_ms(1000);
+    
+    /* the chip must answer again */
+    res = ch9120_get_version(&gs_handle, &version);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: recover failed.\n");
+        
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check %s fault %s.\n", name, "ok");
+    
+    return 0;
+}
+
+/**
+ * @brief  fault test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   none
+ */
+uint8_t ch9120_fault_test(void)
+{
+    uint8_t res;
+    uint8_t version;
+    ch9120_info_t info;
+    ch9120_fault_t fault;
+    ch9120_handle_t handle;
+    
+    /* no fault */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    (void)ch9120_fault_interface_set(&fault);
+    
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_fault_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_fault_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_fault_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_fault_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    
+    /* get ch9120 information */
+    res = ch9120_info(&info);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get info failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        /* print chip information */
+        ch9120_interface_debug_print("ch9120: chip is %s.\n", info.chip_name);
+        ch9120_interface_debug_print("ch9120: manufacturer is %s.\n", info.manufacturer_name);
+        ch9120_interface_debug_print("ch9120: interface is %s.\n", info.interface);
+        ch9120_interface_debug_print("ch9120: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        ch9120_interface_debug_print("ch9120: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        ch9120_interface_debug_print("ch9120: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        ch9120_interface_debug_print("ch9120: max current is %0.2fmA.\n", info.max_current_ma);
+        ch9120_interface_debug_print("ch9120: max temperature is %0.1fC.\n", info.temperature_max);
+        ch9120_interface_debug_print("ch9120: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+    
+    /* start fault test */
+    ch9120_interface_debug_print("ch9120: start fault test.\n");
+    
+    /* handle test */
+    ch9120_interface_debug_print("ch9120: handle test.\n");
+    
+    /* null handle */
+    if (ch9120_get_version(NULL, &version) != 2)
+    {
+        ch9120_interface_debug_print("ch9120: null handle is not rejected.\n");
+        
+        return 1;
+    }
+    
+    /* not initialized handle */
+    if (ch9120_get_version(&gs_handle, &version) != 3)
+    {
+        ch9120_interface_debug_print("ch9120: not initialized handle is not rejected.\n");
+        
+        return 1;
+    }
+    
+    /* missing linked function */
+    handle = gs_handle;
+    handle.uart_read = NULL;
+    if (ch9120_init(&handle) != 3)
+    {
+        ch9120_interface_debug_print("ch9120: missing linked function is not rejected.\n");
+        
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check handle %s.\n", "ok");
+    
+    /* silent chip */
+    fault.drop_rate = 1000;
+    (void)ch9120_fault_interface_set(&fault);
+    res = ch9120_init(&gs_handle);
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    (void)ch9120_fault_interface_set(&fault);
+    if (res != 7)
+    {
+        ch9120_interface_debug_print("ch9120: silent chip init returned %d.\n", res);
+        
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check not ready %s.\n", "ok");
+    
+    /* ch9120 init */
+    res = ch9120_init(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* snapshot the config */
+    res = a_fault_snapshot();
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: snapshot failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* write fail */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.write_fail_rate = 1000;
+    res = a_fault_run("write fail", &fault, CH9120_FAULT_EXPECT_FAIL, CH9120_FAULT_EXPECT_FAIL, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* drop */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.drop_rate = 1000;
+    res = a_fault_run("drop", &fault, CH9120_FAULT_EXPECT_FAIL, CH9120_FAULT_EXPECT_FAIL, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* corrupt */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.corrupt_rate = 1000;
+    res = a_fault_run("corrupt", &fault, CH9120_FAULT_EXPECT_FAIL,
+                      CH9120_FAULT_EXPECT_OK | CH9120_FAULT_EXPECT_FAIL, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* short delay */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.delay_rate = 1000;
+    fault.delay_ms = 300;
+    res = a_fault_run("short delay", &fault, CH9120_FAULT_EXPECT_OK, CH9120_FAULT_EXPECT_OK, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* long delay */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.delay_rate = 1000;
+    fault.delay_ms = 1500;
+    res = a_fault_run("long delay", &fault, CH9120_FAULT_EXPECT_FAIL, CH9120_FAULT_EXPECT_FAIL, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* partial */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.partial_rate = 1000;
+    res = a_fault_run("partial", &fault, CH9120_FAULT_EXPECT_OK, CH9120_FAULT_EXPECT_OK, 1);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* mixed */
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.drop_rate = 20;
+    fault.corrupt_rate = 20;
+    fault.delay_rate = 100;
+    fault.delay_ms = 200;
+    fault.partial_rate = 300;
+    fault.write_fail_rate = 20;
+    fault.seed = 0x9120;
+    res = a_fault_run("mixed", &fault, CH9120_FAULT_EXPECT_OK | CH9120_FAULT_EXPECT_FAIL,
+                      CH9120_FAULT_EXPECT_OK | CH9120_FAULT_EXPECT_FAIL, 3);
+    if (res != 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* deinit with a failed write */
+    ch9120_interface_debug_print("ch9120: deinit fault test.\n");
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    fault.write_fail_rate = 1000;
+    (void)ch9120_fault_interface_set(&fault);
+    res = ch9120_deinit(&gs_handle);
+    if (res != 4)
+    {
+        ch9120_interface_debug_print("ch9120: deinit returned %d.\n", res);
+        
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check deinit fault %s.\n", "ok");
+    
+    /* finish fault test */
+    ch9120_interface_debug_print("ch9120: finish fault test.\n");
+    memset(&fault, 0, sizeof(ch9120_fault_t));
+    (void)ch9120_fault_interface_set(&fault);
+    (void)ch9120_deinit(&gs_handle);
+    
+    return 0;
+}
@@ -0,0 +1,420 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_frame_test.c
+ * @brief     driver ch9120 frame test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_frame_test.h"
+
+static ch9120_handle_t gs_handle;                                    /**< ch9120 handle */
+static uint8_t gs_frame[256];                                        /**< frame decode buffer */
+static uint8_t gs_zip[256];                                          /**< frame compress buffer */
+static uint8_t gs_data[64];                                          /**< sent data */
+static uint8_t gs_out[128];                                          /**< received data */
+static uint8_t gs_raw[128];                                          /**< encoded frame */
+static const char *const gs_type_name[2] = {"slip", "cobs"};         /**< frame type name */
+static const char *const gs_crc_name[3] = {"no crc", "crc-16", "crc-32"};    /**< frame crc name */
+
+/**
+ * @brief         frame test wait for a frame
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[in]     timeout timeout in ms
+ * @return        status code
+ *                - 0 success
+ *                - 1 recv failed
+ * @note          len is 0 when no frame has arrived in time
+ */
+static uint8_t a_frame_test_recv(uint8_t *buf, uint16_t *len, uint32_t timeout)
+{
+    uint16_t l;
+    
+    while (1)
+    {
+        l = *len;
+        if (ch9120_recv_frame(&gs_handle, buf, &l) != 0)
+        {
+            return 1;
+        }
+        if ((l != 0) || (timeout == 0))
+        {
+            *len = l;
+            
+            return 0;
+        }
+        ch9120_interface_delay_ms(1);
+        timeout--;
+    }
+}
+
+/**
+ * @brief         frame test read an encoded frame
+ * @param[in]     type frame type
+ * @param[out]    *buf pointer to a data buffer
+ * @param[in,out] *len pointer to a length buffer
+ * @param[in]     timeout timeout in ms
+ * @return        status code
+ *                - 0 success
+ *                - 1 read failed
+ * @note          the bytes are read up to the closing delimiter, a slip frame also opens with one
+ */
+static uint8_t a_frame_test_read_raw(ch9120_frame_t type, uint8_t *buf, uint16_t *len, uint32_t timeout)
+{
+    uint8_t end;
+    uint16_t n;
+    uint16_t l;
+    
+    end = (type == CH9120_FRAME_COBS) ? 0x00 : 0xC0;
+    n = 0;
+    while ((timeout != 0) && (n < *len))
+    {
+        l = 1;
+        if (ch9120_read(&gs_handle, &buf[n], &l) != 0)
+        {
+            return 1;
+        }
+        if (l == 0)
+        {
+            ch9120_interface_delay_ms(1);
+            timeout--;
+            
+            continue;
+        }
+        n++;
+        if ((buf[n - 1] == end) && ((type == CH9120_FRAME_COBS) || (n > 1)))
+        {
+            *len = n;
+            
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief  frame test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the chip must be connected to a peer that sends every byte back,
+ *         cobs and slip frames are sent with every crc with and without the compression
+ */
+uint8_t ch9120_frame_test(void)
+{
+    uint8_t res;
+    uint8_t type;
+    uint8_t crc;
+    uint8_t zip;
+    uint8_t j;
+    uint16_t i;
+    uint16_t len;
+    uint16_t l;
+    uint32_t count;
+    uint32_t count_check;
+    ch9120_info_t info;
+
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+
+    /* get ch9120 information */
+    res = ch9120_info(&info);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get info failed.\n");
+
+        return 1;
+    }
+    else
+    {
+        /* print chip information */
+        ch9120_interface_debug_print("ch9120: chip is %s.\n", info.chip_name);
+        ch9120_interface_debug_print("ch9120: manufacturer is %s.\n", info.manufacturer_name);
+        ch9120_interface_debug_print("ch9120: interface is %s.\n", info.interface);
+        ch9120_interface_debug_print("ch9120: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        ch9120_interface_debug_print("ch9120: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        ch9120_interface_debug_print("ch9120: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        ch9120_interface_debug_print("ch9120: max current is %0.2fmA.\n", info.max_current_ma);
+        ch9120_interface_debug_print("ch9120: max temperature is %0.1fC.\n", info.temperature_max);
+        ch9120_interface_debug_print("ch9120: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+
+    /* start frame test */
+    ch9120_interface_debug_print("ch9120: start frame test.\n");
+
+    /* ch9120 init */
+    res = ch9120_init(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: init failed.\n");
+
+        return 1;
+    }
+
+    /* repeated text with delimiters and escapes */
+    for (i = 0; i < 64; i++)
+    {
+        gs_data[i] = (uint8_t)("LibDriver"[i % 9]);
+    }
+    gs_data[9] = 0x00;
+    gs_data[20] = 0xC0;
+    gs_data[21] = 0xDB;
+    gs_data[40] = 0x00;
+    gs_data[63] = 0x00;
+
+    /* round trip every frame type, crc and compression */
+    for (type = 0; type < 2; type++)
+    {
+        for (crc = 0; crc < 3; crc++)
+        {
+            for (zip = 0; zip < 2; zip++)
+            {
+                res = ch9120_set_frame(&gs_handle, (ch9120_frame_t)type, gs_frame, 256);
+                if (res != 0)
+                {
+                    ch9120_interface_debug_print("ch9120: set frame failed.\n");
+                    (void)ch9120_deinit(&gs_handle);
+
+                    return 1;
+                }
+                res = ch9120_set_frame_crc(&gs_handle, (ch9120_frame_crc_t)crc);
+                if (res != 0)
+                {
+                    ch9120_interface_debug_print("ch9120: set frame crc failed.\n");
+                    (void)ch9120_deinit(&gs_handle);
+
+                    return 1;
+                }
+                res = ch9120_set_frame_compress(&gs_handle, (ch9120_bool_t)zip, 
+                                                (zip != 0) ? gs_zip : NULL, (zip != 0) ? 256 : 0);
+                if (res != 0)
+                {
+                    ch9120_interface_debug_print("ch9120: set frame compress failed.\n");
+                    (void)ch9120_deinit(&gs_handle);
+
+                    return 1;
+                }
+
+                /* the short text and the long data */
+                for (j = 0; j < 2; j++)
+                {
+                    len = (j == 0) ? 9 : 64;
+                    res = ch9120_send_frame(&gs_handle, gs_data, len);
+                    if (res != 0)
+                    {
+                        ch9120_interface_debug_print("ch9120: send frame failed.\n");
+                        (void)ch9120_deinit(&gs_handle);
+
+                        return 1;
+                    }
+                    l = 128;
+                    res = a_frame_test_recv(gs_out, &l, 1000);
+                    if (res != 0)
+                    {
+                        ch9120_interface_debug_print("ch9120: recv frame failed.\n");
+                        (void)ch9120_deinit(&gs_handle);
+
+                        return 1;
+                    }
+                    if ((l != len) || (memcmp(gs_out, gs_data, len) != 0))
+                    {
+                        ch9120_interface_debug_print("ch9120: check %s %s %s round trip error, %d bytes received.\n",
+                                                     gs_type_name[type], gs_crc_name[crc],
+                                                     (zip != 0) ? "zip" : "raw", l);
+                        (void)ch9120_deinit(&gs_handle);
+
+                        return 1;
+                    }
+                }
+                ch9120_interface_debug_print("ch9120: check %s %s %s round trip ok.\n",
+                                             gs_type_name[type], gs_crc_name[crc],
+                                             (zip != 0) ? "zip" : "raw");
+            }
+        }
+    }
+
+    /* a flipped byte must be rejected by the crc */
+    for (type = 0; type < 2; type++)
+    {
+        for (crc = 1; crc < 3; crc++)
+        {
+            res = ch9120_set_frame(&gs_handle, (ch9120_frame_t)type, gs_frame, 256);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: set frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            res = ch9120_set_frame_crc(&gs_handle, (ch9120_frame_crc_t)crc);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: set frame crc failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            res = ch9120_set_frame_compress(&gs_handle, CH9120_BOOL_FALSE, NULL, 0);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: set frame compress failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            res = ch9120_get_frame_errors(&gs_handle, &count);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: get frame errors failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+
+            /* get the encoded frame back */
+            res = ch9120_send_frame(&gs_handle, gs_data, 9);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: send frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            len = 128;
+            res = a_frame_test_read_raw((ch9120_frame_t)type, gs_raw, &len, 1000);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: read frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+
+            /* flip a data bit and send the frame again */
+            i = 0;
+            while ((i < len) && (gs_raw[i] != 'L'))
+            {
+                i++;
+            }
+            if (i == len)
+            {
+                ch9120_interface_debug_print("ch9120: data is not in the frame.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            gs_raw[i] ^= 0x01;
+            res = ch9120_write(&gs_handle, gs_raw, len);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: write failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            l = 128;
+            res = a_frame_test_recv(gs_out, &l, 500);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: recv frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            res = ch9120_get_frame_errors(&gs_handle, &count_check);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: get frame errors failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            ch9120_interface_debug_print("ch9120: check %s %s flipped byte %s.\n", gs_type_name[type], gs_crc_name[crc],
+                                         ((l == 0) && (count_check == count + 1)) ? "ok" : "error");
+            if ((l != 0) || (count_check != count + 1))
+            {
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+
+            /* the next frame is still received */
+            res = ch9120_send_frame(&gs_handle, gs_data, 9);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: send frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            l = 128;
+            res = a_frame_test_recv(gs_out, &l, 1000);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: recv frame failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+            ch9120_interface_debug_print("ch9120: check %s %s resync %s.\n", gs_type_name[type], gs_crc_name[crc],
+                                         ((l == 9) && (memcmp(gs_out, gs_data, 9) == 0)) ? "ok" : "error");
+            if ((l != 9) || (memcmp(gs_out, gs_data, 9) != 0))
+            {
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+        }
+    }
+
+    /* finish frame test */
+    ch9120_interface_debug_print("ch9120: finish frame test.\n");
+    (void)ch9120_deinit(&gs_handle);
+
+    return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_ch9120_monitor_test.c
+ * @brief     driver ch9120 monitor test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_ch9120_monitor_test.h"
+
+static ch9120_handle_t gs_handle;        /**< ch9120 handle */
+static uint32_t gs_events;               /**< link event number */
+
+/**
+ * @brief     link event callback
+ * @param[in] type link status
+ * @note      none
+ */
+static void a_ch9120_monitor_callback(uint8_t type)
+{
+    gs_events++;
+    if (type == CH9120_STATUS_CONNECT)
+    {
+        ch9120_interface_debug_print("ch9120: link connect at %d ms.\n",
+                                     (uint32_t)(ch9120_interface_timestamp_us() / 1000));
+    }
+    else
+    {
+        ch9120_interface_debug_print("ch9120: link disconnect at %d ms.\n",
+                                     (uint32_t)(ch9120_interface_timestamp_us() / 1000));
+    }
+}
+
+/**
+ * @brief     monitor test
+ * @param[in] second test time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      plug or unplug the rj45 cable while the test is running, then send data from the
+ *            peer, the data is held unread over the polls and must be read after them
+ */
+uint8_t ch9120_monitor_test(uint32_t second)
+{
+    uint8_t res;
+    uint32_t i;
+    uint32_t failed;
+    uint16_t len;
+    uint8_t buf[64];
+    ch9120_info_t info;
+
+    /* link interface function */
+    DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
+    DRIVER_CH9120_LINK_UART_INIT(&gs_handle, ch9120_interface_uart_init);
+    DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
+    DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
+    DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
+    DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
+    DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
+    DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
+    DRIVER_CH9120_LINK_RESET_GPIO_WRITE(&gs_handle, ch9120_interface_reset_gpio_write);
+    DRIVER_CH9120_LINK_CFG_GPIO_INIT(&gs_handle, ch9120_interface_cfg_gpio_init);
+    DRIVER_CH9120_LINK_CFG_GPIO_DEINIT(&gs_handle, ch9120_interface_cfg_gpio_deinit);
+    DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
+    DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
+    DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_RECEIVE_CALLBACK(&gs_handle, a_ch9120_monitor_callback);
+
+    /* get ch9120 information */
+    res = ch9120_info(&info);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get info failed.\n");
+
+        return 1;
+    }
+    else
+    {
+        /* print chip information */
+        ch9120_interface_debug_print("ch9120: chip is %s.\n", info.chip_name);
+        ch9120_interface_debug_print("ch9120: manufacturer is %s.\n", info.manufacturer_name);
+        ch9120_interface_debug_print("ch9120: interface is %s.\n", info.interface);
+        ch9120_interface_debug_print("ch9120: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        ch9120_interface_debug_print("ch9120: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        ch9120_interface_debug_print("ch9120: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        ch9120_interface_debug_print("ch9120: max current is %0.2fmA.\n", info.max_current_ma);
+        ch9120_interface_debug_print("ch9120: max temperature is %0.1fC.\n", info.temperature_max);
+        ch9120_interface_debug_print("ch9120: min temperature is %0.1fC.\n", info.temperature_min);
+    }
+
+    /* start monitor test */
+    ch9120_interface_debug_print("ch9120: start monitor test.\n");
+
+    /* ch9120 init */
+    res = ch9120_init(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: init failed.\n");
+
+        return 1;
+    }
+
+    /* enable monitor */
+    gs_events = 0;
+    res = ch9120_set_monitor(&gs_handle, CH9120_BOOL_TRUE);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set monitor failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* write data every 100ms and run the handler every 10ms */
+    failed = 0;
+    for (i = 0; i < second * 100; i++)
+    {
+        if ((i % 10) == 0)
+        {
+            res = ch9120_write(&gs_handle, (uint8_t *)"LibDriver", 9);
+            if (res != 0)
+            {
+                ch9120_interface_debug_print("ch9120: write failed.\n");
+                (void)ch9120_deinit(&gs_handle);
+
+                return 1;
+            }
+        }
+        res = ch9120_monitor_handler(&gs_handle);
+        if (res == 1)
+        {
+            failed++;
+        }
+        else if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: monitor handler failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        ch9120_interface_delay_ms(10);
+    }
+
+    /* output */
+    ch9120_interface_debug_print("ch9120: %d link events and %d failed polls.\n", gs_events, failed);
+    if (gs_events == 0)
+    {
+        ch9120_interface_debug_print("ch9120: no link event.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* hold the received data and run the handler every 10ms */
+    ch9120_interface_debug_print("ch9120: hold the received data for %d ms.\n", CH9120_MONITOR_SLOW_MS);
+    for (i = 0; i < CH9120_MONITOR_SLOW_MS / 10; i++)
+    {
+        res = ch9120_monitor_handler(&gs_handle);
+        if (res == 1)
+        {
+            failed++;
+        }
+        else if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: monitor handler failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        ch9120_interface_delay_ms(10);
+    }
+
+    /* read the held data */
+    memset(buf, 0, sizeof(uint8_t) * 64);
+    len = 63;
+    res = ch9120_read(&gs_handle, buf, &len);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: read failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: read %d bytes %s.\n", len, (char *)buf);
+    if (len == 0)
+    {
+        ch9120_interface_debug_print("ch9120: held data is lost.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* finish monitor test */
+    ch9120_interface_debug_print("ch9120: finish monitor test.\n");
+    (void)ch9120_deinit(&gs_handle);
+
+    return 0;
+}
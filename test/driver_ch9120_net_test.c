@@ -64,6 +64,8 @@ uint8_t ch9120_net_test(ch9120_mode_t mode, uint32_t timeout)
     DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
     DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
     DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
     DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
     DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
     DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
@@ -73,6 +75,16 @@ uint8_t ch9120_net_test(ch9120_mode_t mode, uint32_t timeout)
     DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
     DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
     DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_STORAGE_READ(&gs_handle, ch9120_interface_storage_read);
+    DRIVER_CH9120_LINK_STORAGE_WRITE(&gs_handle, ch9120_interface_storage_write);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+    DRIVER_CH9120_LINK_MUTEX_INIT(&gs_handle, ch9120_interface_mutex_init);
+    DRIVER_CH9120_LINK_MUTEX_DEINIT(&gs_handle, ch9120_interface_mutex_deinit);
+    DRIVER_CH9120_LINK_MUTEX_LOCK(&gs_handle, ch9120_interface_mutex_lock);
+    DRIVER_CH9120_LINK_MUTEX_UNLOCK(&gs_handle, ch9120_interface_mutex_unlock);
 
     /* get ch9120 information */
     res = ch9120_info(&info);
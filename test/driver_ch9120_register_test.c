@@ -38,6 +38,11 @@
 #include <stdlib.h>
 
 static ch9120_handle_t gs_handle;        /**< ch9120 handle */
+static uint8_t gs_coalesce[64];          /**< coalesce buffer */
+static ch9120_autotune_sample_t gs_sample[4];    /**< auto tune sample buffer */
+static uint8_t gs_frame[64];             /**< frame decode buffer */
+static uint8_t gs_frame_out[64];         /**< frame output buffer */
+static uint16_t gs_pool[4 * 32];         /**< pool memory, 4 blocks of 64 bytes */
 
 /**
  * @brief  register test
@@ -62,16 +67,31 @@ uint8_t ch9120_register_test(void)
     uint32_t baud_check;
     uint32_t len;
     uint32_t len_check;
+    uint32_t boot_ms;
+    uint32_t count;
+    uint32_t count_check;
     uint8_t data_bit;
     uint8_t stop_bit;
     uint16_t ms;
     uint16_t ms_check;
+    uint16_t pending;
     uint8_t reg;
     ch9120_bool_t enable;
     ch9120_parity_t parity;
     ch9120_info_t info;
     ch9120_status_t status;
     ch9120_mode_t mode;
+    ch9120_apply_t apply;
+    ch9120_frame_crc_t crc;
+    ch9120_async_status_t async_status;
+    uint16_t token;
+    uint8_t cmd;
+    ch9120_lock_stats_t lock_stats;
+    ch9120_pool_stats_t pool_stats;
+    uint8_t *block[5];
+    uint8_t i;
+    ch9120_view_t view;
+    ch9120_record_t record;
 
     /* link interface function */
     DRIVER_CH9120_LINK_INIT(&gs_handle, ch9120_handle_t);
@@ -79,6 +99,8 @@ uint8_t ch9120_register_test(void)
     DRIVER_CH9120_LINK_UART_DEINIT(&gs_handle, ch9120_interface_uart_deinit);
     DRIVER_CH9120_LINK_UART_READ(&gs_handle, ch9120_interface_uart_read);
     DRIVER_CH9120_LINK_UART_WRITE(&gs_handle, ch9120_interface_uart_write);
+    DRIVER_CH9120_LINK_UART_PEEK(&gs_handle, ch9120_interface_uart_peek);
+    DRIVER_CH9120_LINK_UART_CONSUME(&gs_handle, ch9120_interface_uart_consume);
     DRIVER_CH9120_LINK_UART_FLUSH(&gs_handle, ch9120_interface_uart_flush);
     DRIVER_CH9120_LINK_RESET_GPIO_INIT(&gs_handle, ch9120_interface_reset_gpio_init);
     DRIVER_CH9120_LINK_RESET_GPIO_DEINIT(&gs_handle, ch9120_interface_reset_gpio_deinit);
@@ -88,6 +110,16 @@ uint8_t ch9120_register_test(void)
     DRIVER_CH9120_LINK_CFG_GPIO_WRITE(&gs_handle, ch9120_interface_cfg_gpio_write);
     DRIVER_CH9120_LINK_DELAY_MS(&gs_handle, ch9120_interface_delay_ms);
     DRIVER_CH9120_LINK_DEBUG_PRINT(&gs_handle, ch9120_interface_debug_print);
+    DRIVER_CH9120_LINK_TIMESTAMP_US(&gs_handle, ch9120_interface_timestamp_us);
+    DRIVER_CH9120_LINK_TRACE_BEGIN(&gs_handle, ch9120_interface_trace_begin);
+    DRIVER_CH9120_LINK_TRACE_END(&gs_handle, ch9120_interface_trace_end);
+    DRIVER_CH9120_LINK_STORAGE_READ(&gs_handle, ch9120_interface_storage_read);
+    DRIVER_CH9120_LINK_STORAGE_WRITE(&gs_handle, ch9120_interface_storage_write);
+    DRIVER_CH9120_LINK_CRC32(&gs_handle, ch9120_interface_crc32);
+    DRIVER_CH9120_LINK_MUTEX_INIT(&gs_handle, ch9120_interface_mutex_init);
+    DRIVER_CH9120_LINK_MUTEX_DEINIT(&gs_handle, ch9120_interface_mutex_deinit);
+    DRIVER_CH9120_LINK_MUTEX_LOCK(&gs_handle, ch9120_interface_mutex_lock);
+    DRIVER_CH9120_LINK_MUTEX_UNLOCK(&gs_handle, ch9120_interface_mutex_unlock);
 
     /* get ch9120 information */
     res = ch9120_info(&info);
@@ -139,9 +171,57 @@ uint8_t ch9120_register_test(void)
     /* output */
     ch9120_interface_debug_print("ch9120: version is 0x%02X.\n", version);
 
+    /* ch9120_get_boot_time test */
+    ch9120_interface_debug_print("ch9120: ch9120_get_boot_time test.\n");
+
+    /* get boot time */
+    res = ch9120_get_boot_time(&gs_handle, &boot_ms);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get boot time failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* output */
+    ch9120_interface_debug_print("ch9120: boot time is %dms.\n", boot_ms);
+
+    /* ch9120_get_eeprom_write_count test */
+    ch9120_interface_debug_print("ch9120: ch9120_get_eeprom_write_count test.\n");
+
+    /* get eeprom write count */
+    res = ch9120_get_eeprom_write_count(&gs_handle, &count);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get eeprom write count failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: eeprom write count is %d.\n", count);
+
     /* ch9120_save_to_eeprom test */
     ch9120_interface_debug_print("ch9120: ch9120_save_to_eeprom test.\n");
 
+    /* change the dest port */
+    res = ch9120_get_dest_port(&gs_handle, &num);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_set_dest_port(&gs_handle, (uint16_t)(num + 1));
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
     /* save to eeprom */
     res = ch9120_save_to_eeprom(&gs_handle);
     if (res != 0)
@@ -151,9 +231,196 @@ uint8_t ch9120_register_test(void)
 
         return 1;
     }
+    res = ch9120_get_eeprom_write_count(&gs_handle, &count_check);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get eeprom write count failed.\n");
+        (void)ch9120_deinit(&gs_handle);
 
-    /* output */
-    ch9120_interface_debug_print("ch9120: check save to eeprom %s.\n", res == 0 ? "ok" : "error");
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check save to eeprom %s.\n", (count_check == count + 1) ? "ok" : "error");
+    if (!(count_check == count + 1))
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* nothing changed, save again */
+    count = count_check;
+    res = ch9120_save_to_eeprom(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: save to eeprom failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_eeprom_write_count(&gs_handle, &count_check);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get eeprom write count failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check save skip %s.\n", (count_check == count) ? "ok" : "error");
+    if (!(count_check == count))
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* change the dest port back and save */
+    res = ch9120_set_dest_port(&gs_handle, num);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_save_to_eeprom(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: save to eeprom failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_eeprom_write_count(&gs_handle, &count_check);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get eeprom write count failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check save after set %s.\n", (count_check == count + 1) ? "ok" : "error");
+    if (!(count_check == count + 1))
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* config and reset saves too */
+    count = count_check;
+    res = ch9120_set_dest_port(&gs_handle, (uint16_t)(num + 1));
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_config_and_reset(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: config and reset failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_save_to_eeprom(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: save to eeprom failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_eeprom_write_count(&gs_handle, &count_check);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get eeprom write count failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check config and reset save %s.\n", (count_check == count + 1) ? "ok" : "error");
+    if (!(count_check == count + 1))
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* restore the dest port */
+    res = ch9120_set_dest_port(&gs_handle, num);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_config_and_reset(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: config and reset failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* a stale record holds a dest port the chip does not run */
+    if (ch9120_interface_storage_read((uint8_t *)&record, sizeof(ch9120_record_t)) == 0)
+    {
+        (void)ch9120_deinit(&gs_handle);
+        record.param[6][0] = (uint8_t)(((num + 1) >> 0) & 0xFF);
+        record.param[6][1] = (uint8_t)(((num + 1) >> 8) & 0xFF);
+        record.valid |= (uint16_t)(1U << 6);
+        (void)ch9120_interface_storage_write((uint8_t *)&record, sizeof(ch9120_record_t));
+        res = ch9120_init(&gs_handle);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: init failed.\n");
+
+            return 1;
+        }
+        res = ch9120_set_dest_port(&gs_handle, num + 1);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        res = ch9120_get_apply_required(&gs_handle, &apply);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: get apply required failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        ch9120_interface_debug_print("ch9120: check stale record %s.\n", apply == CH9120_APPLY_PERSIST_AND_RESET ? "ok" : "error");
+        if (apply != CH9120_APPLY_PERSIST_AND_RESET)
+        {
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        res = ch9120_set_dest_port(&gs_handle, num);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: set dest port failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        res = ch9120_apply(&gs_handle, CH9120_APPLY_AUTO);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: apply failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
 
     /* ch9120_exit test */
     ch9120_interface_debug_print("ch9120: ch9120_exit test.\n");
@@ -806,6 +1073,652 @@ uint8_t ch9120_register_test(void)
     /* output */
     ch9120_interface_debug_print("ch9120: check uart timeout convert %s.\n", ms == ms_check ? "ok" : "error");
 
+    /* ch9120_get_apply_required/ch9120_apply test */
+    ch9120_interface_debug_print("ch9120: ch9120_get_apply_required/ch9120_apply test.\n");
+
+    /* get apply required */
+    res = ch9120_get_apply_required(&gs_handle, &apply);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get apply required failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check apply required %s.\n", apply == CH9120_APPLY_PERSIST_AND_RESET ? "ok" : "error");
+
+    /* apply auto */
+    res = ch9120_apply(&gs_handle, CH9120_APPLY_AUTO);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: apply failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_apply_required(&gs_handle, &apply);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get apply required failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check apply auto %s.\n", apply == CH9120_APPLY_NONE ? "ok" : "error");
+    if (apply != CH9120_APPLY_NONE)
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_apply(&gs_handle, (ch9120_apply_t)0x02);
+    ch9120_interface_debug_print("ch9120: check apply mode %s.\n", res == 4 ? "ok" : "error");
+
+    /* ch9120_set_write_coalesce/ch9120_set_write_cork/ch9120_write_flush test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_write_coalesce/ch9120_set_write_cork/ch9120_write_flush test.\n");
+
+    /* set write coalesce */
+    res = ch9120_set_write_coalesce(&gs_handle, gs_coalesce, 64, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write coalesce failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_write(&gs_handle, (uint8_t *)"LibDriver", 9);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: write failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_write_pending(&gs_handle, &pending);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get write pending failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check write coalesce %s.\n", pending == 9 ? "ok" : "error");
+
+    /* write flush */
+    res = ch9120_write_flush(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: write flush failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_write_pending(&gs_handle, &pending);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get write pending failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check write flush %s.\n", pending == 0 ? "ok" : "error");
+
+    /* cork, a full batch is still sent */
+    res = ch9120_set_write_cork(&gs_handle, CH9120_BOOL_TRUE);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write cork failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    for (num = 0; num < 8; num++)
+    {
+        res = ch9120_write(&gs_handle, (uint8_t *)"LibDriver", 9);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: write failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = ch9120_get_write_pending(&gs_handle, &pending);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get write pending failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check write cork %s.\n", pending == 9 ? "ok" : "error");
+
+    /* uncork */
+    res = ch9120_set_write_cork(&gs_handle, CH9120_BOOL_FALSE);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write cork failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_write_pending(&gs_handle, &pending);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get write pending failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check write uncork %s.\n", pending == 0 ? "ok" : "error");
+
+    /* disable write coalesce */
+    res = ch9120_set_write_coalesce(&gs_handle, NULL, 0, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write coalesce failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* ch9120_set_autotune/ch9120_autotune_handler/ch9120_get_autotune test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_autotune/ch9120_autotune_handler/ch9120_get_autotune test.\n");
+
+    /* set autotune */
+    res = ch9120_set_autotune(&gs_handle, gs_sample, 4, 0, 50);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set autotune failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    for (num = 0; num < 4; num++)
+    {
+        res = ch9120_write(&gs_handle, (uint8_t *)"LibDriver", 9);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: write failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = ch9120_autotune_handler(&gs_handle);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: autotune handler failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_autotune(&gs_handle, &ms, &len);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get autotune failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: autotune timeout is %dms and length is %d.\n", ms, len);
+    res = ch9120_get_uart_buffer_length(&gs_handle, &len_check);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get uart buffer length failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check autotune %s.\n", len_check == len ? "ok" : "error");
+
+    /* ch9120_set_frame/ch9120_send_frame/ch9120_recv_frame/ch9120_get_frame_errors test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_frame/ch9120_send_frame/ch9120_recv_frame/ch9120_get_frame_errors test.\n");
+
+    /* set frame */
+    res = ch9120_set_frame(&gs_handle, CH9120_FRAME_COBS, gs_frame, 64);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* send frame */
+    res = ch9120_send_frame(&gs_handle, (uint8_t *)"LibDriver", 9);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: send frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check send frame %s.\n", res == 0 ? "ok" : "error");
+
+    /* recv frame */
+    num = 64;
+    res = ch9120_recv_frame(&gs_handle, gs_frame_out, &num);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: recv frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check recv frame %s.\n", num == 0 ? "ok" : "error");
+
+    /* get frame errors */
+    res = ch9120_get_frame_errors(&gs_handle, &count);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get frame errors failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check frame errors %s.\n", count == 0 ? "ok" : "error");
+
+    /* ch9120_set_frame_crc/ch9120_get_frame_crc test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_frame_crc/ch9120_get_frame_crc test.\n");
+
+    /* set frame crc */
+    res = ch9120_set_frame_crc(&gs_handle, CH9120_FRAME_CRC_32);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame crc failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_frame_crc(&gs_handle, &crc);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get frame crc failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check frame crc %s.\n", crc == CH9120_FRAME_CRC_32 ? "ok" : "error");
+
+    /* send frame with the crc */
+    res = ch9120_send_frame(&gs_handle, (uint8_t *)"LibDriver", 9);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: send frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_set_frame_crc(&gs_handle, CH9120_FRAME_CRC_NONE);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame crc failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* ch9120_set_frame_compress/ch9120_get_frame_compress test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_frame_compress/ch9120_get_frame_compress test.\n");
+
+    /* set frame compress */
+    res = ch9120_set_frame_compress(&gs_handle, CH9120_BOOL_TRUE, gs_frame_out, 64);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame compress failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_frame_compress(&gs_handle, &enable);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get frame compress failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check frame compress %s.\n", enable == CH9120_BOOL_TRUE ? "ok" : "error");
+
+    /* send a compressed frame */
+    res = ch9120_send_frame(&gs_handle, (uint8_t *)"LibDriverLibDriverLibDriver", 27);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: send frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_set_frame_compress(&gs_handle, CH9120_BOOL_FALSE, NULL, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame compress failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* disable the decoder */
+    res = ch9120_set_frame(&gs_handle, CH9120_FRAME_SLIP, NULL, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set frame failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* ch9120_set_pool/ch9120_pool_alloc/ch9120_pool_free/ch9120_get_pool_stats test */
+    ch9120_interface_debug_print("ch9120: ch9120_set_pool/ch9120_pool_alloc/ch9120_pool_free/ch9120_get_pool_stats test.\n");
+
+    /* set pool */
+    res = ch9120_set_pool(&gs_handle, (uint8_t *)gs_pool, 64, 4);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set pool failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* alloc every block */
+    for (i = 0; i < 4; i++)
+    {
+        res = ch9120_pool_alloc(&gs_handle, &block[i]);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: pool alloc failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = ch9120_pool_alloc(&gs_handle, &block[4]);
+    ch9120_interface_debug_print("ch9120: check pool empty %s.\n", res == 1 ? "ok" : "error");
+    res = ch9120_pool_free(&gs_handle, block[0] + 1);
+    ch9120_interface_debug_print("ch9120: check invalid block %s.\n", res == 1 ? "ok" : "error");
+
+    /* the coalescer takes the freed block */
+    res = ch9120_pool_free(&gs_handle, block[3]);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: pool free failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_set_write_coalesce(&gs_handle, NULL, 64, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write coalesce failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_get_pool_stats(&gs_handle, &pool_stats);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get pool stats failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: pool used %d peak %d allocs %d fails %d.\n", 
+                                 pool_stats.used, pool_stats.peak, pool_stats.allocs, pool_stats.fails);
+    ch9120_interface_debug_print("ch9120: check pool stats %s.\n", 
+                                 ((pool_stats.used == 4) && (pool_stats.allocs == 5) && (pool_stats.fails == 1)) ? "ok" : "error");
+
+    /* give everything back */
+    res = ch9120_set_write_coalesce(&gs_handle, NULL, 0, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set write coalesce failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    for (i = 0; i < 3; i++)
+    {
+        res = ch9120_pool_free(&gs_handle, block[i]);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: pool free failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = ch9120_get_pool_stats(&gs_handle, &pool_stats);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get pool stats failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check pool free %s.\n", pool_stats.used == 0 ? "ok" : "error");
+    res = ch9120_pool_free(&gs_handle, (uint8_t *)gs_pool + sizeof(gs_pool));
+    ch9120_interface_debug_print("ch9120: check out of pool block %s.\n", res == 1 ? "ok" : "error");
+    if (res != 1)
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_pool_free(&gs_handle, block[0]);
+    ch9120_interface_debug_print("ch9120: check double free %s.\n", res == 1 ? "ok" : "error");
+    if (res != 1)
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+#if (CH9120_POOL_DEBUG == 1)
+    for (i = 0; i < 2; i++)
+    {
+        res = ch9120_pool_alloc(&gs_handle, &block[i]);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: pool alloc failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+    }
+    res = ch9120_pool_free(&gs_handle, block[0]);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: pool free failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_pool_free(&gs_handle, block[0]);
+    ch9120_interface_debug_print("ch9120: check debug double free %s.\n", res == 1 ? "ok" : "error");
+    if (res != 1)
+    {
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_pool_free(&gs_handle, block[1]);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: pool free failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+#endif
+    res = ch9120_set_pool(&gs_handle, NULL, 0, 0);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: set pool failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+
+    /* ch9120_async_command/ch9120_poll/ch9120_async_get_status test */
+    ch9120_interface_debug_print("ch9120: ch9120_async_command/ch9120_poll/ch9120_async_get_status test.\n");
+
+    /* start get version */
+    cmd = 0x01;
+    res = ch9120_async_command(&gs_handle, &cmd, 1, &version, 1, 20, 1000, &token);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: async command failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_async_command(&gs_handle, &cmd, 1, &version, 1, 20, 1000, NULL);
+    ch9120_interface_debug_print("ch9120: check async busy %s.\n", res == 4 ? "ok" : "error");
+    async_status = CH9120_ASYNC_STATUS_BUSY;
+    for (count = 0; (count < 2000) && (async_status == CH9120_ASYNC_STATUS_BUSY); count++)
+    {
+        res = ch9120_poll(&gs_handle, (uint32_t)(ch9120_interface_timestamp_us() / 1000));
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: poll failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        res = ch9120_async_get_status(&gs_handle, token, &async_status);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: async get status failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        ch9120_interface_delay_ms(1);
+    }
+    ch9120_interface_debug_print("ch9120: check async status %s.\n", async_status == CH9120_ASYNC_STATUS_OK ? "ok" : "error");
+    ch9120_interface_debug_print("ch9120: async version is 0x%02X.\n", version);
+
+    /* ch9120_read_peek/ch9120_read_consume test */
+    ch9120_interface_debug_print("ch9120: ch9120_read_peek/ch9120_read_consume test.\n");
+
+    /* peek the received data */
+    res = ch9120_read_peek(&gs_handle, &view);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: read peek failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: peek len is %d.\n", view.len[0] + view.len[1]);
+    res = ch9120_read_consume(&gs_handle, view.len[0] + view.len[1] + 1);
+    ch9120_interface_debug_print("ch9120: check consume over %s.\n", res == 5 ? "ok" : "error");
+
+    /* consume the peeked data */
+    res = ch9120_read_consume(&gs_handle, view.len[0] + view.len[1]);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: read consume failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_read_consume(&gs_handle, 1);
+    ch9120_interface_debug_print("ch9120: check consume released %s.\n", res == 5 ? "ok" : "error");
+
+    /* ch9120_exec test */
+    ch9120_interface_debug_print("ch9120: ch9120_exec test.\n");
+
+    /* run get version */
+    res = ch9120_exec(&gs_handle, CH9120_COMMAND_GET_VERSION, NULL, &reg);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: exec failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: check exec version %s.\n", reg == version ? "ok" : "error");
+    res = ch9120_exec(&gs_handle, CH9120_COMMAND_NUM, NULL, NULL);
+    ch9120_interface_debug_print("ch9120: check exec id %s.\n", res == 4 ? "ok" : "error");
+    res = ch9120_exec(&gs_handle, CH9120_COMMAND_GET_IP, NULL, NULL);
+    ch9120_interface_debug_print("ch9120: check exec buffer %s.\n", res == 5 ? "ok" : "error");
+    res = ch9120_get_version(&gs_handle, NULL);
+    ch9120_interface_debug_print("ch9120: check exec wrapper buffer %s.\n", res == 5 ? "ok" : "error");
+
+    /* ch9120_async_exec test */
+    ch9120_interface_debug_print("ch9120: ch9120_async_exec test.\n");
+
+    /* start get version */
+    reg = 0;
+    res = ch9120_async_exec(&gs_handle, CH9120_COMMAND_GET_VERSION, NULL, &reg, &token);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: async exec failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    res = ch9120_async_exec(&gs_handle, CH9120_COMMAND_GET_VERSION, NULL, &reg, NULL);
+    ch9120_interface_debug_print("ch9120: check async exec busy %s.\n", res == 7 ? "ok" : "error");
+    async_status = CH9120_ASYNC_STATUS_BUSY;
+    for (count = 0; (count < 2000) && (async_status == CH9120_ASYNC_STATUS_BUSY); count++)
+    {
+        res = ch9120_poll(&gs_handle, (uint32_t)(ch9120_interface_timestamp_us() / 1000));
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: poll failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        res = ch9120_async_get_status(&gs_handle, token, &async_status);
+        if (res != 0)
+        {
+            ch9120_interface_debug_print("ch9120: async get status failed.\n");
+            (void)ch9120_deinit(&gs_handle);
+
+            return 1;
+        }
+        ch9120_interface_delay_ms(1);
+    }
+    ch9120_interface_debug_print("ch9120: check async exec version %s.\n",
+                                 ((async_status == CH9120_ASYNC_STATUS_OK) && (reg == version)) ? "ok" : "error");
+    res = ch9120_async_exec(&gs_handle, CH9120_COMMAND_NUM, NULL, NULL, NULL);
+    ch9120_interface_debug_print("ch9120: check async exec id %s.\n", res == 4 ? "ok" : "error");
+    res = ch9120_async_exec(&gs_handle, CH9120_COMMAND_GET_IP, NULL, NULL, NULL);
+    ch9120_interface_debug_print("ch9120: check async exec buffer %s.\n", res == 5 ? "ok" : "error");
+    res = ch9120_async_exec(&gs_handle, CH9120_COMMAND_RESET, NULL, NULL, NULL);
+    ch9120_interface_debug_print("ch9120: check async exec reboot %s.\n", res == 6 ? "ok" : "error");
+
+    /* ch9120_get_lock_stats test */
+    ch9120_interface_debug_print("ch9120: ch9120_get_lock_stats test.\n");
+
+    /* get cfg lock stats */
+    res = ch9120_get_lock_stats(&gs_handle, CH9120_LOCK_CFG, &lock_stats);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get lock stats failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: cfg lock acquired %d contended %d.\n", lock_stats.acquired, lock_stats.contended);
+    ch9120_interface_debug_print("ch9120: check cfg lock %s.\n", lock_stats.acquired != 0 ? "ok" : "error");
+
+    /* get io lock stats */
+    res = ch9120_get_lock_stats(&gs_handle, CH9120_LOCK_IO, &lock_stats);
+    if (res != 0)
+    {
+        ch9120_interface_debug_print("ch9120: get lock stats failed.\n");
+        (void)ch9120_deinit(&gs_handle);
+
+        return 1;
+    }
+    ch9120_interface_debug_print("ch9120: io lock acquired %d contended %d.\n", lock_stats.acquired, lock_stats.contended);
+    ch9120_interface_debug_print("ch9120: check io lock %s.\n", lock_stats.acquired != 0 ? "ok" : "error");
+
     /* finish register test */
     ch9120_interface_debug_print("ch9120: finish register test.\n");
     (void)ch9120_deinit(&gs_handle);